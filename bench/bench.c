@@ -0,0 +1,627 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * ipc-bench - throughput and latency of the hot paths.
+ *
+ * Every case runs a fixed batch of items on inputs drawn from a fixed
+ * seed, repeated until a sample lasts at least BENCH_SAMPLE_NS, so two
+ * runs on the same machine are comparable. Throughput comes from the
+ * median sample, and of BENCH_REPEATS rounds over all cases the fastest
+ * counts: interference only ever slows a round down. Results go to
+ * stdout (or --out) as JSON. With --compare, throughput is checked
+ * against a stored result and drops beyond --threshold percent are
+ * reported as regressions (exit status 1).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ipv4_t.h"
+#include "fill_ipv4.h"
+#include "prefix_list.h"
+#include "prng.h"
+#include "format.h"
+#include "ipc.h"
+#include "special.h"
+#include "subnet.h"
+#include "subnet_list.h"
+
+#define BENCH_VERSION		2
+#define BENCH_SEED			20260101
+#define BENCH_SAMPLES		50
+#define BENCH_WARMUP		5				/* Batches run before measuring */
+#define BENCH_SAMPLE_NS		1000000			/* Shortest sample */
+#define BENCH_REPEATS		5				/* Rounds over every case */
+#define BENCH_THRESHOLD		10.0			/* Allowed throughput drop, percent */
+#define INPUT_LEN			4096			/* Items per batch */
+#define PART_LEN			64				/* Parts of the part split */
+#define CIDR_MAX			20				/* "255.255.255.255/32" */
+
+/**
+ * @struct bench_case
+ * @brief One measured path.
+ */
+struct bench_case {
+    const char *name;               /**< stage.path */
+    size_t (*run)(void);            /**< One batch, returns items done */
+};
+
+/**
+ * @struct bench_result
+ * @brief Measurements of one case.
+ */
+struct bench_result {
+    const char *name;               /**< Case name */
+    uint64_t items;                 /**< Items over all samples */
+    double ops_per_sec;             /**< Items per second, median sample */
+    double p50_ns;                  /**< Median time per item */
+    double p90_ns;                  /**< 90th percentile time per item */
+    double p99_ns;                  /**< 99th percentile time per item */
+};
+
+/**
+ * @struct bench_opts
+ * @brief Command line options.
+ */
+struct bench_opts {
+    uint64_t seed;                  /**< Input seed */
+    size_t samples;                 /**< Measured samples per case */
+    const char *filter;             /**< Run cases containing this, or NULL */
+    const char *out;                /**< JSON file, NULL for stdout */
+    const char *compare;            /**< Baseline JSON, or NULL */
+    double threshold;               /**< Allowed throughput drop, percent */
+};
+
+/* Inputs shared by the cases, built once by make_inputs() */
+static char cidrs[INPUT_LEN][CIDR_MAX];
+static ipv4_t parsed[INPUT_LEN];
+static ipv4_t analyzed[INPUT_LEN];
+static struct ipc_subnet subnets[INPUT_LEN];
+static int parts[PART_LEN];
+static int equal_arr[INPUT_LEN];
+static struct subnet *list_head;
+
+/* Keeps the compiler from dropping results */
+static volatile uint64_t sink;
+
+/**
+ * @brief Parse the command line.
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ * @param[out] opts Options.
+ * @return 0 on success, -1 on error.
+ */
+static int process_bench_args(int argc, char **argv, struct bench_opts *opts);
+
+/**
+ * @brief Build the inputs of every case.
+ * @param seed Input seed.
+ * @return 0 on success, -1 on error.
+ */
+static int make_inputs(uint64_t seed);
+
+/**
+ * @brief Run one case.
+ *
+ * A sample repeats the batch until it lasts BENCH_SAMPLE_NS, as
+ * estimated from the warmup.
+ *
+ * @param bc Case.
+ * @param samples Measured samples.
+ * @param[out] res Measurements.
+ * @return 0 on success, -1 on error.
+ */
+static int measure(const struct bench_case *bc, size_t samples, struct bench_result *res);
+
+/**
+ * @brief Write the results as JSON.
+ * @param fp Destination.
+ * @param opts Options.
+ * @param res Results.
+ * @param len Number of results.
+ */
+static void write_json(FILE *fp, const struct bench_opts *opts,
+					   const struct bench_result *res, size_t len);
+
+/**
+ * @brief Check the results against a stored run.
+ * @param path Baseline JSON written by this program.
+ * @param threshold Allowed throughput drop, percent.
+ * @param res Results.
+ * @param len Number of results.
+ * @return Number of regressions, or -1 on error.
+ */
+static int compare(const char *path, double threshold,
+				   const struct bench_result *res, size_t len);
+
+/**
+ * @brief Monotonic clock.
+ * @return Nanoseconds.
+ */
+static uint64_t now_ns(void);
+
+/* For qsort of per-item times */
+static int compare_double(const void *p1, const void *p2)
+{
+	double a = *(const double *) p1;
+	double b = *(const double *) p2;
+
+	return (a > b) - (a < b);
+}
+
+static size_t run_fill_addr(void)
+{
+	ipv4_t ip;
+
+	for (size_t i = 0; i < INPUT_LEN; i++) {
+		memset(&ip, 0, sizeof(ipv4_t));
+		fill_addr(&ip, cidrs[i]);
+		sink += ip.addr[3];
+	}
+
+	return INPUT_LEN;
+}
+
+static size_t run_fill_bitmask(void)
+{
+	ipv4_t ip;
+
+	for (size_t i = 0; i < INPUT_LEN; i++) {
+		memset(&ip, 0, sizeof(ipv4_t));
+		fill_bitmask(&ip, cidrs[i]);
+		sink += ip.bitmask;
+	}
+
+	return INPUT_LEN;
+}
+
+static size_t run_fill_chain(void)
+{
+	ipv4_t ip;
+
+	for (size_t i = 0; i < INPUT_LEN; i++) {
+		ip = parsed[i];
+		fill_netmask(&ip);
+		fill_wildcard(&ip);
+		fill_network(&ip);
+		fill_broadcast(&ip);
+		fill_hostmin(&ip);
+		fill_hostmax(&ip);
+		fill_hostcnt(&ip);
+		sink += ip.hostcnt;
+	}
+
+	return INPUT_LEN;
+}
+
+static size_t run_analyze(void)
+{
+	ipv4_t ip;
+
+	for (size_t i = 0; i < INPUT_LEN; i++) {
+		ipc_analyze(&ip, cidrs[i]);
+		sink += ip.hostcnt;
+	}
+
+	return INPUT_LEN;
+}
+
+static size_t run_classify(void)
+{
+	for (size_t i = 0; i < INPUT_LEN; i++) {
+		sink += special_classify(subnets[i].last);
+	}
+
+	return INPUT_LEN;
+}
+
+static size_t run_split_equal(void)
+{
+	struct ipc_split sp;
+	struct ipc_subnet sn;
+	size_t n = 0;
+
+	ipc_split_equal(&sp, "10.0.0.0/8", INPUT_LEN);
+	while (ipc_split_next(&sp, &sn)) {
+		sink += sn.last;
+		n++;
+	}
+
+	return n;
+}
+
+static size_t run_split_part(void)
+{
+	struct ipc_split sp;
+	struct ipc_subnet sn;
+	size_t n = 0;
+
+	ipc_split_part(&sp, "10.0.0.0/8", parts, PART_LEN);
+	while (ipc_split_next(&sp, &sn)) {
+		sink += sn.last;
+		n++;
+	}
+
+	return n;
+}
+
+/* equal_opt_handler, list building and print_list, as run by -s */
+static size_t run_cli_equal(void)
+{
+	subnetting_start("10.0.0.0/8", equal_arr, INPUT_LEN, 0);
+
+	return INPUT_LEN;
+}
+
+/* part_opt_handler, list building and print_list, as run by -s */
+static size_t run_cli_part(void)
+{
+	int arr[PART_LEN];
+
+	/* The handler sorts the parts in place */
+	memcpy(arr, parts, sizeof(arr));
+	subnetting_start("10.0.0.0/8", arr, PART_LEN, 0);
+
+	return PART_LEN;
+}
+
+/* The same split formatted by two threads, as run by -s --threads 2 */
+static size_t run_cli_threads(void)
+{
+	subnetting_start("10.0.0.0/8", equal_arr, INPUT_LEN, 2);
+
+	return INPUT_LEN;
+}
+
+static size_t run_format_analysis(void)
+{
+	char buf[IPC_REPORT_MAX];
+
+	for (size_t i = 0; i < INPUT_LEN; i++) {
+		sink += ipc_format_analysis(&analyzed[i], buf, sizeof(buf));
+	}
+
+	return INPUT_LEN;
+}
+
+static size_t run_format_subnet(void)
+{
+	char buf[IPC_SUBNET_ROW_MAX];
+
+	for (size_t i = 0; i < INPUT_LEN; i++) {
+		sink += ipc_format_subnet(&subnets[i], i, buf, sizeof(buf));
+	}
+
+	return INPUT_LEN;
+}
+
+static size_t run_print_list(void)
+{
+	print_list(list_head);
+
+	return INPUT_LEN;
+}
+
+static const struct bench_case cases[] = {
+	{ "parse.fill_addr", run_fill_addr },
+	{ "parse.fill_bitmask", run_fill_bitmask },
+	{ "derive.fill_chain", run_fill_chain },
+	{ "derive.ipc_analyze", run_analyze },
+	{ "derive.special_classify", run_classify },
+	{ "split.equal", run_split_equal },
+	{ "split.part", run_split_part },
+	{ "split.equal_opt_handler", run_cli_equal },
+	{ "split.part_opt_handler", run_cli_part },
+	{ "split.threads", run_cli_threads },
+	{ "format.analysis", run_format_analysis },
+	{ "format.subnet", run_format_subnet },
+	{ "format.print_list", run_print_list }
+};
+
+#define CASE_COUNT			(sizeof(cases) / sizeof(cases[0]))
+
+int main(int argc, char **argv)
+{
+	struct bench_result res[CASE_COUNT];
+	struct bench_result round;
+	struct bench_opts opts;
+	FILE *json = NULL;
+	size_t len = 0;
+	int regressions = 0;
+	int fd;
+
+	if (process_bench_args(argc, argv, &opts) == -1) {
+		fputs("Usage:\tipc-bench [--samples <n>] [--seed <n>] [--filter <text>]\n"
+			  "\t\t[--out <file>] [--compare <file>] [--threshold <percent>]\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	if (opts.compare && access(opts.compare, R_OK) == -1) {
+		fprintf(stderr, "ipc-bench: %s: %s\n", opts.compare, strerror(errno));
+		return EXIT_FAILURE;
+	}
+
+	/* Formatting cases print to stdout, keep it for the results only */
+	if (opts.out) { json = fopen(opts.out, "w"); }
+	else {
+		fd = dup(STDOUT_FILENO);
+		if (fd != -1) { json = fdopen(fd, "w"); }
+	}
+	if (!json) {
+		fprintf(stderr, "ipc-bench: %s: %s\n", opts.out ? opts.out : "stdout", strerror(errno));
+		return EXIT_FAILURE;
+	}
+	if (!freopen("/dev/null", "w", stdout)) { goto handle_error; }
+
+	if (make_inputs(opts.seed) == -1) { goto handle_error; }
+
+	/* Rounds go over every case, so a slow spell hits one round of each */
+	for (int r = 0; r < BENCH_REPEATS; r++) {
+		len = 0;
+		for (size_t i = 0; i < CASE_COUNT; i++) {
+			if (opts.filter && !strstr(cases[i].name, opts.filter)) { continue; }
+
+			if (measure(&cases[i], opts.samples, &round) == -1) { goto handle_error; }
+			if (!r || round.ops_per_sec > res[len].ops_per_sec) { res[len] = round; }
+			len++;
+		}
+	}
+
+	for (size_t i = 0; i < len; i++) {
+		fprintf(stderr, "%-28s%14.0f ops/s  p50 %9.1f ns  p99 %9.1f ns\n",
+				res[i].name, res[i].ops_per_sec, res[i].p50_ns, res[i].p99_ns);
+	}
+
+	write_json(json, &opts, res, len);
+	if (fclose(json) == EOF) {
+		json = NULL;
+		goto handle_error;
+	}
+
+	if (opts.compare) {
+		regressions = compare(opts.compare, opts.threshold, res, len);
+		if (regressions == -1) {
+			fprintf(stderr, "ipc-bench: %s: not a benchmark result\n", opts.compare);
+			remove_list(list_head);
+			return EXIT_FAILURE;
+		}
+	}
+
+	remove_list(list_head);
+
+	return regressions ? EXIT_FAILURE : EXIT_SUCCESS;
+
+	handle_error:
+		fputs("ipc-bench: failed\n", stderr);
+		if (json) { fclose(json); }
+		remove_list(list_head);
+		return EXIT_FAILURE;
+}
+
+static int process_bench_args(int argc, char **argv, struct bench_opts *opts)
+{
+	unsigned long long val;
+	char *endptr = NULL;
+
+	memset(opts, 0, sizeof(struct bench_opts));
+	opts->seed = BENCH_SEED;
+	opts->samples = BENCH_SAMPLES;
+	opts->threshold = BENCH_THRESHOLD;
+
+	for (int i = 1; i < argc; i++) {
+		if (i + 1 >= argc) { return -1; }
+
+		if (strcmp(argv[i], "--samples") == 0 || strcmp(argv[i], "--seed") == 0) {
+			if (argv[i + 1][0] < '0' || argv[i + 1][0] > '9') { return -1; }
+			errno = 0;
+			val = strtoull(argv[i + 1], &endptr, 10);
+			if (errno == ERANGE || *endptr != '\0') { return -1; }
+			if (strcmp(argv[i], "--samples") == 0) {
+				if (!val || val > 1000000) { return -1; }
+				opts->samples = val;
+			}
+			else { opts->seed = val; }
+		}
+		else if (strcmp(argv[i], "--threshold") == 0) {
+			errno = 0;
+			opts->threshold = strtod(argv[i + 1], &endptr);
+			if (errno == ERANGE || *endptr != '\0' || opts->threshold < 0) { return -1; }
+		}
+		else if (strcmp(argv[i], "--filter") == 0) { opts->filter = argv[i + 1]; }
+		else if (strcmp(argv[i], "--out") == 0) { opts->out = argv[i + 1]; }
+		else if (strcmp(argv[i], "--compare") == 0) { opts->compare = argv[i + 1]; }
+		else { return -1; }
+
+		i++;
+	}
+
+	return 0;
+}
+
+static int make_inputs(uint64_t seed)
+{
+	struct prng rng;
+	struct ipc_split sp;
+	struct ipc_subnet sn;
+	struct subnet *node = NULL;
+	struct subnet *tail = NULL;
+	uint32_t addr;
+	char *p = NULL;
+	int bitmask;
+
+	prng_seed(&rng, seed);
+
+	for (size_t i = 0; i < INPUT_LEN; i++) {
+		addr = (uint32_t) prng_next(&rng);
+		/* Lengths 8..32, more of the longer ones, as in real tables */
+		bitmask = 32 - (int) (prng_bounded(&rng, 25) * prng_bounded(&rng, 25) / 24);
+
+		p = format_addr_plain(cidrs[i], addr);
+		sprintf(p, "/%d", bitmask);
+
+		memset(&parsed[i], 0, sizeof(ipv4_t));
+		fill_addr(&parsed[i], cidrs[i]);
+		fill_bitmask(&parsed[i], cidrs[i]);
+		ipc_analyze(&analyzed[i], cidrs[i]);
+
+		subnets[i].first = addr & prefix_netmask(bitmask);
+		subnets[i].last = addr;
+		subnets[i].bitmask = bitmask;
+	}
+
+	/* Part sizes up to 2^16 addresses, they all fit in a /8 */
+	for (size_t i = 0; i < PART_LEN; i++) {
+		parts[i] = 1 + (int) prng_bounded(&rng, (uint64_t) 1 << 16);
+	}
+
+	memset(equal_arr, 0, sizeof(equal_arr));
+
+	/* List printed by format.print_list */
+	if (ipc_split_equal(&sp, "10.0.0.0/8", INPUT_LEN) == -1) { return -1; }
+	while (ipc_split_next(&sp, &sn)) {
+		node = calloc(1, sizeof(struct subnet));
+		if (!node) { return -1; }
+		init_node(node, &sn);
+
+		if (!list_head) { list_head = node; }
+		else { add_to_list(tail, node); }
+		tail = node;
+	}
+
+	return 0;
+}
+
+static int measure(const struct bench_case *bc, size_t samples, struct bench_result *res)
+{
+	double *per_item = NULL;
+	uint64_t start, elapsed;
+	size_t items, batches;
+
+	per_item = malloc(samples * sizeof(double));
+	if (!per_item) { return -1; }
+
+	start = now_ns();
+	for (size_t i = 0; i < BENCH_WARMUP; i++) { bc->run(); }
+	elapsed = (now_ns() - start) / BENCH_WARMUP;
+	batches = elapsed < BENCH_SAMPLE_NS ? BENCH_SAMPLE_NS / (elapsed + 1) + 1 : 1;
+
+	memset(res, 0, sizeof(struct bench_result));
+	res->name = bc->name;
+
+	for (size_t i = 0; i < samples; i++) {
+		items = 0;
+		start = now_ns();
+		for (size_t j = 0; j < batches; j++) { items += bc->run(); }
+		elapsed = now_ns() - start;
+
+		if (!items) { items = 1; }
+		per_item[i] = (double) elapsed / items;
+		res->items += items;
+	}
+
+	qsort(per_item, samples, sizeof(double), compare_double);
+
+	res->p50_ns = per_item[(samples - 1) / 2];
+	res->ops_per_sec = res->p50_ns > 0 ? 1e9 / res->p50_ns : 0;
+	res->p90_ns = per_item[(size_t) ((samples - 1) * 0.90)];
+	res->p99_ns = per_item[(size_t) ((samples - 1) * 0.99)];
+
+	free(per_item);
+
+	return 0;
+}
+
+static void write_json(FILE *fp, const struct bench_opts *opts,
+					   const struct bench_result *res, size_t len)
+{
+	fprintf(fp, "{\n  \"version\": %d,\n  \"seed\": %llu,\n  \"samples\": %zu,\n"
+			"  \"repeats\": %d,\n  \"items_per_batch\": %d,\n  \"benchmarks\": [\n",
+			BENCH_VERSION, (unsigned long long) opts->seed, opts->samples, BENCH_REPEATS,
+			INPUT_LEN);
+
+	/* One case per line, compare() reads them back line by line */
+	for (size_t i = 0; i < len; i++) {
+		fprintf(fp, "    {\"name\": \"%s\", \"items\": %llu, \"ops_per_sec\": %.1f, "
+				"\"p50_ns\": %.2f, \"p90_ns\": %.2f, \"p99_ns\": %.2f}%s\n",
+				res[i].name, (unsigned long long) res[i].items, res[i].ops_per_sec,
+				res[i].p50_ns, res[i].p90_ns, res[i].p99_ns, i + 1 < len ? "," : "");
+	}
+
+	fputs("  ]\n}\n", fp);
+
+	return;
+}
+
+static int compare(const char *path, double threshold,
+				   const struct bench_result *res, size_t len)
+{
+	char line[512];
+	char name[128];
+	double base, change;
+	int regressions = 0;
+	int found = 0;
+	char *p = NULL;
+	FILE *fp = NULL;
+
+	fp = fopen(path, "r");
+	if (!fp) { return -1; }
+
+	fprintf(stderr, "\n%-28s%14s%14s%10s\n", "CASE", "BASELINE", "CURRENT", "CHANGE");
+
+	while (fgets(line, sizeof(line), fp)) {
+		p = strstr(line, "\"name\": \"");
+		if (!p || sscanf(p, "\"name\": \"%127[^\"]\"", name) != 1) { continue; }
+
+		p = strstr(line, "\"ops_per_sec\": ");
+		if (!p || sscanf(p, "\"ops_per_sec\": %lf", &base) != 1 || base <= 0) { continue; }
+		found++;
+
+		for (size_t i = 0; i < len; i++) {
+			if (strcmp(res[i].name, name) != 0) { continue; }
+
+			change = (res[i].ops_per_sec - base) / base * 100;
+			fprintf(stderr, "%-28s%14.0f%14.0f%+9.1f%%%s\n", name, base,
+					res[i].ops_per_sec, change, change < -threshold ? "  REGRESSION" : "");
+			if (change < -threshold) { regressions++; }
+		}
+	}
+
+	fclose(fp);
+
+	if (!found) { return -1; }
+
+	fprintf(stderr, "%d regression(s) beyond %.1f%%\n", regressions, threshold);
+
+	return regressions;
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
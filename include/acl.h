@@ -0,0 +1,164 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ACL_H_SENTRY
+#define ACL_H_SENTRY
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define ACL_NO_MATCH		UINT32_MAX
+
+/**
+ * @enum acl_action
+ * @brief What an entry does with a matching address.
+ */
+enum acl_action { acl_deny, acl_permit };
+
+/**
+ * @enum acl_issue_kind
+ * @brief Why an entry has no effect.
+ */
+enum acl_issue_kind {
+    acl_shadowed,                   /**< Earlier entry with the other action
+                                         matches all its addresses */
+    acl_redundant                   /**< Removing it changes no decision */
+};
+
+/**
+ * @struct acl_entry
+ * @brief Address with a wildcard mask, as in router ACLs.
+ *
+ * An address matches if it equals addr in every bit not set in the
+ * wildcard. The wildcard need not be contiguous: 0.0.255.0 matches
+ * any third octet.
+ */
+struct acl_entry {
+    uint32_t addr;                  /**< Address, wildcard bits cleared */
+    uint32_t wildcard;              /**< Bits that are ignored */
+    uint8_t action;                 /**< acl_action */
+};
+
+/**
+ * @struct acl_class
+ * @brief Entries sharing one wildcard, hashed by their address.
+ */
+struct acl_class {
+    uint32_t care;                  /**< Inverted wildcard */
+    uint32_t first;                 /**< Lowest entry of the class */
+    uint32_t mask;                  /**< Slots - 1 */
+    uint32_t (*slots)[2];           /**< Address, lowest entry with it;
+                                         ACL_NO_MATCH entry if empty */
+};
+
+/**
+ * @struct acl_issue
+ * @brief Entry found to have no effect by acl_check().
+ */
+struct acl_issue {
+    uint32_t entry;                 /**< Entry without effect */
+    uint32_t by;                    /**< Entry that makes it so */
+    uint8_t kind;                   /**< acl_issue_kind */
+};
+
+/**
+ * @struct acl
+ * @brief Ordered access list, first match wins.
+ *
+ * Entries are grouped into one hash table per distinct wildcard, the
+ * classes ordered by their lowest entry. A lookup probes the classes in
+ * that order and stops at the first class that can not beat the match
+ * found so far, so a handful of wildcards costs a handful of probes.
+ *
+ * @warning Initialize the structure with zeros before using.
+ */
+struct acl {
+    struct acl_entry *entries;      /**< Entries in evaluation order */
+    size_t len;                     /**< Number of entries */
+    size_t cap;                     /**< Allocated entries */
+    struct acl_class *classes;      /**< Built by acl_compile() */
+    size_t class_count;             /**< Number of classes */
+};
+
+/**
+ * @brief Append an entry.
+ * @param acl Access list.
+ * @param addr Address.
+ * @param wildcard Wildcard mask.
+ * @param action acl_permit or acl_deny.
+ * @return 0 on success, -1 on error.
+ */
+int acl_add(struct acl *acl, uint32_t addr, uint32_t wildcard, enum acl_action action);
+
+/**
+ * @brief Append the entries of a stream.
+ *
+ * Entries are "permit" or "deny" followed by one of:
+ * 	any
+ * 	host <address>
+ * 	<address>/<bitmask>
+ * 	<address> [<wildcard>]	 a bare address is a host
+ *
+ * @param acl Access list.
+ * @param fp Source stream.
+ * @return 0 on success, -1 on error, acl->len entries were read.
+ *
+ * @see token_reader_next
+ */
+int acl_read(struct acl *acl, FILE *fp);
+
+/**
+ * @brief Build the lookup classes. Call again after adding entries.
+ * @param acl Access list.
+ * @return 0 on success, -1 on error.
+ */
+int acl_compile(struct acl *acl);
+
+/**
+ * @brief First entry matching an address.
+ * @param acl Compiled access list.
+ * @param addr Address in host byte order.
+ * @return Entry index, or ACL_NO_MATCH.
+ */
+uint32_t acl_match(const struct acl *acl, uint32_t addr);
+
+/**
+ * @brief Find entries that have no effect.
+ *
+ * An entry is shadowed or redundant when an earlier entry matches all
+ * its addresses, and redundant when a later entry with the same action
+ * does so with no entry of the other action overlapping it in between.
+ * Coverage by a union of several entries is not detected.
+ *
+ * @param acl Compiled access list.
+ * @param[out] issues Found entries in ascending order. The caller must free.
+ * @param[out] len Number of issues.
+ * @return 0 on success, -1 on error.
+ */
+int acl_check(const struct acl *acl, struct acl_issue **issues, size_t *len);
+
+/**
+ * @brief Free the entries and classes.
+ * @param acl Access list.
+ */
+void acl_free(struct acl *acl);
+
+#endif /* ACL_H_SENTRY */
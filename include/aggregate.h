@@ -0,0 +1,49 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef AGGREGATE_H_SENTRY
+#define AGGREGATE_H_SENTRY
+
+/**
+ * @brief Keep the minimal cover of a prefix list up to date.
+ *
+ * Loads the prefixes of the files in argv, prints their minimal cover
+ * as "+ <prefix>" lines, then reads commands from stdin, one per line:
+ * 	add <prefix>	 (or + <prefix>)
+ * 	del <prefix>	 (or - <prefix>)
+ * 	dump		 the whole cover as "= <prefix>" lines
+ *
+ * After each command only the changes of the cover are printed, "-"
+ * lines before "+" lines, and stdout is flushed, so the mode can sit
+ * in a pipeline for as long as stdin stays open. Bad commands are
+ * reported on stderr and skipped.
+ *
+ * Options:
+ * 	--mark		 end the output of every command with a "." line
+ *
+ * @param argc Number of arguments after the mode option.
+ * @param argv Arguments after the mode option.
+ *
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on invalid arguments,
+ *         EXIT_INPUT on an error of the input (reported, see status.h).
+ */
+int aggregate_start(int argc, char **argv);
+
+#endif /* AGGREGATE_H_SENTRY */
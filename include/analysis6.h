@@ -0,0 +1,38 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ANALYSIS6_H_SENTRY
+#define ANALYSIS6_H_SENTRY
+
+/**
+ * @brief Analyze IPv6 address.
+ *
+ * Same report as -a for IPv4, each address in the expanded and the
+ * compressed (RFC 5952) form.
+ *
+ * @param argc Number of arguments after the mode option.
+ * @param argv Arguments after the mode option, argv[0] is the address
+ * 			   in CIDR notation.
+ *
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on error.
+ */
+int analysis6_start(int argc, char **argv);
+
+#endif /* ANALYSIS6_H_SENTRY */
@@ -0,0 +1,46 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef BATCH_H_SENTRY
+#define BATCH_H_SENTRY
+
+/**
+ * @brief Analyze every address of a stream.
+ *
+ * Reads addresses in CIDR notation from the files in argv, or from
+ * stdin if there are none, and prints the analysis report of each,
+ * separated by blank lines. Finished reports are kept in a bounded
+ * cache, so repeated entries are only copied. Cache hits and misses
+ * are printed to stderr at the end.
+ *
+ * Options:
+ * 	--cache <n>		 cache entries, 0 disables the cache
+ * 	--key <raw|parsed>	 cache by the input text (default)
+ * 				 or by the parsed address and bitmask
+ *
+ * @param argc Number of arguments after the mode option.
+ * @param argv Arguments after the mode option.
+ *
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on invalid arguments,
+ *         EXIT_INPUT on an error of the input (reported, see status.h).
+ */
+int batch_start(int argc, char **argv);
+
+#endif /* BATCH_H_SENTRY */
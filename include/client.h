@@ -0,0 +1,43 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CLIENT_H_SENTRY
+#define CLIENT_H_SENTRY
+
+/**
+ * @brief Send requests to a running server.
+ *
+ * Without a request on the command line, every line of stdin is
+ * sent and the responses are printed as they arrive.
+ *
+ * Options:
+ * 	--bench <n>	 send n copies of the request, print throughput
+ * 			 and latency percentiles instead of responses
+ * 	--depth <n>	 requests in flight during the benchmark
+ *
+ * @param argc Number of arguments after the mode option.
+ * @param argv Arguments after the mode option, the socket path first.
+ *
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on invalid arguments,
+ *         EXIT_INPUT on an error of the input (reported, see status.h).
+ */
+int client_start(int argc, char **argv);
+
+#endif /* CLIENT_H_SENTRY */
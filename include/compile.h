@@ -0,0 +1,47 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef COMPILE_H_SENTRY
+#define COMPILE_H_SENTRY
+
+/**
+ * @brief Compile prefix files into the binary format, or inspect one.
+ *
+ * Forms:
+ * 	-o <file> [--no-table] [file...]	 compile the prefixes of the files
+ * 						 (stdin if none) into <file>
+ * 	--verify <file>				 check the checksum and every key
+ * 	--dump <file>				 print the prefixes as text
+ *
+ * The output is written next to <file> and renamed over it, so readers
+ * that mapped the old version keep a consistent view. --no-table leaves
+ * out the lookup table, about 4 bytes per prefix smaller.
+ *
+ * Compiled files are accepted wherever a prefix list file is read.
+ *
+ * @param argc Number of arguments after the mode option.
+ * @param argv Arguments after the mode option.
+ *
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on invalid arguments,
+ *         EXIT_INPUT on an error of the input (reported, see status.h).
+ */
+int compile_start(int argc, char **argv);
+
+#endif /* COMPILE_H_SENTRY */
@@ -0,0 +1,43 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef COVERAGE_H_SENTRY
+#define COVERAGE_H_SENTRY
+
+/**
+ * @brief Count unique addresses covered by a list of prefixes and ranges.
+ *
+ * Reads entries ("10.0.0.0/8", "10.0.0.1", "10.0.0.1-10.0.0.9") from
+ * the files in argv, or from stdin if there are none, merges the
+ * overlapping ones and prints the size of the union.
+ *
+ * Options:
+ * 	--by-length		 union size per prefix length
+ * 	--by-parent <len>	 union size per enclosing /len prefix
+ *
+ * @param argc Number of arguments after the mode option.
+ * @param argv Arguments after the mode option.
+ *
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on invalid arguments,
+ *         EXIT_INPUT on an error of the input (reported, see status.h).
+ */
+int coverage_start(int argc, char **argv);
+
+#endif /* COVERAGE_H_SENTRY */
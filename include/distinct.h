@@ -0,0 +1,56 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef DISTINCT_H_SENTRY
+#define DISTINCT_H_SENTRY
+
+/**
+ * @brief Estimate distinct sources per prefix of an address stream.
+ *
+ * Each line is "<source> <destination>", or one address that is both.
+ * The destination picks a bucket: its prefix of a fixed length, or the
+ * longest matching prefix of a table. Each bucket keeps a HyperLogLog
+ * sketch of its sources, 2^precision bytes however many there are.
+ * Lines are parsed on several threads, each with its own sketches,
+ * merged at the end.
+ *
+ * Sketches can be saved and loaded again; loading merges them, so
+ * runs over parts of a stream add up to the run over all of it.
+ *
+ * Options:
+ * 	--length <n>		 bucket by /n of the destination (24)
+ * 	--table <file>		 bucket by the longest match in the file
+ * 	--precision <p>		 2^p registers per bucket, 4-16 (12)
+ * 	--threads <n>		 parsing threads (number of CPUs)
+ * 	--load <file>		 merge saved sketches, may repeat
+ * 	--save <file>		 save the sketches
+ * 	--top <n>		 only the n buckets with most sources
+ * Input files follow the options, "-" is stdin; with neither files
+ * nor --load, stdin is read.
+ *
+ * @param argc Number of arguments after the mode option.
+ * @param argv Arguments after the mode option.
+ *
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on invalid arguments,
+ *         EXIT_INPUT on an error of the input (reported, see status.h).
+ */
+int distinct_start(int argc, char **argv);
+
+#endif /* DISTINCT_H_SENTRY */
@@ -0,0 +1,45 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ENUMERATE_H_SENTRY
+#define ENUMERATE_H_SENTRY
+
+/**
+ * @brief List every usable host of a network.
+ *
+ * The first argument is the network in CIDR notation. Hosts run from
+ * hostmin to hostmax, so /31 and /32 are listed as in the analysis.
+ *
+ * Options:
+ * 	--stride <n>		 every n-th host
+ * 	--exclude <entry>	 skip a prefix or range, may be repeated
+ * 	--exclude-file <file>	 skip the prefixes and ranges of a file
+ * 	--shuffle		 random order, every host exactly once
+ * 	--seed <n>		 seed for a reproducible order
+ *
+ * @param argc Number of arguments after the mode option.
+ * @param argv Arguments after the mode option.
+ *
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on invalid arguments,
+ *         EXIT_INPUT on an error of the input (reported, see status.h).
+ */
+int enumerate_start(int argc, char **argv);
+
+#endif /* ENUMERATE_H_SENTRY */
@@ -0,0 +1,44 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXTRACT_H_SENTRY
+#define EXTRACT_H_SENTRY
+
+/**
+ * @brief Print the IPv4 addresses found in log text.
+ *
+ * Files in argv are mapped and scanned whole, stdin is scanned in
+ * chunks. Every address is printed on its own line, in the order
+ * found, so the output feeds the modes that read address lists.
+ *
+ * Options:
+ * 	--offset	 append " # <byte offset>" of the address
+ * 	--line		 append " # <line number>" of the address
+ * With several files the position is written as "<file>:<n>".
+ *
+ * @param argc Number of arguments after the mode option.
+ * @param argv Arguments after the mode option.
+ *
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on invalid arguments,
+ *         EXIT_INPUT on an error of the input (reported, see status.h).
+ */
+int extract_start(int argc, char **argv);
+
+#endif /* EXTRACT_H_SENTRY */
@@ -168,4 +168,23 @@ ipv4_t *fill_hostmax(ipv4_t *ip);
  */
 ipv4_t *fill_hostcnt(ipv4_t *ip);
 
+/**
+ * @brief Pack four octets into a host-order 32-bit number.
+ * 
+ * @param octets Array of OCTET_COUNT octets, most significant first.
+ * 
+ * @return Address as a number (e.g. 192.168.1.1 -> 0xc0a80101).
+ */
+uint32_t addr_to_u32(const uint8_t *octets);
+
+/**
+ * @brief Unpack a host-order 32-bit number into four octets.
+ * 
+ * @param num Address as a number.
+ * @param octets Array of OCTET_COUNT octets to fill.
+ * 
+ * @see addr_to_u32
+ */
+void u32_to_addr(uint32_t num, uint8_t *octets);
+
 #endif /* FILL_IPV4_H_SENTRY */
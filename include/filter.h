@@ -0,0 +1,49 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef FILTER_H_SENTRY
+#define FILTER_H_SENTRY
+
+/**
+ * @brief Evaluate an access list against an address stream.
+ *
+ * The first argument is the ACL file (see acl_read), the rest are
+ * options and address files (stdin if none). Every address is printed
+ * with the action and number of the first matching entry and its
+ * special-purpose class; an address no entry matches is denied, shown
+ * as entry "-".
+ *
+ * Entries that can never decide anything are reported on stderr when
+ * the list is loaded.
+ *
+ * Options:
+ * 	--check		 only report entries without effect, on stdout
+ * 	--count		 hits per entry instead of one line per address
+ * 	--binary	 4-byte addresses in network byte order (see -r --binary)
+ *
+ * @param argc Number of arguments after the mode option.
+ * @param argv Arguments after the mode option.
+ *
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on invalid arguments,
+ *         EXIT_INPUT on an error of the input (reported, see status.h).
+ */
+int filter_start(int argc, char **argv);
+
+#endif /* FILTER_H_SENTRY */
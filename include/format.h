@@ -0,0 +1,103 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef FORMAT_H_SENTRY
+#define FORMAT_H_SENTRY
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define ADDR_STR_LEN		15		/* "192.168.001.001" */
+#define OUTBUF_SIZE			(1 << 16)
+
+/**
+ * @struct outbuf
+ * @brief Output buffer written to a stream in large blocks.
+ *
+ * @warning Initialize with outbuf_init() before using.
+ */
+struct outbuf {
+    FILE *fp;                       /**< Destination stream */
+    size_t len;                     /**< Bytes of data in buf */
+    int error;                      /**< Write to fp failed */
+    char data[OUTBUF_SIZE];         /**< Buffered data */
+};
+
+/**
+ * @brief Format an address with zero-padded octets.
+ *
+ * Same layout as the analysis and subnetting tables.
+ *
+ * @param dst Destination, at least ADDR_STR_LEN bytes. Not terminated.
+ * @param addr Address in host byte order.
+ *
+ * @return Pointer past the last written character.
+ */
+char *format_addr(char *dst, uint32_t addr);
+
+/**
+ * @brief Format an address in plain dotted-decimal (e.g. "10.0.0.1").
+ *
+ * Used for address streams fed to other programs, which may read
+ * zero-padded octets as octal.
+ *
+ * @param dst Destination, at least ADDR_STR_LEN bytes. Not terminated.
+ * @param addr Address in host byte order.
+ *
+ * @return Pointer past the last written character.
+ */
+char *format_addr_plain(char *dst, uint32_t addr);
+
+/**
+ * @brief Prepare the buffer for the stream.
+ * @param ob Buffer.
+ * @param fp Destination stream.
+ */
+void outbuf_init(struct outbuf *ob, FILE *fp);
+
+/**
+ * @brief Get space for at least n bytes, flushing the buffer if needed.
+ *
+ * Write the data at the returned pointer and add its size to ob->len.
+ *
+ * @param ob Buffer.
+ * @param n Bytes needed, at most OUTBUF_SIZE.
+ *
+ * @return Pointer to free space.
+ */
+char *outbuf_reserve(struct outbuf *ob, size_t n);
+
+/**
+ * @brief Append bytes to the buffer.
+ * @param ob Buffer.
+ * @param data Bytes to append.
+ * @param n Number of bytes.
+ */
+void outbuf_write(struct outbuf *ob, const void *data, size_t n);
+
+/**
+ * @brief Write buffered data to the stream.
+ * @param ob Buffer.
+ * @return 0 on success, -1 if any write failed.
+ */
+int outbuf_flush(struct outbuf *ob);
+
+#endif /* FORMAT_H_SENTRY */
@@ -0,0 +1,52 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef GEN_H_SENTRY
+#define GEN_H_SENTRY
+
+/**
+ * @brief Write a synthetic dataset.
+ *
+ * The first argument is the kind, the second the number of lines:
+ * 	prefixes	 prefix table with a BGP-like length mix (most
+ * 			 entries /24, then /22 and /23), entries clustered
+ * 			 in allocation blocks, some nested in or covering
+ * 			 earlier entries
+ * 	addresses	 address stream, skewed towards popular blocks
+ * 			 and towards the low hosts of each block
+ *
+ * Options:
+ * 	--seed <n>	 seed, the same seed gives the same output (default 1)
+ * 	--clusters <n>	 allocation blocks (default 4096)
+ * 	--skew <s>	 Zipf exponent of block popularity (default 1.0)
+ * 	--nested <pct>	 prefixes derived from a recent entry (default 10)
+ * 	--table <file>	 addresses: use the prefixes of a file as blocks
+ * 	--unique	 prefixes: write every prefix once, at about 7 bytes
+ * 			 of memory per prefix and several times the time
+ *
+ * @param argc Number of arguments after the mode option.
+ * @param argv Arguments after the mode option.
+ *
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on invalid arguments,
+ *         EXIT_INPUT on an error of the input (reported, see status.h).
+ */
+int gen_start(int argc, char **argv);
+
+#endif /* GEN_H_SENTRY */
@@ -0,0 +1,100 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HLL_H_SENTRY
+#define HLL_H_SENTRY
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define HLL_PRECISION_MIN	4
+#define HLL_PRECISION_MAX	16
+#define HLL_PRECISION		12		/* 4 KiB registers, 1.6% standard error */
+
+/**
+ * @brief Hash of an address spread over 64 bits.
+ * @param value Address.
+ * @return Hash.
+ */
+static inline uint64_t hll_hash(uint32_t value)
+{
+	uint64_t z = value + 0x9e3779b97f4a7c15ULL;
+
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+
+	return z ^ (z >> 31);
+}
+
+/**
+ * @brief Add a value to a HyperLogLog sketch.
+ *
+ * The first p bits of the hash pick a register, which keeps the
+ * highest position of the first 1 bit seen in the rest.
+ *
+ * @param regs 2^p registers.
+ * @param p Precision.
+ * @param value Value, e.g. an address.
+ */
+static inline void hll_add(uint8_t *regs, int p, uint32_t value)
+{
+	uint64_t h = hll_hash(value);
+	/* Guard bit: the rank stops at 64 - p + 1 */
+	uint8_t rank = __builtin_clzll(h << p | (uint64_t) 1 << (p - 1)) + 1;
+	uint8_t *r = &regs[h >> (64 - p)];
+
+	if (rank > *r) { *r = rank; }
+
+	return;
+}
+
+/**
+ * @brief Merge a sketch into another.
+ *
+ * The result is the sketch of the union of both inputs, so sketches
+ * built apart (threads, earlier runs) add up exactly.
+ *
+ * @param dst 2^p registers, updated.
+ * @param src 2^p registers.
+ * @param p Precision of both.
+ */
+void hll_merge(uint8_t *dst, const uint8_t *src, int p);
+
+/**
+ * @brief Estimate the number of distinct values added.
+ *
+ * Small cardinalities, while registers are still empty, use linear
+ * counting.
+ *
+ * @param regs 2^p registers.
+ * @param p Precision.
+ *
+ * @return Estimate.
+ */
+double hll_estimate(const uint8_t *regs, int p);
+
+/**
+ * @brief Relative standard error of an estimate.
+ * @param p Precision.
+ * @return 1.04 / sqrt(2^p).
+ */
+double hll_error(int p);
+
+#endif /* HLL_H_SENTRY */
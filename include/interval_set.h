@@ -0,0 +1,98 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef INTERVAL_SET_H_SENTRY
+#define INTERVAL_SET_H_SENTRY
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define INTERVAL_SET_INVALID	-2		/* interval_set_read: entry is no interval */
+#define INTERVAL_SET_DAMAGED	-3		/* interval_set_read: compiled set fails its checks */
+#define INTERVAL_SET_ENTRY_MAX	64		/* Room for an invalid entry */
+
+/**
+ * @struct interval_set
+ * @brief Growing array of address intervals.
+ *
+ * Each interval is packed as (first << 32 | last), so sorting the keys
+ * orders the intervals by their first address.
+ *
+ * @warning Initialize the structure with zeros before using.
+ */
+struct interval_set {
+    uint64_t *keys;                 /**< Packed intervals */
+    size_t len;                     /**< Number of intervals */
+    size_t cap;                     /**< Allocated intervals */
+};
+
+/**
+ * @brief Append an interval.
+ * @param set Set to append to.
+ * @param first First address.
+ * @param last Last address, not less than first.
+ * @return 0 on success, -1 on error.
+ */
+int interval_set_add(struct interval_set *set, uint32_t first, uint32_t last);
+
+/**
+ * @brief Append all entries of a stream.
+ *
+ * Entries are prefixes, bare addresses and "first-last" ranges.
+ *
+ * @param set Set to append to.
+ * @param fp Source stream.
+ * @param[out] bad Invalid entry, cut to size. May be NULL.
+ * @param size Size of bad.
+ * @return 0 on success, INTERVAL_SET_INVALID on an invalid entry,
+ *         INTERVAL_SET_DAMAGED on a damaged compiled set, -1 on other
+ *         errors.
+ *
+ * @see parse_interval
+ */
+int interval_set_read(struct interval_set *set, FILE *fp, char *bad, size_t size);
+
+/**
+ * @brief Sort intervals by first address.
+ * @param set Set to sort.
+ * @return 0 on success, -1 on error.
+ */
+int interval_set_sort(struct interval_set *set);
+
+/**
+ * @brief Merge overlapping and adjacent intervals of a sorted set.
+ *
+ * On return the set holds the disjoint blocks of the union in order.
+ *
+ * @param set Sorted set.
+ * @return Number of unique addresses in the union.
+ *
+ * @see interval_set_sort
+ */
+uint64_t interval_set_merge(struct interval_set *set);
+
+/**
+ * @brief Free the intervals.
+ * @param set Set to clear.
+ */
+void interval_set_free(struct interval_set *set);
+
+#endif /* INTERVAL_SET_H_SENTRY */
@@ -0,0 +1,178 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * libipc - embeddable IP calculator.
+ *
+ * Every function is reentrant: results go to caller-provided structures
+ * and buffers, nothing is allocated and nothing is printed.
+ */
+
+#ifndef IPC_H_SENTRY
+#define IPC_H_SENTRY
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ipv4_t.h"
+#include "fill_ipv4.h"
+#include "special.h"
+
+#define IPC_REPORT_MAX		1024	/* Longest analysis report */
+#define IPC_SUBNET_ROW_MAX	64		/* Longest subnet table row */
+
+/**
+ * @struct ipc_subnet
+ * @brief One subnet of a split.
+ */
+struct ipc_subnet {
+    uint32_t first;                 /**< Network address, host byte order */
+    uint32_t last;                  /**< Broadcast address, host byte order */
+    uint8_t bitmask;                /**< Mask length (e.g. 24) */
+};
+
+/**
+ * @struct ipc_split
+ * @brief Iterator over the subnets of a split.
+ *
+ * Set up with ipc_split_equal() or ipc_split_part().
+ */
+struct ipc_split {
+    uint32_t base;                  /**< Network being split */
+    uint8_t bitmask;                /**< Mask length of the network */
+    uint8_t sub_bitmask;            /**< Equal split: mask of every subnet */
+    const int *parts;               /**< Part split: sizes in descending order,
+                                         NULL for an equal split */
+    uint64_t count;                 /**< Number of subnets */
+    uint64_t pos;                   /**< Index of the next subnet */
+    uint64_t offset;                /**< Distance of the next subnet from base */
+    uint64_t runs[BITS_IN_IP + 1];  /**< Part split: number of parts of 2^k
+                                         addresses or more, for seeking */
+};
+
+/**
+ * @brief Analyze an IPv4 address.
+ * 
+ * @param ip Structure to fill.
+ * @param cidr IP address in CIDR notation (e.g. "192.168.1.1/24").
+ * 
+ * @return 0 on success, -1 on error.
+ */
+int ipc_analyze(ipv4_t *ip, const char *cidr);
+
+/**
+ * @brief Format the analysis report.
+ * 
+ * Displays IP details in DEC/BIN/HEX formats.
+ * Special handling for:
+ * 	- /31 (point-to-point links with no network/broadcast addresses)
+ * 	- /32 (single host addresses with no network/broadcast).
+ * The last row is the special-purpose class of the network, "mixed"
+ * when its addresses fall in several classes.
+ * 
+ * @param ip Structure filled by ipc_analyze().
+ * @param buf Destination buffer, IPC_REPORT_MAX bytes are enough.
+ * @param size Size of buf.
+ * 
+ * @return Length of the report without the terminator, or -1 on error.
+ */
+int ipc_format_analysis(const ipv4_t *ip, char *buf, size_t size);
+
+/**
+ * @brief Start splitting a network into equal subnets.
+ * 
+ * The subnet size is the largest power of two that gives at least
+ * count subnets. Subnets smaller than /31 are not allowed, so count
+ * is at most 2^31.
+ * 
+ * @param sp Iterator to set up.
+ * @param cidr Network in CIDR notation.
+ * @param count Number of subnets.
+ * 
+ * @return 0 on success, -1 on error.
+ */
+int ipc_split_equal(struct ipc_split *sp, const char *cidr, uint64_t count);
+
+/**
+ * @brief Start splitting a network into subnets of different sizes.
+ * 
+ * Each part is rounded up to a power of two. Parts are placed from
+ * the largest to the smallest, so every subnet is aligned.
+ * 
+ * The caller's parts array is reordered: it is sorted in place in
+ * descending order, and the iterator reads it until the last subnet.
+ * 
+ * @param sp Iterator to set up.
+ * @param cidr Network in CIDR notation.
+ * @param parts Number of addresses in each part. Sorted in place;
+ *              must outlive the iterator.
+ * @param len Number of parts.
+ * 
+ * @return 0 on success, -1 on error (including parts that do not fit).
+ */
+int ipc_split_part(struct ipc_split *sp, const char *cidr, int *parts, size_t len);
+
+/**
+ * @brief Get the next subnet.
+ * 
+ * @param sp Iterator.
+ * @param[out] out Subnet.
+ * 
+ * @return 1 if a subnet was produced, 0 at the end.
+ */
+int ipc_split_next(struct ipc_split *sp, struct ipc_subnet *out);
+
+/**
+ * @brief Get up to n next subnets.
+ * 
+ * @param sp Iterator.
+ * @param[out] arr Array of at least n subnets.
+ * @param n Size of arr.
+ * 
+ * @return Number of subnets written, 0 at the end.
+ */
+size_t ipc_split_fill(struct ipc_split *sp, struct ipc_subnet *arr, size_t n);
+
+/**
+ * @brief Move the iterator to a subnet index.
+ * 
+ * O(1): part splits sum the sizes counted by ipc_split_part(), one
+ * term per subnet size.
+ * 
+ * @param sp Iterator.
+ * @param idx Index of the subnet ipc_split_next() gives next.
+ * 
+ * @return 0 on success, -1 if idx is past the end.
+ */
+int ipc_split_seek(struct ipc_split *sp, uint64_t idx);
+
+/**
+ * @brief Format a row of the subnet table (see the -s mode).
+ * 
+ * @param sn Subnet.
+ * @param idx Row number.
+ * @param buf Destination buffer, IPC_SUBNET_ROW_MAX bytes are enough.
+ * @param size Size of buf.
+ * 
+ * @return Length of the row without the terminator, or -1 on error.
+ */
+int ipc_format_subnet(const struct ipc_subnet *sn, uint64_t idx, char *buf, size_t size);
+
+#endif /* IPC_H_SENTRY */
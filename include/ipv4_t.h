@@ -52,6 +52,8 @@ typedef struct ipv4 {
 
     uint8_t is_host_route;          /**< /32 host route flag */
     uint8_t is_point_to_point;      /**< /31 P2P link flag */
+    uint8_t special;                /**< Special-purpose class of the
+                                         network (special_class) */
 } ipv4_t;
 
 #endif /* IPV4_H_SENTRY */
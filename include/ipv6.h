@@ -0,0 +1,206 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef IPV6_H_SENTRY
+#define IPV6_H_SENTRY
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define BITS_IN_IP6			128
+#define IPV6_STR_LEN		39				/* "2001:0db8:0000:0000:0000:0000:0000:0001" */
+#define IPV6_REPORT_MAX		1024			/* Longest analysis report */
+#define IPV6_SUBNET_ROW_MAX	128				/* Longest subnet table row */
+
+/* Address in host byte order, first group in the high bits */
+typedef unsigned __int128 ipv6_u128;
+
+/**
+ * @struct ipv6
+ * @brief IPv6 prefix analysis, the counterpart of ipv4_t.
+ *
+ * IPv6 has no broadcast address, every address of a prefix is usable:
+ * hostmin is the network address and hostmax the last one.
+ */
+struct ipv6 {
+    ipv6_u128 addr;                 /**< Address */
+    uint8_t bitmask;                /**< Prefix length (e.g. 64) */
+    ipv6_u128 netmask;              /**< Mask */
+    ipv6_u128 wildcard;             /**< Inverse mask */
+    ipv6_u128 network;              /**< First address */
+    ipv6_u128 last;                 /**< Last address */
+};
+
+/**
+ * @struct ipv6_subnet
+ * @brief One subnet of a split.
+ */
+struct ipv6_subnet {
+    ipv6_u128 first;                /**< Network address */
+    ipv6_u128 last;                 /**< Last address */
+    uint8_t bitmask;                /**< Prefix length */
+};
+
+/**
+ * @struct ipv6_split
+ * @brief Lazy iterator over the subnets of a split.
+ *
+ * Nothing is stored per subnet, so a /32 split into 2^32 /64s costs no
+ * more memory than a split into two.
+ */
+struct ipv6_split {
+    ipv6_u128 base;                 /**< Network being split */
+    uint8_t bitmask;                /**< Prefix length of the network */
+    uint8_t sub_bitmask;            /**< Equal split: length of every subnet */
+    const ipv6_u128 *parts;         /**< Part split: sizes in descending order,
+                                         NULL for an equal split */
+    ipv6_u128 count;                /**< Number of subnets */
+    ipv6_u128 pos;                  /**< Index of the next subnet */
+    ipv6_u128 offset;               /**< Distance of the next subnet from base */
+};
+
+/**
+ * @brief Parse an IPv6 address.
+ *
+ * Accepts the full form, "::" compression and a dotted IPv4 tail
+ * (e.g. "::ffff:192.0.2.1"). The full eight-group form takes a fast
+ * path without any search for "::".
+ *
+ * @param str Address, ending at '\0' or '/'.
+ * @param[out] addr Parsed address.
+ * @return Characters consumed, or -1 on error.
+ */
+int ipv6_parse(const char *str, ipv6_u128 *addr);
+
+/**
+ * @brief Parse an IPv6 prefix, an address without '/' is a /128.
+ * @param cidr Prefix (e.g. "2001:db8::/32").
+ * @param[out] addr Address, host bits kept.
+ * @param[out] bitmask Prefix length.
+ * @return 0 on success, -1 on error.
+ */
+int ipv6_parse_cidr(const char *cidr, ipv6_u128 *addr, uint8_t *bitmask);
+
+/**
+ * @brief Mask of a prefix length.
+ * @param bitmask Prefix length, 0-128.
+ * @return Mask (e.g. 64 -> ffff:ffff:ffff:ffff::).
+ */
+ipv6_u128 ipv6_netmask(uint8_t bitmask);
+
+/**
+ * @brief Format an address in the RFC 5952 text form (e.g. "2001:db8::1").
+ * @param dst Destination, at least IPV6_STR_LEN bytes. Not terminated.
+ * @param addr Address.
+ * @return Pointer past the last written character.
+ */
+char *ipv6_format(char *dst, ipv6_u128 addr);
+
+/**
+ * @brief Format an address with every group in four digits.
+ *
+ * Same width for every address, used in the tables.
+ *
+ * @param dst Destination, at least IPV6_STR_LEN bytes. Not terminated.
+ * @param addr Address.
+ * @return Pointer past the last written character.
+ */
+char *ipv6_format_full(char *dst, ipv6_u128 addr);
+
+/**
+ * @brief Format a 128-bit number in decimal.
+ * @param dst Destination, at least 40 bytes. Not terminated.
+ * @param val Number.
+ * @return Pointer past the last written character.
+ */
+char *ipv6_format_u128(char *dst, ipv6_u128 val);
+
+/**
+ * @brief Parse a decimal 128-bit number.
+ * @param str Digits only.
+ * @param[out] val Number.
+ * @return 0 on success, -1 on error or overflow.
+ */
+int ipv6_parse_u128(const char *str, ipv6_u128 *val);
+
+/**
+ * @brief Analyze an IPv6 prefix.
+ * @param ip Structure to fill.
+ * @param cidr Prefix (e.g. "2001:db8::1/64").
+ * @return 0 on success, -1 on error.
+ */
+int ipv6_analyze(struct ipv6 *ip, const char *cidr);
+
+/**
+ * @brief Format the analysis report, laid out as the IPv4 one.
+ * @param ip Structure filled by ipv6_analyze().
+ * @param buf Destination buffer, IPV6_REPORT_MAX bytes are enough.
+ * @param size Size of buf.
+ * @return Length of the report without the terminator, or -1 on error.
+ */
+int ipv6_format_analysis(const struct ipv6 *ip, char *buf, size_t size);
+
+/**
+ * @brief Start splitting a network into equal subnets.
+ *
+ * The subnet size is the largest power of two that gives at least
+ * count subnets.
+ *
+ * @param sp Iterator to set up.
+ * @param cidr Network.
+ * @param count Number of subnets.
+ * @return 0 on success, -1 on error.
+ */
+int ipv6_split_equal(struct ipv6_split *sp, const char *cidr, ipv6_u128 count);
+
+/**
+ * @brief Start splitting a network into subnets of different sizes.
+ *
+ * Each part is rounded up to a power of two and parts are placed from
+ * the largest to the smallest, as in ipc_split_part().
+ *
+ * @param sp Iterator to set up.
+ * @param cidr Network.
+ * @param parts Number of addresses in each part. Sorted in place in
+ *              descending order; must outlive the iterator.
+ * @param len Number of parts.
+ * @return 0 on success, -1 on error (including parts that do not fit).
+ */
+int ipv6_split_part(struct ipv6_split *sp, const char *cidr, ipv6_u128 *parts, size_t len);
+
+/**
+ * @brief Get the next subnet.
+ * @param sp Iterator.
+ * @param[out] out Subnet.
+ * @return 1 if a subnet was produced, 0 at the end.
+ */
+int ipv6_split_next(struct ipv6_split *sp, struct ipv6_subnet *out);
+
+/**
+ * @brief Format a row of the subnet table, laid out as the IPv4 one.
+ * @param sn Subnet.
+ * @param idx Row number.
+ * @param buf Destination buffer, IPV6_SUBNET_ROW_MAX bytes are enough.
+ * @param size Size of buf.
+ * @return Length of the row without the terminator, or -1 on error.
+ */
+int ipv6_format_subnet(const struct ipv6_subnet *sn, ipv6_u128 idx, char *buf, size_t size);
+
+#endif /* IPV6_H_SENTRY */
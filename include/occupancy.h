@@ -0,0 +1,50 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef OCCUPANCY_H_SENTRY
+#define OCCUPANCY_H_SENTRY
+
+/**
+ * @brief Count host addresses per subnet of a split plan.
+ *
+ * The plan is given as for -s: a network, then "--equal <count>" or
+ * "--part <size> ...". The rest are options and address files (stdin
+ * if none). Every address is put in its subnet without building the
+ * subnet list: by a shift for an equal split, by a binary search over
+ * the subnet boundaries for a part split. Addresses outside every
+ * subnet are counted apart.
+ *
+ * One row per subnet is printed with its hosts, usable addresses,
+ * utilization and a status: "over" above the threshold, "empty"
+ * without hosts.
+ *
+ * Options:
+ * 	--threshold <pct>	 utilization that marks a subnet "over" (80)
+ * 	--flagged		 print only "over" and "empty" subnets
+ *
+ * @param argc Number of arguments after the mode option.
+ * @param argv Arguments after the mode option.
+ *
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on invalid arguments,
+ *         EXIT_INPUT on an error of the input (reported, see status.h).
+ */
+int occupancy_start(int argc, char **argv);
+
+#endif /* OCCUPANCY_H_SENTRY */
@@ -0,0 +1,158 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PREFIX_FILE_H_SENTRY
+#define PREFIX_FILE_H_SENTRY
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "prefix_list.h"
+#include "prefix_table.h"
+
+#define PREFIX_FILE_MAGIC		"IPCPFX\r\n"	/* \r\n catches text-mode copies */
+#define PREFIX_FILE_VERSION		1
+#define PREFIX_FILE_BLOCK		256				/* Prefixes per index entry */
+#define PREFIX_FILE_TABLE		0x1				/* Lookup table present */
+
+/**
+ * @struct prefix_file_header
+ * @brief First bytes of a compiled prefix set.
+ *
+ * The file holds, in order and each 8-byte aligned:
+ * 	- this header
+ * 	- the block index, one prefix_file_block per PREFIX_FILE_BLOCK keys
+ * 	- the keys (addr << 8 | bitmask), ascending, each but the first
+ * 	  of a block stored as a LEB128 varint delta from the previous one
+ * 	- optionally a prefix_table: offsets[PREFIX_LENGTHS + 1] then
+ * 	  the networks, both uint32_t
+ *
+ * Numbers are in host byte order; a version that reads byte-swapped
+ * marks a file from a machine of the other byte order.
+ */
+struct prefix_file_header {
+    char magic[8];                  /**< PREFIX_FILE_MAGIC */
+    uint32_t version;               /**< PREFIX_FILE_VERSION */
+    uint32_t flags;                 /**< PREFIX_FILE_TABLE */
+    uint64_t count;                 /**< Prefixes */
+    uint32_t block_keys;            /**< Prefixes per block */
+    uint32_t block_count;           /**< Blocks */
+    uint64_t index_offset;          /**< Block index */
+    uint64_t data_offset;           /**< Encoded keys */
+    uint64_t data_size;             /**< Bytes of encoded keys */
+    uint64_t table_offset;          /**< Lookup table, 0 if absent */
+    uint64_t file_size;             /**< Whole file */
+    uint64_t checksum;              /**< Of every byte after the header */
+    uint64_t reserved[2];           /**< Zero */
+};
+
+/**
+ * @struct prefix_file_block
+ * @brief Entry of the block index.
+ */
+struct prefix_file_block {
+    uint64_t first_key;             /**< Key of the first prefix */
+    uint64_t offset;                /**< Varints of the others, from data_offset */
+};
+
+/**
+ * @struct prefix_file
+ * @brief Compiled prefix set mapped into memory.
+ */
+struct prefix_file {
+    const uint8_t *map;             /**< Whole file */
+    size_t size;                    /**< Bytes mapped */
+    const struct prefix_file_header *hdr; /**< Header */
+    const struct prefix_file_block *index; /**< Block index */
+    const uint8_t *data;            /**< Encoded keys */
+    struct prefix_table table;      /**< Lookup table over the map,
+                                         empty if absent */
+};
+
+/**
+ * @brief Write a compiled prefix set.
+ *
+ * Host bits are cleared and duplicates removed first.
+ *
+ * @param fp Destination, opened in binary mode.
+ * @param items Prefixes. Sorted and deduplicated in place.
+ * @param[in,out] len Number of prefixes, unique ones on return.
+ * @param with_table Also store the lookup table.
+ *
+ * @return 0 on success, -1 on error.
+ */
+int prefix_file_write(FILE *fp, struct prefix *items, size_t *len, int with_table);
+
+/**
+ * @brief Check whether a stream holds a compiled prefix set.
+ *
+ * Only streams at offset 0 that can seek back are looked at, so pipes
+ * always count as text and lose nothing.
+ *
+ * @param fp Stream.
+ * @return 1 if compiled, 0 otherwise.
+ */
+int prefix_file_sniff(FILE *fp);
+
+/**
+ * @brief Map a compiled prefix set.
+ *
+ * Checks the header and the bounds of every section, which is all the
+ * decoder relies on; no key is read. The descriptor may be closed
+ * afterwards.
+ *
+ * @param pf Mapping to fill.
+ * @param fd Open file.
+ * @return 0 on success, -1 on error.
+ */
+int prefix_file_map(struct prefix_file *pf, int fd);
+
+/**
+ * @brief Map a compiled prefix set by path.
+ * @param pf Mapping to fill.
+ * @param path File.
+ * @return 0 on success, -1 on error.
+ */
+int prefix_file_open(struct prefix_file *pf, const char *path);
+
+/**
+ * @brief Decode one block.
+ * @param pf Mapping.
+ * @param block Block number.
+ * @param[out] out At least PREFIX_FILE_BLOCK prefixes.
+ * @return Prefixes decoded, 0 if the block is damaged.
+ */
+size_t prefix_file_block(const struct prefix_file *pf, uint32_t block, struct prefix *out);
+
+/**
+ * @brief Check the checksum and decode every key.
+ * @param pf Mapping.
+ * @return 0 if the file is intact, -1 otherwise.
+ */
+int prefix_file_verify(const struct prefix_file *pf);
+
+/**
+ * @brief Unmap.
+ * @param pf Mapping.
+ */
+void prefix_file_close(struct prefix_file *pf);
+
+#endif /* PREFIX_FILE_H_SENTRY */
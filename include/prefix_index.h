@@ -0,0 +1,126 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PREFIX_INDEX_H_SENTRY
+#define PREFIX_INDEX_H_SENTRY
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "prefix_list.h"
+#include "prefix_table.h"
+
+#define PREFIX_INDEX_NONE	UINT32_MAX		/* No enclosing prefix */
+
+/**
+ * @struct prefix_index
+ * @brief Prefix set answering subtree and ancestor queries.
+ *
+ * Unique prefixes are sorted as (network << 8 | bitmask): every
+ * prefix comes right after the prefixes holding it and before the
+ * ones it holds, so the prefixes inside any prefix form one run of
+ * the array, found by two binary searches. Each prefix also keeps the
+ * index of the nearest prefix holding it, which chains the holders
+ * of a prefix from the longest to the shortest.
+ *
+ * @warning Initialize the structure with zeros before using.
+ */
+struct prefix_index {
+    uint64_t *keys;                 /**< Prefixes, ascending */
+    uint32_t *parent;               /**< Nearest holder of each prefix,
+                                         PREFIX_INDEX_NONE if none */
+    size_t len;                     /**< Number of prefixes */
+};
+
+/**
+ * @brief Build an index from prefixes.
+ *
+ * Host bits are cleared and duplicates removed.
+ *
+ * @param ix Index to fill.
+ * @param items Prefixes.
+ * @param len Number of prefixes.
+ *
+ * @return 0 on success, -1 on error.
+ */
+int prefix_index_build(struct prefix_index *ix, const struct prefix *items, size_t len);
+
+/**
+ * @brief Build one index from the prefixes of several streams.
+ * @param ix Index to fill.
+ * @param fps Source streams, text or compiled.
+ * @param n Number of streams.
+ * @return 0 on success, -1 on error.
+ *
+ * @see prefix_table_collect
+ */
+int prefix_index_read(struct prefix_index *ix, FILE *const *fps, size_t n);
+
+/**
+ * @brief Find the stored prefixes inside a prefix, itself included.
+ *
+ * O(log n); the prefixes are the run keys[*first .. *first + count),
+ * in address order.
+ *
+ * @param ix Index.
+ * @param addr Address, host bits are ignored.
+ * @param bitmask Mask length.
+ * @param[out] first Index of the first prefix of the run.
+ *
+ * @return Number of prefixes.
+ */
+size_t prefix_index_inside(const struct prefix_index *ix, uint32_t addr, uint8_t bitmask,
+                           size_t *first);
+
+/**
+ * @brief Find the stored prefixes holding a prefix, itself included.
+ *
+ * O(log n) plus at most BITS_IN_IP steps up the holder chain.
+ *
+ * @param ix Index.
+ * @param addr Address, host bits are ignored.
+ * @param bitmask Mask length.
+ * @param[out] out At least PREFIX_LENGTHS indexes, shortest prefix first.
+ *
+ * @return Number of prefixes.
+ */
+size_t prefix_index_containing(const struct prefix_index *ix, uint32_t addr, uint8_t bitmask,
+                               uint32_t *out);
+
+/**
+ * @brief Get a stored prefix.
+ * @param ix Index.
+ * @param i Position, less than ix->len.
+ * @param[out] pfx Prefix.
+ */
+static inline void prefix_index_get(const struct prefix_index *ix, size_t i, struct prefix *pfx)
+{
+    pfx->addr = (uint32_t) (ix->keys[i] >> 8);
+    pfx->bitmask = (uint8_t) ix->keys[i];
+}
+
+/**
+ * @brief Free the index.
+ * @param ix Index.
+ */
+void prefix_index_free(struct prefix_index *ix);
+
+#endif /* PREFIX_INDEX_H_SENTRY */
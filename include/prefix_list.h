@@ -0,0 +1,115 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PREFIX_LIST_H_SENTRY
+#define PREFIX_LIST_H_SENTRY
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @struct prefix
+ * @brief Compact IPv4 prefix.
+ */
+struct prefix {
+    uint32_t addr;                  /**< Address in host byte order */
+    uint8_t bitmask;                /**< Mask length (e.g. 24) */
+};
+
+/**
+ * @struct token_reader
+ * @brief Splits a stream into whitespace separated tokens.
+ *
+ * Text from '#' to the end of the line is skipped.
+ *
+ * @warning Initialize with token_reader_init() before using.
+ */
+struct token_reader {
+    FILE *fp;                       /**< Source stream */
+    char *buf;                      /**< Read buffer */
+    size_t cap;                     /**< Size of buf */
+    size_t len;                     /**< Bytes of data in buf */
+    size_t pos;                     /**< Read position in buf */
+    uint8_t eof;                    /**< Source stream exhausted */
+    uint8_t in_comment;             /**< Skipping a comment */
+};
+
+/**
+ * @brief Prepare a reader for the stream.
+ * @param rd Reader to initialize.
+ * @param fp Source stream.
+ * @return 0 on success, -1 on error.
+ */
+int token_reader_init(struct token_reader *rd, FILE *fp);
+
+/**
+ * @brief Get the next token.
+ * @param rd Reader.
+ * @return Null-terminated token, or NULL at the end of the stream.
+ *         The token is valid until the next call.
+ */
+char *token_reader_next(struct token_reader *rd);
+
+/**
+ * @brief Free the reader buffer. The stream is not closed.
+ * @param rd Reader.
+ */
+void token_reader_free(struct token_reader *rd);
+
+/**
+ * @brief Parse a prefix in CIDR notation.
+ *
+ * An address without '/' is taken as a /32 host route.
+ * Host bits are kept as written.
+ *
+ * @param tok String such as "10.0.0.0/8" or "10.1.2.3".
+ * @param[out] pfx Parsed prefix.
+ * @return 0 on success, -1 on error.
+ *
+ * @see fill_addr
+ * @see fill_bitmask
+ */
+int parse_prefix(const char *tok, struct prefix *pfx);
+
+/**
+ * @brief Parse a prefix or an address range into an interval.
+ * @param tok Prefix (see parse_prefix) or range "first-last".
+ * @param[out] first First address of the interval.
+ * @param[out] last Last address of the interval.
+ * @return 0 on success, -1 on error.
+ */
+int parse_interval(const char *tok, uint32_t *first, uint32_t *last);
+
+/**
+ * @brief Netmask of the mask length as a number.
+ * @param bitmask Mask length, 0-32.
+ * @return Netmask (e.g. 24 -> 0xffffff00).
+ */
+uint32_t prefix_netmask(uint8_t bitmask);
+
+/**
+ * @brief Number of addresses in a prefix of the mask length.
+ * @param bitmask Mask length, 0-32.
+ * @return 2^(32 - bitmask).
+ */
+uint64_t prefix_size(uint8_t bitmask);
+
+#endif /* PREFIX_LIST_H_SENTRY */
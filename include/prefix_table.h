@@ -0,0 +1,118 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PREFIX_TABLE_H_SENTRY
+#define PREFIX_TABLE_H_SENTRY
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "fill_ipv4.h"
+#include "prefix_list.h"
+
+#define PREFIX_LENGTHS		(BITS_IN_IP + 1)
+
+/**
+ * @struct prefix_table
+ * @brief Longest-prefix-match table.
+ *
+ * Networks are grouped by mask length and sorted inside each group,
+ * all in one flat array, so the table can be written to a file or
+ * shared memory as is.
+ *
+ * @warning Initialize the structure with zeros before using.
+ */
+struct prefix_table {
+    const uint32_t *keys;                   /**< Networks, grouped by length */
+    uint32_t offsets[PREFIX_LENGTHS + 1];   /**< Group of length L is
+                                                 keys[offsets[L]..offsets[L + 1]) */
+    uint64_t lengths;                       /**< Bit L set if group L is not empty */
+    uint32_t *owned;                        /**< keys if allocated by the table */
+};
+
+/**
+ * @brief Build a table from prefixes.
+ *
+ * Host bits are cleared and duplicates removed.
+ *
+ * @param tab Table to fill.
+ * @param items Prefixes.
+ * @param len Number of prefixes.
+ *
+ * @return 0 on success, -1 on error.
+ */
+int prefix_table_build(struct prefix_table *tab, const struct prefix *items, size_t len);
+
+/**
+ * @brief Build one table from the prefixes of several streams.
+ * @param tab Table to fill.
+ * @param fps Source streams.
+ * @param n Number of streams.
+ * @return 0 on success, -1 on error.
+ *
+ * @see parse_prefix
+ */
+int prefix_table_read(struct prefix_table *tab, FILE *const *fps, size_t n);
+
+/**
+ * @brief Read the prefixes of several streams, text or compiled.
+ * @param fps Source streams.
+ * @param n Number of streams.
+ * @param[out] out Prefixes as written. The caller must free.
+ * @param[out] out_len Number of prefixes.
+ * @return 0 on success, -1 on error.
+ *
+ * @see parse_prefix
+ */
+int prefix_table_collect(FILE *const *fps, size_t n, struct prefix **out, size_t *out_len);
+
+/**
+ * @brief Find the longest prefix holding the address.
+ * @param tab Table.
+ * @param addr Address in host byte order.
+ * @param[out] pfx Matching prefix.
+ * @return 1 if found, 0 otherwise.
+ */
+int prefix_table_lookup(const struct prefix_table *tab, uint32_t addr, struct prefix *pfx);
+
+/**
+ * @brief Check whether the table holds the exact prefix.
+ * @param tab Table.
+ * @param addr Network address.
+ * @param bitmask Mask length.
+ * @return 1 if present, 0 otherwise.
+ */
+int prefix_table_contains(const struct prefix_table *tab, uint32_t addr, uint8_t bitmask);
+
+/**
+ * @brief Number of prefixes in the table.
+ * @param tab Table.
+ * @return Prefix count.
+ */
+size_t prefix_table_size(const struct prefix_table *tab);
+
+/**
+ * @brief Free keys owned by the table.
+ * @param tab Table.
+ */
+void prefix_table_free(struct prefix_table *tab);
+
+#endif /* PREFIX_TABLE_H_SENTRY */
@@ -0,0 +1,106 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRNG_H_SENTRY
+#define PRNG_H_SENTRY
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @struct prng
+ * @brief xoshiro256** generator state.
+ *
+ * @warning Seed with prng_seed() before using.
+ */
+struct prng {
+    uint64_t s[4];                  /**< Generator state */
+};
+
+/**
+ * @struct prng_alias
+ * @brief Walker's alias table, draws weighted items in O(1).
+ *
+ * A draw picks a column uniformly, then keeps it or takes its alias
+ * by a 32-bit coin.
+ */
+struct prng_alias {
+    uint64_t *prob;                 /**< Chance to keep column i, of 2^32 */
+    uint32_t *alias;                /**< Item taken instead of i */
+    size_t len;                     /**< Number of items */
+};
+
+/**
+ * @brief Seed the generator.
+ *
+ * The same seed always gives the same sequence.
+ *
+ * @param rng Generator.
+ * @param seed Any value, 0 included.
+ */
+void prng_seed(struct prng *rng, uint64_t seed);
+
+/**
+ * @brief Get the next 64 random bits.
+ * @param rng Generator.
+ * @return Random number.
+ */
+uint64_t prng_next(struct prng *rng);
+
+/**
+ * @brief Get an unbiased random number below the bound.
+ * @param rng Generator.
+ * @param bound Exclusive upper bound, must not be 0.
+ * @return Random number in [0, bound).
+ */
+uint64_t prng_bounded(struct prng *rng, uint64_t bound);
+
+/**
+ * @brief Make a seed from the clock and the process id.
+ * @return Seed for runs that need not be reproducible.
+ */
+uint64_t prng_entropy(void);
+
+/**
+ * @brief Build an alias table (Vose's method).
+ * @param tab Table to fill.
+ * @param weights Item weights, all positive.
+ * @param len Number of items.
+ * @return 0 on success, -1 on error.
+ */
+int prng_alias_init(struct prng_alias *tab, const double *weights, size_t len);
+
+/**
+ * @brief Resolve a column to an item.
+ * @param tab Table.
+ * @param col Column drawn uniformly from [0, tab->len).
+ * @param coin Uniform 32 random bits.
+ * @return Item index.
+ */
+static inline size_t prng_alias_pick(const struct prng_alias *tab, size_t col, uint32_t coin)
+{ return coin < tab->prob[col] ? col : tab->alias[col]; }
+
+/**
+ * @brief Free an alias table.
+ * @param tab Table.
+ */
+void prng_alias_free(struct prng_alias *tab);
+
+#endif /* PRNG_H_SENTRY */
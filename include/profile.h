@@ -0,0 +1,51 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PROFILE_H_SENTRY
+#define PROFILE_H_SENTRY
+
+/**
+ * @brief Profile a prefix table.
+ *
+ * Reads prefixes from the files in argv, or from stdin if there are
+ * none, and reports in one pass plus one sort:
+ * 	- the number of entries of each prefix length
+ * 	- duplicates (same prefix once host bits are cleared)
+ * 	- entries with host bits set (address is not the network address)
+ * 	- addresses covered, counting overlaps and once
+ * 	- how deep unique prefixes are nested in one another
+ *
+ * Input is read in blocks of 4 MiB, each parsed by
+ * several threads at line boundaries; only the packed prefixes
+ * (8 bytes each) are kept for the sort.
+ *
+ * Options:
+ * 	--json		 one JSON object instead of the table
+ * 	--threads <n>	 parsing threads, default the number of CPUs
+ *
+ * @param argc Number of arguments after the mode option.
+ * @param argv Arguments after the mode option.
+ *
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on invalid arguments,
+ *         EXIT_INPUT on an error of the input (reported, see status.h).
+ */
+int profile_start(int argc, char **argv);
+
+#endif /* PROFILE_H_SENTRY */
@@ -0,0 +1,45 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PUBLISH_H_SENTRY
+#define PUBLISH_H_SENTRY
+
+/**
+ * @brief Manage prefix tables shared through POSIX shared memory.
+ *
+ * Subcommands, each followed by the table name:
+ * 	publish <name> [file...]  build a table from prefix files (text or
+ * 	                          compiled, stdin if none) and make it the
+ * 	                          current generation
+ * 	lookup <name> [file...]   longest match of every address read,
+ * 	                          switching to newer generations as they
+ * 	                          are published
+ * 	remove <name>             remove the table; mapped generations
+ * 	                          live until their readers unmap them
+ *
+ * @param argc Number of arguments after the mode option.
+ * @param argv Arguments after the mode option.
+ *
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on invalid arguments,
+ *         EXIT_INPUT on an error of the input (reported, see status.h).
+ */
+int publish_start(int argc, char **argv);
+
+#endif /* PUBLISH_H_SENTRY */
@@ -0,0 +1,50 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUERY_H_SENTRY
+#define QUERY_H_SENTRY
+
+/**
+ * @brief Answer subtree and ancestor queries over a prefix set.
+ *
+ * The prefix files in argv (text or compiled) are indexed once, then
+ * every query is answered in time proportional to its result:
+ * 	inside <prefix>		 stored prefixes within it, in address order
+ * 	containing <prefix>	 stored prefixes holding it, shortest first
+ * Both include the prefix itself if it is stored.
+ *
+ * Each answer is a line "<query> <prefix> <count>" followed by count
+ * prefix lines.
+ *
+ * Options:
+ * 	--inside <prefix>	 one query
+ * 	--containing <prefix>	 one query
+ * 	--queries <file>	 one query per line, "-" for stdin
+ * With no query option, queries are read from stdin.
+ *
+ * @param argc Number of arguments after the mode option.
+ * @param argv Arguments after the mode option.
+ *
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on invalid arguments,
+ *         EXIT_INPUT on an error of the input (reported, see status.h).
+ */
+int query_start(int argc, char **argv);
+
+#endif /* QUERY_H_SENTRY */
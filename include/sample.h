@@ -0,0 +1,45 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SAMPLE_H_SENTRY
+#define SAMPLE_H_SENTRY
+
+/**
+ * @brief Draw random addresses from a set of prefixes.
+ *
+ * The first argument is the number of addresses to draw. Prefixes are
+ * read from the files in argv, or from stdin if there are none.
+ * By default every address of the union is equally likely.
+ *
+ * Options:
+ * 	--weighted	 pick a prefix by its weight, then an address inside it.
+ * 			 A number after a prefix is its weight, 1 by default.
+ * 	--seed <n>	 seed for a reproducible run
+ * 	--binary	 write 4-byte addresses in network byte order
+ *
+ * @param argc Number of arguments after the mode option.
+ * @param argv Arguments after the mode option.
+ *
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on invalid arguments,
+ *         EXIT_INPUT on an error of the input (reported, see status.h).
+ */
+int sample_start(int argc, char **argv);
+
+#endif /* SAMPLE_H_SENTRY */
@@ -0,0 +1,87 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SCAN_H_SENTRY
+#define SCAN_H_SENTRY
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SCAN_RUN_MAX		64		/* Longer digit and dot runs are no address */
+
+/**
+ * @brief Receives an address found in the text.
+ * @param ctx Caller data.
+ * @param addr Address in host byte order.
+ * @param offset Byte offset of its first digit from the start of the text.
+ * @param line Line number of the address, from 1.
+ */
+typedef void (*scan_emit_fn)(void *ctx, uint32_t addr, uint64_t offset, uint64_t line);
+
+/**
+ * @struct scan_state
+ * @brief Scanner fed with consecutive pieces of one text.
+ *
+ * A candidate is a maximal run of digits and dots. After dots at
+ * either end are dropped it must be an address as fill_addr() takes
+ * it: four octets of at least one digit, none above 255. Runs such as
+ * "1.2.3.4.5" or "10.0.0.256" are not cut down to an address.
+ *
+ * @warning Initialize with scan_init() before using.
+ */
+struct scan_state {
+    uint64_t offset;                /**< Bytes fed so far */
+    uint64_t line;                  /**< Line at the end of the text fed */
+    uint64_t run_line;              /**< Line where the open run starts */
+    size_t run_len;                 /**< Bytes of the run reaching the end of the
+                                         text fed, above SCAN_RUN_MAX if too long */
+    char run_buf[SCAN_RUN_MAX];     /**< Open run, kept across pieces */
+};
+
+/**
+ * @brief Prepare a scanner.
+ * @param st Scanner.
+ */
+void scan_init(struct scan_state *st);
+
+/**
+ * @brief Scan the next piece of the text.
+ *
+ * Digit and dot runs are found with vector compares over 64-byte
+ * blocks; only runs long enough to be an address are looked at.
+ *
+ * @param st Scanner.
+ * @param buf Text.
+ * @param len Bytes of text.
+ * @param emit Receives the addresses, in order.
+ * @param ctx Passed to emit.
+ */
+void scan_feed(struct scan_state *st, const char *buf, size_t len,
+               scan_emit_fn emit, void *ctx);
+
+/**
+ * @brief End the text, checking a run that reaches its end.
+ * @param st Scanner.
+ * @param emit Receives the last address.
+ * @param ctx Passed to emit.
+ */
+void scan_finish(struct scan_state *st, scan_emit_fn emit, void *ctx);
+
+#endif /* SCAN_H_SENTRY */
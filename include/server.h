@@ -0,0 +1,55 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SERVER_H_SENTRY
+#define SERVER_H_SENTRY
+
+/**
+ * @brief Answer requests on a Unix domain socket.
+ *
+ * Requests are lines with the verbs of the command line:
+ * 	analyze|-a <ip/bitmask>			 analysis report
+ * 	split|-s <ip/bitmask> --equal <count>	 subnet table
+ * 	split|-s <ip/bitmask> --part <uint, ...>
+ * 	lookup <ip>				 longest matching prefix of
+ * 						 the preloaded tables, or "none"
+ * 	count|-t <expression, ...>		 addresses of target expressions
+ * 	ping					 "pong"
+ *
+ * Every response ends with an empty line, failed requests get
+ * "error: <reason>". Clients may send many requests without waiting,
+ * all complete lines of one read are answered with one write.
+ *
+ * Options:
+ * 	--table <file>	 preload prefixes for lookup, may repeat
+ * 	--shm <name>	 look up in a shared table instead (see ipc shm),
+ * 			 following the generations published
+ *
+ * Runs until SIGINT or SIGTERM, then removes the socket file.
+ *
+ * @param argc Number of arguments after the mode option.
+ * @param argv Arguments after the mode option, the socket path first.
+ *
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on invalid arguments,
+ *         EXIT_INPUT on an error of the input (reported, see status.h).
+ */
+int server_start(int argc, char **argv);
+
+#endif /* SERVER_H_SENTRY */
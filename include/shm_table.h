@@ -0,0 +1,133 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SHM_TABLE_H_SENTRY
+#define SHM_TABLE_H_SENTRY
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "prefix_list.h"
+#include "prefix_table.h"
+#include "prefix_file.h"
+
+#define SHM_TABLE_MAGIC			"IPCSHM\r\n"
+#define SHM_TABLE_VERSION		1
+#define SHM_TABLE_NAME_MAX		255		/* Longest segment name, with the '/' */
+
+/**
+ * @struct shm_table_header
+ * @brief Control segment of a published table.
+ *
+ * A table named "/name" lives in two POSIX shared memory segments:
+ * this header under "/name" and the current generation, a compiled
+ * prefix set with its lookup table (see prefix_file.h), under
+ * "/name.<generation>". Publishing writes the next generation in full,
+ * stores its number here and unlinks the previous one, whose memory
+ * goes away when the last reader unmaps it.
+ */
+struct shm_table_header {
+    char magic[8];                  /**< SHM_TABLE_MAGIC */
+    uint32_t version;               /**< SHM_TABLE_VERSION */
+    uint32_t reserved;              /**< Zero */
+    uint64_t generation;            /**< Current generation, 0 before the
+                                         first; accessed atomically */
+};
+
+/**
+ * @struct shm_table
+ * @brief Reader of a published table.
+ * @warning Initialize with shm_table_attach() before using.
+ */
+struct shm_table {
+    char name[SHM_TABLE_NAME_MAX + 1];      /**< Control segment name */
+    const struct shm_table_header *hdr;     /**< Control segment, read-only */
+    uint64_t generation;                    /**< Generation mapped */
+    struct prefix_file file;                /**< Generation mapped, read-only */
+};
+
+/**
+ * @brief Publish a new generation of a table.
+ *
+ * Creates the control segment on first use. Publishers are serialized
+ * with a lock on the control segment; readers never wait.
+ *
+ * @param name Table name, with or without the leading '/'.
+ * @param items Prefixes. Sorted and deduplicated in place.
+ * @param[in,out] len Number of prefixes, unique ones on return.
+ * @param[out] generation Generation published, may be NULL.
+ *
+ * @return 0 on success, -1 on error (errno set).
+ */
+int shm_table_publish(const char *name, struct prefix *items, size_t *len,
+                      uint64_t *generation);
+
+/**
+ * @brief Remove a table.
+ *
+ * Readers keep the generation they have mapped.
+ *
+ * @param name Table name.
+ *
+ * @return 0 on success, -1 on error (errno set).
+ */
+int shm_table_remove(const char *name);
+
+/**
+ * @brief Map the current generation of a table.
+ * @param st Reader to set up.
+ * @param name Table name.
+ * @return 0 on success, -1 on error (errno set).
+ */
+int shm_table_attach(struct shm_table *st, const char *name);
+
+/**
+ * @brief Switch to the current generation if a newer one was published.
+ *
+ * Costs one atomic load when nothing changed, so it can run before
+ * every batch of lookups. Tables read from st->file before the call
+ * are invalid after a switch.
+ *
+ * @param st Reader.
+ *
+ * @return 1 if switched, 0 if current, -1 on error (the old
+ *         generation stays mapped).
+ */
+int shm_table_refresh(struct shm_table *st);
+
+/**
+ * @brief Find the longest prefix holding the address.
+ * @param st Reader.
+ * @param addr Address in host byte order.
+ * @param[out] pfx Matching prefix.
+ * @return 1 if found, 0 otherwise.
+ */
+static inline int shm_table_lookup(const struct shm_table *st, uint32_t addr, struct prefix *pfx)
+{
+	return prefix_table_lookup(&st->file.table, addr, pfx);
+}
+
+/**
+ * @brief Unmap the table.
+ * @param st Reader.
+ */
+void shm_table_detach(struct shm_table *st);
+
+#endif /* SHM_TABLE_H_SENTRY */
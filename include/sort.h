@@ -0,0 +1,52 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SORT_H_SENTRY
+#define SORT_H_SENTRY
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Sorts 64-bit keys in ascending order.
+ *
+ * LSD radix sort with 16-bit digits. Passes in which every key
+ * has the same digit are skipped.
+ *
+ * @param arr Keys to sort.
+ * @param len Number of keys.
+ *
+ * @return 0 on success, -1 on error.
+ */
+int sort_u64(uint64_t *arr, size_t len);
+
+/**
+ * @brief Sorts 32-bit keys in ascending order.
+ *
+ * @param arr Keys to sort.
+ * @param len Number of keys.
+ *
+ * @return 0 on success, -1 on error.
+ *
+ * @see sort_u64
+ */
+int sort_u32(uint32_t *arr, size_t len);
+
+#endif /* SORT_H_SENTRY */
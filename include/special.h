@@ -0,0 +1,129 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPECIAL_H_SENTRY
+#define SPECIAL_H_SENTRY
+
+#include <stdint.h>
+
+#define SPECIAL_DESCEND		0x80			/* Table entry: next octet decides,
+											   low bits select the block */
+
+/**
+ * @enum special_class
+ * @brief Entry of the IANA IPv4 Special-Purpose Address Registry
+ *        (RFC 6890) holding an address.
+ */
+enum special_class {
+    special_none,                   /**< Ordinary global unicast */
+    special_this_network,           /**< 0.0.0.0/8 */
+    special_private,                /**< 10/8, 172.16/12, 192.168/16 */
+    special_shared,                 /**< 100.64/10, carrier-grade NAT */
+    special_loopback,               /**< 127/8 */
+    special_link_local,             /**< 169.254/16 */
+    special_protocol,               /**< 192.0.0/24, IETF protocol assignments */
+    special_ds_lite,                /**< 192.0.0.0/29 */
+    special_dummy,                  /**< 192.0.0.8/32 */
+    special_anycast,                /**< 192.0.0.9-10/32, PCP and TURN anycast */
+    special_nat64,                  /**< 192.0.0.170-171/32, NAT64 discovery */
+    special_documentation,          /**< 192.0.2/24, 198.51.100/24, 203.0.113/24 */
+    special_as112,                  /**< 192.31.196/24, 192.175.48/24 */
+    special_amt,                    /**< 192.52.193/24 */
+    special_6to4_relay,             /**< 192.88.99/24, deprecated */
+    special_benchmarking,           /**< 198.18/15 */
+    special_multicast,              /**< 224/4 */
+    special_reserved,               /**< 240/4 */
+    special_broadcast,              /**< 255.255.255.255/32 */
+    special_mixed,                  /**< Prefix spanning several classes */
+    SPECIAL_CLASSES
+};
+
+/**
+ * @struct special_info
+ * @brief Registry attributes of a class.
+ */
+struct special_info {
+    const char *name;               /**< Short name (e.g. "private") */
+    const char *rfc;                /**< Defining document, NULL for none */
+    uint8_t global;                 /**< Globally reachable */
+};
+
+/* Lookup tables, one level per octet, built by the compiler */
+extern const uint8_t special_octet1[256];
+extern const uint8_t special_octet2[][256];
+extern const uint8_t special_octet3[][256];
+extern const uint8_t special_octet4[][256];
+
+extern const struct special_info special_registry[SPECIAL_CLASSES];
+
+/**
+ * @brief One table level without branches.
+ *
+ * A class passes through unchanged: block 0 of every level is a
+ * dummy that is read but masked out.
+ *
+ * @param v Entry of the previous level.
+ * @param tab Blocks of this level.
+ * @param octet Octet of this level.
+ * @return Entry of this level.
+ */
+static inline uint8_t special_step(uint8_t v, const uint8_t (*tab)[256], uint8_t octet)
+{
+	uint8_t m = (uint8_t) -(v >> 7);
+
+	return (tab[v & m & ~SPECIAL_DESCEND][octet] & m) | (v & ~m);
+}
+
+/**
+ * @brief Classify an address.
+ *
+ * Four table reads and no branches, whatever the address; the tables
+ * take under 5 KiB and stay in the L1 cache during bulk work.
+ *
+ * @param addr Address in host byte order.
+ * @return special_class of the address.
+ */
+static inline enum special_class special_classify(uint32_t addr)
+{
+	uint8_t v = special_octet1[addr >> 24];
+
+	v = special_step(v, special_octet2, (uint8_t) (addr >> 16));
+	v = special_step(v, special_octet3, (uint8_t) (addr >> 8));
+	v = special_step(v, special_octet4, (uint8_t) addr);
+
+	return (enum special_class) v;
+}
+
+/**
+ * @brief Classify every address of a prefix.
+ * @param addr Network address in host byte order.
+ * @param bitmask Prefix length.
+ * @return special_class shared by all its addresses, or special_mixed.
+ */
+enum special_class special_classify_prefix(uint32_t addr, uint8_t bitmask);
+
+/**
+ * @brief Short name of a class.
+ * @param cls Class.
+ * @return Name, "global" for special_none.
+ */
+const char *special_name(enum special_class cls);
+
+#endif /* SPECIAL_H_SENTRY */
@@ -0,0 +1,156 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef STATS_H_SENTRY
+#define STATS_H_SENTRY
+
+/*
+ * Instrumentation of the --stats option.
+ *
+ * Built only with -DIPC_STATS (make STATS=1). Otherwise every macro
+ * below expands to nothing and no counter exists.
+ */
+
+#include <stdint.h>
+
+/**
+ * @enum stats_stage
+ * @brief Pipeline stages timed by STATS_LAP().
+ */
+enum stats_stage { stage_parse, stage_derive, stage_build, stage_output, STAGE_COUNT };
+
+/**
+ * @enum stats_hist
+ * @brief Paths with a latency histogram.
+ */
+enum stats_hist { hist_batch, hist_serve, HIST_COUNT };
+
+#ifdef IPC_STATS
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+
+#define HIST_SUB_BITS		4				/* 16 buckets per power of two */
+#define HIST_BUCKETS		((64 - HIST_SUB_BITS + 1) << HIST_SUB_BITS)
+
+/**
+ * @struct stats_histogram
+ * @brief Log-linear histogram of clock ticks, HDR-style.
+ *
+ * Values below 16 have their own bucket, larger values share a bucket
+ * with those that agree in the top 5 significant bits, so a bucket is
+ * at most 1/16 of its value wide.
+ */
+struct stats_histogram {
+    uint64_t buckets[HIST_BUCKETS]; /**< Values per bucket */
+    uint64_t count;                 /**< Values recorded */
+    uint64_t sum;                   /**< Sum of the values */
+    uint64_t max;                   /**< Largest value */
+};
+
+/**
+ * @struct stats
+ * @brief Process-wide counters.
+ */
+struct stats {
+    uint64_t ticks[STAGE_COUNT];    /**< Clock ticks per stage */
+    uint64_t laps[STAGE_COUNT];     /**< Timed sections per stage */
+    uint64_t items;                 /**< Entries processed */
+    uint64_t errors;                /**< Invalid entries */
+    uint64_t allocs;                /**< Heap allocations */
+    uint64_t alloc_bytes;           /**< Bytes requested from the heap */
+    struct stats_histogram hist[HIST_COUNT]; /**< Latency per path */
+};
+
+extern struct stats ipc_stats;
+
+/**
+ * @brief Cheapest monotonic tick counter available.
+ * @return Ticks, converted to time by stats_report().
+ */
+static inline uint64_t stats_clock(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+/**
+ * @brief Record a value in a histogram.
+ * @param h Histogram.
+ * @param value Clock ticks.
+ */
+void stats_hist_add(struct stats_histogram *h, uint64_t value);
+
+/**
+ * @brief Start collecting, called once before the mode runs.
+ * @param json Report as JSON instead of text.
+ */
+void stats_enable(int json);
+
+/**
+ * @brief Print the report to stderr if collection was enabled.
+ */
+void stats_report(void);
+
+/* Start of a lap timer */
+#define STATS_DECL(t)			uint64_t t = stats_clock()
+
+/* Add the time since the last mark to a stage and mark again */
+#define STATS_LAP(t, stage)												\
+	do {																\
+		uint64_t stats_now_ = stats_clock();							\
+		ipc_stats.ticks[stage] += stats_now_ - (t);						\
+		ipc_stats.laps[stage]++;										\
+		(t) = stats_now_;												\
+	} while (0)
+
+/* Restart a lap timer without charging any stage */
+#define STATS_MARK(t)			((t) = stats_clock())
+
+/* Record the time since t in a histogram */
+#define STATS_LATENCY(path, t)	stats_hist_add(&ipc_stats.hist[path], stats_clock() - (t))
+
+#define STATS_ITEMS(n)			(ipc_stats.items += (n))
+#define STATS_ERRORS(n)			(ipc_stats.errors += (n))
+
+#else /* IPC_STATS */
+
+#define STATS_DECL(t)			do { } while (0)
+#define STATS_LAP(t, stage)		do { } while (0)
+#define STATS_MARK(t)			do { } while (0)
+#define STATS_LATENCY(path, t)	do { } while (0)
+#define STATS_ITEMS(n)			do { } while (0)
+#define STATS_ERRORS(n)			do { } while (0)
+
+#define stats_enable(json)		do { } while (0)
+#define stats_report()			do { } while (0)
+
+#endif /* IPC_STATS */
+
+#endif /* STATS_H_SENTRY */
@@ -0,0 +1,38 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef STATUS_H_SENTRY
+#define STATUS_H_SENTRY
+
+/*
+ * Exit status of the mode handlers (the *_start functions).
+ *
+ * EXIT_FAILURE means the arguments are wrong and main() prints the
+ * usage. A failure on the data (an invalid entry, a damaged file, an
+ * unreadable file, no memory) is EXIT_INPUT: the handler has said what
+ * went wrong and the usage would only bury it. The process exits with
+ * EXIT_FAILURE either way.
+ */
+
+#include <stdlib.h>
+
+#define EXIT_INPUT			2
+
+#endif /* STATUS_H_SENTRY */
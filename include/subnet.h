@@ -23,12 +23,9 @@
 
 #include <stddef.h>
 
-#include "ipv4_t.h"
-
 /**
  * @brief Dividing the network into subnets.
  *
- * @param ip Structure with address data.
  * @param ip_str IP address in CIDR notation.
  * @param arr Stores the parts into which the network should be divided.
  *            The size of the array is the number of parts, the value of
@@ -36,9 +33,13 @@
  *            If the array is initialized with zeros, then the division
  *            occurs into equal parts.
  * @param len Size of arr.
+ * @param threads Number of threads formatting rows, 0 for the
+ *                single-threaded list of earlier versions. Each thread
+ *                seeks to its own chunks of rows, which are written
+ *                out in order.
  * 
  * @return EXIT_SUCCESS on success, EXIT_FAILURE on error.
  */
-int subnetting_start(ipv4_t *ip, const char *ip_str, int *arr, size_t len);
+int subnetting_start(const char *ip_str, int *arr, size_t len, unsigned threads);
 
 #endif /* SUBNET_H_SENTRY */
@@ -0,0 +1,45 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SUBNET6_H_SENTRY
+#define SUBNET6_H_SENTRY
+
+/**
+ * @brief Split an IPv6 network.
+ *
+ * Subnets are produced one at a time and written as they come, so
+ * splits into billions of parts start printing at once and take no
+ * memory.
+ *
+ * Arguments:
+ * 	<ip/bitmask> --equal <count>	 count subnets of the same size
+ * 	<ip/bitmask> --part <n, ...>	 a subnet of at least n addresses
+ * 					 for each n, largest first
+ *
+ * Counts take any value up to 2^128 - 1.
+ *
+ * @param argc Number of arguments after the mode option.
+ * @param argv Arguments after the mode option.
+ *
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on error.
+ */
+int subnetting6_start(int argc, char **argv);
+
+#endif /* SUBNET6_H_SENTRY */
@@ -22,6 +22,7 @@
 #define SUBNET_LIST_H_SENTRY
 
 #include "ipv4_t.h"
+#include "ipc.h"
 
 /**
  * @struct subnet
@@ -49,12 +50,12 @@ struct subnet *add_to_list(struct subnet *head, struct subnet *node);
 void remove_list(struct subnet *head);
 
 /**
- * @brief Initializes subnet node with IP address data.
+ * @brief Initializes subnet node with split results.
  * @param node Node to initialize.
- * @param ip Source IP data.
+ * @param sn Subnet produced by a split iterator.
  * @return 0 on success, -1 on error.
  */
-int init_node(struct subnet *node, ipv4_t *ip);
+int init_node(struct subnet *node, const struct ipc_subnet *sn);
 
 /**
  * @brief Prints all nodes in the list.
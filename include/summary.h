@@ -0,0 +1,138 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SUMMARY_H_SENTRY
+#define SUMMARY_H_SENTRY
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define SUMMARY_INVALID		-2		/* summary_read: entry is no prefix */
+#define SUMMARY_ENTRY_MAX	64		/* Room for an invalid entry */
+
+/**
+ * @brief Receives a change of the cover.
+ * @param ctx Caller data.
+ * @param added 1 if the prefix joined the cover, 0 if it left.
+ * @param addr Network address.
+ * @param bitmask Mask length.
+ */
+typedef void (*summary_emit_fn)(void *ctx, int added, uint32_t addr, uint8_t bitmask);
+
+/**
+ * @struct summary_node
+ * @brief Node of the summary trie, one per prefix on a stored path.
+ */
+struct summary_node {
+    uint32_t child[2];              /**< Children by the next bit, 0 if none
+                                         (the root is never a child) */
+    uint32_t count;                 /**< Times this exact prefix was added */
+    uint8_t covered;                /**< count or both children covered */
+};
+
+/**
+ * @struct summary
+ * @brief Minimal CIDR cover of a changing set of prefixes.
+ *
+ * A binary trie over the prefixes as added. A node is covered when its
+ * own prefix is present or both halves are covered; the cover is the
+ * covered nodes without a covered parent. An add or a remove touches
+ * only the nodes on its path (at most 33), and the cover changes only
+ * below the highest node whose state flipped, so the delta is found
+ * without looking at the rest of the trie.
+ *
+ * @warning Initialize with summary_init() before using.
+ */
+struct summary {
+    struct summary_node *nodes;     /**< Node pool, nodes[0] is the root */
+    size_t len;                     /**< Nodes handed out from the pool */
+    size_t cap;                     /**< Allocated nodes */
+    uint32_t free_list;             /**< Released nodes linked by child[0],
+                                         0 if empty */
+    size_t prefixes;                /**< Prefixes added and not removed */
+};
+
+/**
+ * @brief Prepare an empty summary.
+ * @param sm Summary.
+ * @return 0 on success, -1 on error.
+ */
+int summary_init(struct summary *sm);
+
+/**
+ * @brief Add a prefix. Host bits are cleared.
+ *
+ * The same prefix may be added several times; it stays until removed
+ * as many times.
+ *
+ * @param sm Summary.
+ * @param addr Address.
+ * @param bitmask Mask length.
+ * @param emit Called for every change of the cover, removals first.
+ *             May be NULL.
+ * @param ctx Passed to emit.
+ *
+ * @return 0 on success, -1 on error.
+ */
+int summary_add(struct summary *sm, uint32_t addr, uint8_t bitmask,
+                summary_emit_fn emit, void *ctx);
+
+/**
+ * @brief Remove a prefix added earlier. Host bits are cleared.
+ * @param sm Summary.
+ * @param addr Address.
+ * @param bitmask Mask length.
+ * @param emit Called for every change of the cover, removals first.
+ *             May be NULL.
+ * @param ctx Passed to emit.
+ * @return 0 on success, -1 if the prefix is not present.
+ */
+int summary_remove(struct summary *sm, uint32_t addr, uint8_t bitmask,
+                   summary_emit_fn emit, void *ctx);
+
+/**
+ * @brief Add the prefixes of a stream.
+ * @param sm Summary.
+ * @param fp Source stream.
+ * @param[out] bad Invalid entry, cut to size. May be NULL.
+ * @param size Size of bad.
+ * @return 0 on success, SUMMARY_INVALID on an invalid entry, -1 on
+ *         other errors.
+ *
+ * @see parse_prefix
+ */
+int summary_read(struct summary *sm, FILE *fp, char *bad, size_t size);
+
+/**
+ * @brief Report the whole cover in address order, each prefix as added.
+ * @param sm Summary.
+ * @param emit Receives the prefixes.
+ * @param ctx Passed to emit.
+ */
+void summary_walk(const struct summary *sm, summary_emit_fn emit, void *ctx);
+
+/**
+ * @brief Free the trie.
+ * @param sm Summary.
+ */
+void summary_free(struct summary *sm);
+
+#endif /* SUMMARY_H_SENTRY */
@@ -0,0 +1,48 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SUPERNET_H_SENTRY
+#define SUPERNET_H_SENTRY
+
+/**
+ * @brief Find the smallest prefix containing every entry.
+ *
+ * Reads entries as -c does (prefixes, addresses, ranges, compiled
+ * sets) from the files in argv, or from stdin if there are none, and
+ * prints the covering prefix, its analysis and how much of it the
+ * entries use.
+ *
+ * The prefix is the common leading bits of every first and last
+ * address, found by AND and OR accumulators in vector lanes.
+ *
+ * Options:
+ * 	--binary	 4-byte addresses in network byte order (see -r --binary)
+ * 	--no-waste	 skip the union of the entries, the input is then
+ * 			 reduced at read speed and not kept in memory
+ *
+ * @param argc Number of arguments after the mode option.
+ * @param argv Arguments after the mode option.
+ *
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on invalid arguments,
+ *         EXIT_INPUT on an error of the input (reported, see status.h).
+ */
+int supernet_start(int argc, char **argv);
+
+#endif /* SUPERNET_H_SENTRY */
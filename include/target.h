@@ -0,0 +1,147 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef TARGET_H_SENTRY
+#define TARGET_H_SENTRY
+
+#include <stdint.h>
+
+#include "ipv4_t.h"
+#include "prefix_list.h"
+
+#define OCTET_VALUES		256
+
+/**
+ * @struct octet_set
+ * @brief Values one octet of a target expression can take.
+ */
+struct octet_set {
+    uint8_t vals[OCTET_VALUES];        /**< Distinct values, ascending */
+    uint16_t len;                      /**< Number of values */
+    uint8_t run_first[OCTET_VALUES];   /**< Start of each run of values */
+    uint8_t run_last[OCTET_VALUES];    /**< End of each run of values */
+    uint16_t run_cnt;                  /**< Number of runs */
+    uint16_t covered;                  /**< Values inside the runs */
+};
+
+/**
+ * @struct target_expr
+ * @brief Parsed target expression (e.g. "10.0-255.1-254.1,5,9").
+ *
+ * Each octet is a comma separated list of values, ranges ("1-254")
+ * and wildcards ("*"). An optional "/bitmask" turns every address
+ * into the network that holds it.
+ */
+struct target_expr {
+    struct octet_set oct[OCTET_COUNT]; /**< Octet values */
+    uint8_t bitmask;                   /**< Mask length, 32 without '/' */
+    int8_t last_var;                   /**< Last octet not taking all values,
+                                            -1 if the whole space matches */
+};
+
+/**
+ * @struct target_iter
+ * @brief Lazy walk over a target expression in address order.
+ *
+ * @warning Initialize with target_iter_init() before using.
+ */
+struct target_iter {
+    const struct target_expr *expr;    /**< Expression */
+    uint16_t pos[OCTET_COUNT];         /**< Odometer of value/run indices */
+    uint8_t done;                      /**< All intervals were produced */
+    uint8_t have_cur;                  /**< cur..end is pending */
+    uint64_t cur;                      /**< Next address to produce */
+    uint64_t end;                      /**< End of the pending interval */
+    uint8_t have_next;                 /**< A look-ahead interval is kept */
+    uint32_t next_first;               /**< Look-ahead interval start */
+    uint32_t next_last;                /**< Look-ahead interval end */
+};
+
+/**
+ * @brief Parse a target expression.
+ * @param expr Expression to fill.
+ * @param str Text such as "192.168.*.0/28".
+ * @return 0 on success, -1 on error.
+ */
+int target_parse(struct target_expr *expr, const char *str);
+
+/**
+ * @brief Number of addresses the expression covers.
+ *
+ * Computed from the octet sets, nothing is expanded.
+ *
+ * @param expr Parsed expression.
+ * @return Address count, up to 2^32.
+ */
+uint64_t target_count(const struct target_expr *expr);
+
+/**
+ * @brief Start a walk over the expression.
+ * @param it Iterator.
+ * @param expr Parsed expression, must outlive the iterator.
+ */
+void target_iter_init(struct target_iter *it, const struct target_expr *expr);
+
+/**
+ * @brief Get the next contiguous interval of the expression.
+ * @param it Iterator.
+ * @param[out] first First address.
+ * @param[out] last Last address.
+ * @return 1 if an interval was produced, 0 at the end.
+ *
+ * @note Consecutive intervals may be adjacent.
+ */
+int target_next_interval(struct target_iter *it, uint32_t *first, uint32_t *last);
+
+/**
+ * @brief Get the next address of the expression.
+ * @param it Iterator.
+ * @param[out] addr Address.
+ * @return 1 if an address was produced, 0 at the end.
+ */
+int target_next_addr(struct target_iter *it, uint32_t *addr);
+
+/**
+ * @brief Get the next prefix of the minimal CIDR cover.
+ * @param it Iterator.
+ * @param[out] pfx Prefix.
+ * @return 1 if a prefix was produced, 0 at the end.
+ *
+ * @warning Do not mix with target_next_addr() on the same iterator.
+ */
+int target_next_cidr(struct target_iter *it, struct prefix *pfx);
+
+/**
+ * @brief Expand target expressions to addresses or CIDR blocks.
+ *
+ * Every argument that is not an option is an expression.
+ *
+ * Options:
+ * 	--cidr	 print the minimal CIDR cover instead of addresses
+ * 	--count	 print the number of addresses only
+ *
+ * @param argc Number of arguments after the mode option.
+ * @param argv Arguments after the mode option.
+ *
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on error.
+ */
+int target_start(int argc, char **argv);
+
+#endif /* TARGET_H_SENTRY */
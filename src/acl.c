@@ -0,0 +1,385 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "prefix_list.h"
+#include "sort.h"
+#include "acl.h"
+
+#define EMPTY_SLOT			ACL_NO_MATCH
+
+/**
+ * @brief Slot an address starts probing at.
+ * @param key Address with the class wildcard bits cleared.
+ * @param mask Slots - 1.
+ * @return Slot.
+ */
+static inline uint32_t slot_of(uint32_t key, uint32_t mask)
+{
+	return (uint32_t) (((uint64_t) key * 0x9e3779b97f4a7c15ULL) >> 32) & mask;
+}
+
+/**
+ * @brief Lowest entry of a class with the address.
+ * @param cls Class.
+ * @param key Address with the class wildcard bits cleared.
+ * @return Entry index, or ACL_NO_MATCH.
+ */
+static inline uint32_t class_find(const struct acl_class *cls, uint32_t key)
+{
+	uint32_t s = slot_of(key, cls->mask);
+
+	/* Empty slots hold ACL_NO_MATCH, so one test ends both outcomes and
+	   at a quarter load it almost always passes at the first slot */
+	while ((cls->slots[s][0] != key) & (cls->slots[s][1] != EMPTY_SLOT)) {
+		s = (s + 1) & cls->mask;
+	}
+
+	return cls->slots[s][1];
+}
+
+/**
+ * @brief Free the classes built by acl_compile().
+ * @param acl Access list.
+ */
+static void free_classes(struct acl *acl);
+
+/**
+ * @brief Check whether entry a matches every address of entry b.
+ * @param a Entry.
+ * @param b Entry.
+ * @return 1 if it does, 0 otherwise.
+ */
+static int covers(const struct acl_entry *a, const struct acl_entry *b);
+
+/**
+ * @brief Check whether two entries match a common address.
+ * @param a Entry.
+ * @param b Entry.
+ * @return 1 if they do, 0 otherwise.
+ */
+static int overlaps(const struct acl_entry *a, const struct acl_entry *b);
+
+/**
+ * @brief Parse an action keyword.
+ * @param tok Token.
+ * @return acl_permit, acl_deny, or -1 if the token is neither.
+ */
+static int parse_action(const char *tok);
+
+int acl_add(struct acl *acl, uint32_t addr, uint32_t wildcard, enum acl_action action)
+{
+	struct acl_entry *new_entries = NULL;
+	size_t new_cap;
+
+	if (!acl || (action != acl_permit && action != acl_deny)) { return -1; }
+	if (acl->len >= ACL_NO_MATCH) { return -1; }
+
+	if (acl->len == acl->cap) {
+		new_cap = acl->cap ? acl->cap * 2 : 64;
+		new_entries = realloc(acl->entries, new_cap * sizeof(struct acl_entry));
+		if (!new_entries) { return -1; }
+		acl->entries = new_entries;
+		acl->cap = new_cap;
+	}
+
+	acl->entries[acl->len].addr = addr & ~wildcard;
+	acl->entries[acl->len].wildcard = wildcard;
+	acl->entries[acl->len].action = action;
+	acl->len++;
+
+	return 0;
+}
+
+int acl_read(struct acl *acl, FILE *fp)
+{
+	struct token_reader rd;
+	struct prefix pfx;
+	uint32_t addr, wildcard;
+	char *tok = NULL;
+	int action;
+
+	if (!acl || !fp) { return -1; }
+
+	if (token_reader_init(&rd, fp) == -1) { return -1; }
+
+	tok = token_reader_next(&rd);
+	while (tok) {
+		action = parse_action(tok);
+		if (action == -1) { goto handle_error; }
+
+		tok = token_reader_next(&rd);
+		if (!tok) { goto handle_error; }
+
+		if (strcmp(tok, "any") == 0) {
+			addr = 0;
+			wildcard = UINT32_MAX;
+			tok = token_reader_next(&rd);
+		}
+		else if (strcmp(tok, "host") == 0) {
+			tok = token_reader_next(&rd);
+			if (!tok || strchr(tok, '/') || parse_prefix(tok, &pfx) == -1) { goto handle_error; }
+			addr = pfx.addr;
+			wildcard = 0;
+			tok = token_reader_next(&rd);
+		}
+		else if (strchr(tok, '/')) {
+			if (parse_prefix(tok, &pfx) == -1) { goto handle_error; }
+			addr = pfx.addr;
+			wildcard = ~prefix_netmask(pfx.bitmask);
+			tok = token_reader_next(&rd);
+		}
+		else {
+			if (parse_prefix(tok, &pfx) == -1) { goto handle_error; }
+			addr = pfx.addr;
+			wildcard = 0;
+
+			/* The wildcard is optional, the next entry starts with an action */
+			tok = token_reader_next(&rd);
+			if (tok && parse_action(tok) == -1) {
+				if (strchr(tok, '/') || parse_prefix(tok, &pfx) == -1) { goto handle_error; }
+				wildcard = pfx.addr;
+				tok = token_reader_next(&rd);
+			}
+		}
+
+		if (acl_add(acl, addr, wildcard, action) == -1) { goto handle_error; }
+	}
+
+	token_reader_free(&rd);
+	return 0;
+
+	handle_error:
+		token_reader_free(&rd);
+		return -1;
+}
+
+int acl_compile(struct acl *acl)
+{
+	struct acl_class *cls = NULL;
+	struct acl_class *sorted = NULL;
+	uint64_t *keys = NULL;
+	uint32_t wildcard, key, entry, s;
+	size_t start, count, size;
+
+	if (!acl) { return -1; }
+
+	free_classes(acl);
+	if (!acl->len) { return 0; }
+
+	/* Sorting (wildcard << 32 | entry) groups classes, lowest entry first */
+	keys = malloc(acl->len * sizeof(uint64_t));
+	if (!keys) { return -1; }
+
+	for (size_t i = 0; i < acl->len; i++) {
+		keys[i] = (uint64_t) acl->entries[i].wildcard << 32 | i;
+	}
+	if (sort_u64(keys, acl->len) == -1) { goto handle_error; }
+
+	for (size_t i = 0; i < acl->len; i++) {
+		if (!i || keys[i] >> 32 != keys[i - 1] >> 32) { acl->class_count++; }
+	}
+
+	acl->classes = calloc(acl->class_count, sizeof(struct acl_class));
+	if (!acl->classes) { goto handle_error; }
+
+	cls = acl->classes;
+	for (start = 0; start < acl->len; start += count, cls++) {
+		wildcard = keys[start] >> 32;
+		for (count = 1; start + count < acl->len && keys[start + count] >> 32 == wildcard; count++);
+
+		/* At most a quarter full, probes end at an empty slot */
+		for (size = 4; size < 4 * count; size *= 2);
+
+		cls->care = ~wildcard;
+		cls->first = (uint32_t) keys[start];
+		cls->mask = size - 1;
+		cls->slots = malloc(size * sizeof(*cls->slots));
+		if (!cls->slots) { goto handle_error; }
+		for (size_t j = 0; j < size; j++) { cls->slots[j][1] = EMPTY_SLOT; }
+
+		/* Entries come in ascending order, an address keeps its first one */
+		for (size_t j = start; j < start + count; j++) {
+			entry = (uint32_t) keys[j];
+			key = acl->entries[entry].addr;
+
+			for (s = slot_of(key, cls->mask); cls->slots[s][1] != EMPTY_SLOT &&
+				 cls->slots[s][0] != key; s = (s + 1) & cls->mask);
+
+			if (cls->slots[s][1] == EMPTY_SLOT) {
+				cls->slots[s][0] = key;
+				cls->slots[s][1] = entry;
+			}
+		}
+	}
+
+	/* Order classes by their lowest entry */
+	for (size_t c = 0; c < acl->class_count; c++) {
+		keys[c] = (uint64_t) acl->classes[c].first << 32 | c;
+	}
+	if (sort_u64(keys, acl->class_count) == -1) { goto handle_error; }
+
+	sorted = malloc(acl->class_count * sizeof(struct acl_class));
+	if (!sorted) { goto handle_error; }
+	for (size_t c = 0; c < acl->class_count; c++) {
+		sorted[c] = acl->classes[(uint32_t) keys[c]];
+	}
+
+	free(acl->classes);
+	acl->classes = sorted;
+	free(keys);
+
+	return 0;
+
+	handle_error:
+		free(keys);
+		free_classes(acl);
+		return -1;
+}
+
+uint32_t acl_match(const struct acl *acl, uint32_t addr)
+{
+	const struct acl_class *cls = acl->classes;
+	const struct acl_class *end = acl->classes + acl->class_count;
+	uint32_t best = ACL_NO_MATCH;
+	uint32_t entry;
+
+	/* A class can only win with an entry below the best so far */
+	for (; cls < end && cls->first < best; cls++) {
+		entry = class_find(cls, addr & cls->care);
+		best = entry < best ? entry : best;
+	}
+
+	return best;
+}
+
+int acl_check(const struct acl *acl, struct acl_issue **issues, size_t *len)
+{
+	const struct acl_entry *e = NULL;
+	const struct acl_class *cls = NULL;
+	struct acl_issue *new_issues = NULL;
+	size_t cap = 0;
+	uint32_t by, entry;
+	uint8_t kind;
+
+	if (!acl || !issues || !len) { return -1; }
+
+	*issues = NULL;
+	*len = 0;
+
+	for (uint32_t j = 0; j < acl->len; j++) {
+		e = &acl->entries[j];
+		by = ACL_NO_MATCH;
+
+		/* First earlier entry covering it: a class whose wildcard holds
+		   this one, probed with this address */
+		for (size_t c = 0; c < acl->class_count; c++) {
+			cls = &acl->classes[c];
+			if (cls->first >= by || cls->first >= j) { break; }
+			if (cls->care & e->wildcard) { continue; }
+
+			entry = class_find(cls, e->addr & cls->care);
+			if (entry < j && entry < by) { by = entry; }
+		}
+
+		if (by != ACL_NO_MATCH) {
+			kind = acl->entries[by].action == e->action ? acl_redundant : acl_shadowed;
+		}
+		else {
+			/* Later covering entry with the same action, nothing in between
+			   decides differently for any of its addresses */
+			for (uint32_t k = j + 1; k < acl->len; k++) {
+				if (!overlaps(e, &acl->entries[k])) { continue; }
+				if (acl->entries[k].action != e->action) { break; }
+				if (covers(&acl->entries[k], e)) {
+					by = k;
+					break;
+				}
+			}
+			kind = acl_redundant;
+		}
+
+		if (by == ACL_NO_MATCH) { continue; }
+
+		if (*len == cap) {
+			cap = cap ? cap * 2 : 16;
+			new_issues = realloc(*issues, cap * sizeof(struct acl_issue));
+			if (!new_issues) { goto handle_error; }
+			*issues = new_issues;
+		}
+
+		(*issues)[*len].entry = j;
+		(*issues)[*len].by = by;
+		(*issues)[*len].kind = kind;
+		(*len)++;
+	}
+
+	return 0;
+
+	handle_error:
+		free(*issues);
+		*issues = NULL;
+		*len = 0;
+		return -1;
+}
+
+void acl_free(struct acl *acl)
+{
+	if (!acl) { return; }
+
+	free_classes(acl);
+	free(acl->entries);
+	memset(acl, 0, sizeof(struct acl));
+
+	return;
+}
+
+static void free_classes(struct acl *acl)
+{
+	for (size_t c = 0; acl->classes && c < acl->class_count; c++) {
+		free(acl->classes[c].slots);
+	}
+
+	free(acl->classes);
+	acl->classes = NULL;
+	acl->class_count = 0;
+
+	return;
+}
+
+static int covers(const struct acl_entry *a, const struct acl_entry *b)
+{
+	return !(b->wildcard & ~a->wildcard) && !((a->addr ^ b->addr) & ~a->wildcard);
+}
+
+static int overlaps(const struct acl_entry *a, const struct acl_entry *b)
+{
+	return !((a->addr ^ b->addr) & ~a->wildcard & ~b->wildcard);
+}
+
+static int parse_action(const char *tok)
+{
+	if (strcmp(tok, "permit") == 0) { return acl_permit; }
+	if (strcmp(tok, "deny") == 0) { return acl_deny; }
+
+	return -1;
+}
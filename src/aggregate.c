@@ -0,0 +1,182 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+
+#include "fill_ipv4.h"
+#include "prefix_list.h"
+#include "format.h"
+#include "stats.h"
+#include "summary.h"
+#include "status.h"
+#include "aggregate.h"
+
+/**
+ * @brief Print one prefix of the cover.
+ * @param ctx Line marker, a string such as "+".
+ * @param added Ignored, the marker says it.
+ * @param addr Network address.
+ * @param bitmask Mask length.
+ */
+static void print_prefix(void *ctx, int added, uint32_t addr, uint8_t bitmask);
+
+/**
+ * @brief Print a change of the cover as "+" or "-" line.
+ * @param ctx Unused.
+ * @param added 1 for "+", 0 for "-".
+ * @param addr Network address.
+ * @param bitmask Mask length.
+ */
+static void print_delta(void *ctx, int added, uint32_t addr, uint8_t bitmask);
+
+/**
+ * @brief Run one command line.
+ * @param sm Summary.
+ * @param line Command, without the newline.
+ * @return 0 on success, -1 if the command is invalid or fails.
+ */
+static int run_command(struct summary *sm, char *line);
+
+int aggregate_start(int argc, char **argv)
+{
+	struct summary sm;
+	char *line = NULL;
+	size_t cap = 0;
+	ssize_t len;
+	uint64_t lineno = 0;
+	char text[64];
+	char bad[SUMMARY_ENTRY_MAX];
+	int mark = 0;
+	FILE *fp = NULL;
+	int res;
+	STATS_DECL(t);
+
+	for (int i = 0; i < argc; i++) {
+		if (strcmp(argv[i], "--mark") == 0) { mark = 1; }
+		else if (strncmp(argv[i], "--", 2) == 0) { return EXIT_FAILURE; }
+	}
+
+	if (summary_init(&sm) == -1) { return EXIT_INPUT; }
+
+	for (int i = 0; i < argc; i++) {
+		if (strncmp(argv[i], "--", 2) == 0) { continue; }
+
+		fp = fopen(argv[i], "r");
+		if (!fp) {
+			fprintf(stderr, "ipc: %s: %s\n", argv[i], strerror(errno));
+			goto handle_error;
+		}
+		res = summary_read(&sm, fp, bad, sizeof(bad));
+		fclose(fp);
+		if (res == SUMMARY_INVALID) { fprintf(stderr, "ipc: invalid entry '%s'\n", bad); }
+		if (res != 0) { goto handle_error; }
+	}
+	STATS_LAP(t, stage_parse);
+
+	summary_walk(&sm, print_prefix, "+");
+	if (mark) { puts("."); }
+	if (fflush(stdout) == EOF) { goto handle_error; }
+	STATS_LAP(t, stage_output);
+
+	while ((len = getline(&line, &cap, stdin)) != -1) {
+		lineno++;
+		if (len && line[len - 1] == '\n') { line[len - 1] = '\0'; }
+
+		/* run_command cuts the line up, the message shows it whole */
+		snprintf(text, sizeof(text), "%s", line);
+
+		if (run_command(&sm, line) == -1) {
+			fprintf(stderr, "ipc: line %" PRIu64 ": invalid command '%s'\n", lineno, text);
+			STATS_ERRORS(1);
+		}
+		STATS_ITEMS(1);
+
+		if (mark) { puts("."); }
+		if (fflush(stdout) == EOF) { goto handle_error; }
+	}
+	STATS_LAP(t, stage_derive);
+
+	free(line);
+	summary_free(&sm);
+	return EXIT_SUCCESS;
+
+	handle_error:
+		free(line);
+		summary_free(&sm);
+		return EXIT_INPUT;
+}
+
+static int run_command(struct summary *sm, char *line)
+{
+	struct prefix pfx;
+	char *cmd = NULL;
+	char *arg = NULL;
+	char *save = NULL;
+
+	/* Comments and blank lines do nothing */
+	line[strcspn(line, "#")] = '\0';
+
+	cmd = strtok_r(line, " \t\r", &save);
+	if (!cmd) { return 0; }
+	arg = strtok_r(NULL, " \t\r", &save);
+	if (strtok_r(NULL, " \t\r", &save)) { return -1; }
+
+	if (strcmp(cmd, "dump") == 0) {
+		if (arg) { return -1; }
+		summary_walk(sm, print_prefix, "=");
+		return 0;
+	}
+
+	if (!arg || parse_prefix(arg, &pfx) == -1) { return -1; }
+
+	if (strcmp(cmd, "add") == 0 || strcmp(cmd, "+") == 0) {
+		return summary_add(sm, pfx.addr, pfx.bitmask, print_delta, NULL);
+	}
+	if (strcmp(cmd, "del") == 0 || strcmp(cmd, "-") == 0) {
+		return summary_remove(sm, pfx.addr, pfx.bitmask, print_delta, NULL);
+	}
+
+	return -1;
+}
+
+static void print_prefix(void *ctx, int added, uint32_t addr, uint8_t bitmask)
+{
+	char buf[ADDR_STR_LEN + 1];
+
+	(void) added;
+
+	*format_addr_plain(buf, addr) = '\0';
+	printf("%s %s/%d\n", (const char *) ctx, buf, bitmask);
+
+	return;
+}
+
+static void print_delta(void *ctx, int added, uint32_t addr, uint8_t bitmask)
+{
+	print_prefix(added ? "+" : "-", added, addr, bitmask);
+
+	(void) ctx;
+
+	return;
+}
@@ -0,0 +1,49 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ipv6.h"
+#include "stats.h"
+#include "analysis6.h"
+
+int analysis6_start(int argc, char **argv)
+{
+	struct ipv6 ip;
+	char buf[IPV6_REPORT_MAX];
+	int len;
+	STATS_DECL(t);
+
+	if (argc != 1 || !argv) { return EXIT_FAILURE; }
+
+	if (ipv6_analyze(&ip, argv[0]) == -1) { return EXIT_FAILURE; }
+	STATS_LAP(t, stage_derive);
+
+	len = ipv6_format_analysis(&ip, buf, sizeof(buf));
+	if (len < 0) { return EXIT_FAILURE; }
+
+	fwrite(buf, 1, len, stdout);
+
+	STATS_LAP(t, stage_output);
+	STATS_ITEMS(1);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,400 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+
+#include "ipv4_t.h"
+#include "fill_ipv4.h"
+#include "ipc.h"
+#include "prefix_list.h"
+#include "format.h"
+#include "stats.h"
+#include "status.h"
+#include "batch.h"
+
+#define CACHE_DEFAULT		8192
+#define CACHE_PROBES		8		/* Slots looked at before evicting */
+#define CACHE_KEY_MAX		48		/* Longer raw keys bypass the cache */
+
+/**
+ * @enum cache_key
+ * @brief What identifies a cached report.
+ */
+enum cache_key { key_raw, key_parsed };
+
+/**
+ * @struct cache_slot
+ * @brief Cached analysis report.
+ */
+struct cache_slot {
+    uint64_t hash;                  /**< Key hash, 0 for a free slot */
+    uint16_t key_len;               /**< Key length */
+    uint16_t rec_len;               /**< Report length */
+    char key[CACHE_KEY_MAX];        /**< Key bytes */
+    char rec[IPC_REPORT_MAX];       /**< Formatted report */
+};
+
+/**
+ * @struct report_cache
+ * @brief Bounded open-addressing table of reports.
+ *
+ * Linear probing over at most CACHE_PROBES slots. When they are all
+ * taken, the home slot of the key is overwritten, so slots never
+ * become free again and no tombstones are needed.
+ */
+struct report_cache {
+    struct cache_slot *slots;       /**< Table */
+    size_t mask;                    /**< Number of slots minus one */
+    uint64_t hits;                  /**< Reports served from the table */
+    uint64_t misses;                /**< Reports built from scratch */
+    uint64_t evictions;             /**< Reports overwritten */
+};
+
+/**
+ * @struct batch_opts
+ * @brief Options of the batch mode.
+ */
+struct batch_opts {
+    size_t cache_size;              /**< Cache entries, 0 disables */
+    enum cache_key key;             /**< Cache key kind */
+};
+
+/**
+ * @brief Parse the options of the batch mode.
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ * @param[out] opts Parsed options.
+ * @return 0 on success, -1 on error.
+ */
+static int process_batch_args(int argc, char **argv, struct batch_opts *opts);
+
+/**
+ * @brief Analyze all entries of a stream.
+ * @param fp Source stream.
+ * @param cache Report cache, or NULL.
+ * @param key Cache key kind.
+ * @param ob Output buffer.
+ * @param[out] errors Incremented for every invalid entry.
+ * @return 0 on success, -1 on error.
+ */
+static int process_stream(FILE *fp, struct report_cache *cache, enum cache_key key,
+                          struct outbuf *ob, uint64_t *errors);
+
+/**
+ * @brief Build the report of one entry.
+ * @param tok Entry in CIDR notation.
+ * @param rec Destination, IPC_REPORT_MAX bytes.
+ * @return Report length, or -1 for an invalid entry.
+ */
+static int build_report(const char *tok, char *rec);
+
+/**
+ * @brief Allocate the cache.
+ * @param cache Cache to set up.
+ * @param entries Requested entries, rounded up to a power of two.
+ * @return 0 on success, -1 on error.
+ */
+static int cache_init(struct report_cache *cache, size_t entries);
+
+/**
+ * @brief Find a cached report.
+ * @param cache Cache.
+ * @param hash Key hash.
+ * @param key Key bytes.
+ * @param key_len Key length.
+ * @return Slot with the report, or NULL.
+ */
+static struct cache_slot *cache_find(struct report_cache *cache, uint64_t hash,
+                                     const char *key, size_t key_len);
+
+/**
+ * @brief Pick the slot for a new report.
+ * @param cache Cache.
+ * @param hash Key hash.
+ * @return Free slot, or the home slot of the key if the window is full.
+ */
+static struct cache_slot *cache_claim(struct report_cache *cache, uint64_t hash);
+
+/**
+ * @brief FNV-1a hash of a byte string.
+ * @param data Bytes.
+ * @param len Number of bytes.
+ * @return Hash, never 0.
+ */
+static uint64_t hash_bytes(const char *data, size_t len);
+
+int batch_start(int argc, char **argv)
+{
+	struct batch_opts opts;
+	struct report_cache cache;
+	struct report_cache *cachep = NULL;
+	struct outbuf *ob = NULL;
+	uint64_t errors = 0;
+	int file_cnt = 0;
+	FILE *fp = NULL;
+	int res = 0;
+
+	memset(&cache, 0, sizeof(struct report_cache));
+
+	if (process_batch_args(argc, argv, &opts) == -1) { return EXIT_FAILURE; }
+
+	if (opts.cache_size) {
+		if (cache_init(&cache, opts.cache_size) == -1) { return EXIT_INPUT; }
+		cachep = &cache;
+	}
+
+	ob = malloc(sizeof(struct outbuf));
+	if (!ob) { goto handle_error; }
+	outbuf_init(ob, stdout);
+
+	for (int i = 0; i < argc && res == 0; i++) {
+		if (strcmp(argv[i], "--cache") == 0 || strcmp(argv[i], "--key") == 0) {
+			i++;
+			continue;
+		}
+
+		file_cnt++;
+		fp = fopen(argv[i], "r");
+		if (!fp) {
+			fprintf(stderr, "ipc: %s: %s\n", argv[i], strerror(errno));
+			goto handle_error;
+		}
+		res = process_stream(fp, cachep, opts.key, ob, &errors);
+		fclose(fp);
+	}
+
+	if (!file_cnt) { res = process_stream(stdin, cachep, opts.key, ob, &errors); }
+
+	if (outbuf_flush(ob) == -1) { res = -1; }
+
+	if (cachep) {
+		fprintf(stderr, "%-15s%" PRIu64 "\n", "Hits", cache.hits);
+		fprintf(stderr, "%-15s%" PRIu64 "\n", "Misses", cache.misses);
+	}
+	if (errors) { fprintf(stderr, "%-15s%" PRIu64 "\n", "Invalid", errors); }
+
+	free(ob);
+	free(cache.slots);
+
+	return (res == -1 || errors) ? EXIT_INPUT : EXIT_SUCCESS;
+
+	handle_error:
+		free(ob);
+		free(cache.slots);
+		return EXIT_INPUT;
+}
+
+static int process_batch_args(int argc, char **argv, struct batch_opts *opts)
+{
+	unsigned long long val;
+	char *endptr = NULL;
+
+	if (!argv || !opts) { return -1; }
+
+	opts->cache_size = CACHE_DEFAULT;
+	opts->key = key_raw;
+
+	for (int i = 0; i < argc; i++) {
+		if (strcmp(argv[i], "--cache") == 0) {
+			if (i + 1 >= argc) { return -1; }
+			if (argv[i + 1][0] < '0' || argv[i + 1][0] > '9') { return -1; }
+			errno = 0;
+			val = strtoull(argv[++i], &endptr, 10);
+			if (errno == ERANGE || *endptr != '\0') { return -1; }
+			if (val > ((size_t) 1 << 24)) { return -1; }
+			opts->cache_size = (size_t) val;
+		}
+		else if (strcmp(argv[i], "--key") == 0) {
+			if (i + 1 >= argc) { return -1; }
+			i++;
+			if (strcmp(argv[i], "raw") == 0) { opts->key = key_raw; }
+			else if (strcmp(argv[i], "parsed") == 0) { opts->key = key_parsed; }
+			else { return -1; }
+		}
+		else if (strncmp(argv[i], "--", 2) == 0) { return -1; }
+	}
+
+	return 0;
+}
+
+static int process_stream(FILE *fp, struct report_cache *cache, enum cache_key key,
+                          struct outbuf *ob, uint64_t *errors)
+{
+	struct token_reader rd;
+	struct cache_slot *slot = NULL;
+	char rec[IPC_REPORT_MAX];
+	char key_buf[CACHE_KEY_MAX];
+	const char *key_ptr = NULL;
+	size_t key_len;
+	uint64_t hash = 0;
+	ipv4_t ip;
+	char *tok = NULL;
+	int len;
+	STATS_DECL(entry);
+	STATS_DECL(t);
+
+	if (token_reader_init(&rd, fp) == -1) { return -1; }
+
+	while (!ob->error && (tok = token_reader_next(&rd))) {
+		STATS_MARK(entry);
+		STATS_MARK(t);
+		STATS_ITEMS(1);
+		key_len = 0;
+
+		if (cache && key == key_raw) {
+			key_ptr = tok;
+			key_len = strlen(tok);
+		}
+		else if (cache && key == key_parsed) {
+			memset(&ip, 0, sizeof(ipv4_t));
+			if (fill_addr(&ip, tok) && fill_bitmask(&ip, tok)) {
+				memcpy(key_buf, ip.addr, OCTET_COUNT);
+				key_buf[OCTET_COUNT] = ip.bitmask;
+				key_ptr = key_buf;
+				key_len = OCTET_COUNT + 1;
+			}
+		}
+
+		if (key_len && key_len <= CACHE_KEY_MAX) {
+			hash = hash_bytes(key_ptr, key_len);
+			slot = cache_find(cache, hash, key_ptr, key_len);
+			STATS_LAP(t, stage_parse);
+			if (slot) {
+				cache->hits++;
+				outbuf_write(ob, slot->rec, slot->rec_len);
+				outbuf_write(ob, "\n", 1);
+				STATS_LAP(t, stage_output);
+				STATS_LATENCY(hist_batch, entry);
+				continue;
+			}
+		}
+
+		/* build_report() times its own stages */
+		len = build_report(tok, rec);
+		STATS_MARK(t);
+		if (len < 0) {
+			fprintf(stderr, "ipc: invalid entry '%s'\n", tok);
+			(*errors)++;
+			STATS_ERRORS(1);
+			continue;
+		}
+
+		if (cache) { cache->misses++; }
+
+		if (key_len && key_len <= CACHE_KEY_MAX) {
+			slot = cache_claim(cache, hash);
+			if (slot->hash) { cache->evictions++; }
+			slot->hash = hash;
+			slot->key_len = key_len;
+			slot->rec_len = len;
+			memcpy(slot->key, key_ptr, key_len);
+			memcpy(slot->rec, rec, len);
+		}
+
+		outbuf_write(ob, rec, len);
+		outbuf_write(ob, "\n", 1);
+		STATS_LAP(t, stage_output);
+		STATS_LATENCY(hist_batch, entry);
+	}
+
+	token_reader_free(&rd);
+
+	return ob->error ? -1 : 0;
+}
+
+static int build_report(const char *tok, char *rec)
+{
+	ipv4_t ip;
+	int len;
+	STATS_DECL(t);
+
+	if (ipc_analyze(&ip, tok) == -1) { return -1; }
+	STATS_LAP(t, stage_derive);
+
+	len = ipc_format_analysis(&ip, rec, IPC_REPORT_MAX);
+	STATS_LAP(t, stage_output);
+
+	return len;
+}
+
+static int cache_init(struct report_cache *cache, size_t entries)
+{
+	size_t slots = 1;
+
+	while (slots < entries) { slots <<= 1; }
+
+	memset(cache, 0, sizeof(struct report_cache));
+
+	cache->slots = calloc(slots, sizeof(struct cache_slot));
+	if (!cache->slots) { return -1; }
+	cache->mask = slots - 1;
+
+	return 0;
+}
+
+static struct cache_slot *cache_find(struct report_cache *cache, uint64_t hash,
+                                     const char *key, size_t key_len)
+{
+	struct cache_slot *slot = NULL;
+	size_t idx = hash & cache->mask;
+
+	for (int i = 0; i < CACHE_PROBES; i++) {
+		slot = &cache->slots[(idx + i) & cache->mask];
+		if (!slot->hash) { return NULL; }
+		if (slot->hash == hash && slot->key_len == key_len &&
+			memcmp(slot->key, key, key_len) == 0) {
+			return slot;
+		}
+	}
+
+	return NULL;
+}
+
+static struct cache_slot *cache_claim(struct report_cache *cache, uint64_t hash)
+{
+	struct cache_slot *slot = NULL;
+	size_t idx = hash & cache->mask;
+
+	for (int i = 0; i < CACHE_PROBES; i++) {
+		slot = &cache->slots[(idx + i) & cache->mask];
+		if (!slot->hash) { return slot; }
+	}
+
+	return &cache->slots[idx];
+}
+
+static uint64_t hash_bytes(const char *data, size_t len)
+{
+	uint64_t hash = 0xcbf29ce484222325ULL;
+
+	for (size_t i = 0; i < len; i++) {
+		hash ^= (uint8_t) data[i];
+		hash *= 0x100000001b3ULL;
+	}
+
+	/* Spread the low bits used for the slot index */
+	hash ^= hash >> 32;
+
+	return hash ? hash : 1;
+}
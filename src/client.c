@@ -0,0 +1,365 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "sort.h"
+#include "status.h"
+#include "client.h"
+
+#define CLIENT_CHUNK		65536			/* Bytes moved by one read */
+#define BENCH_DEPTH			64				/* Default requests in flight */
+
+/**
+ * @struct client_opts
+ * @brief Options of the client mode.
+ */
+struct client_opts {
+    const char *path;               /**< Socket path */
+    char *request;                  /**< Request from the command line, or NULL */
+    uint64_t bench;                 /**< Benchmark requests, 0 to forward */
+    uint64_t depth;                 /**< Benchmark requests in flight */
+};
+
+/**
+ * @brief Parse the options of the client mode.
+ * @param argc Argument count.
+ * @param argv Argument vector, the socket path first.
+ * @param[out] opts Parsed options. opts->request must be freed.
+ * @return 0 on success, -1 on error.
+ */
+static int process_client_args(int argc, char **argv, struct client_opts *opts);
+
+/**
+ * @brief Connect to the server.
+ * @param path Socket path.
+ * @return Socket, or -1 on error.
+ */
+static int connect_server(const char *path);
+
+/**
+ * @brief Send the request, or stdin, and copy the responses to stdout.
+ * @param fd Socket.
+ * @param request Request line, or NULL to read stdin.
+ * @return 0 on success, -1 on error.
+ */
+static int forward(int fd, const char *request);
+
+/**
+ * @brief Send the request many times and print the timings.
+ * @param fd Socket.
+ * @param opts Options.
+ * @return 0 on success, -1 on error.
+ */
+static int bench(int fd, const struct client_opts *opts);
+
+/**
+ * @brief Monotonic clock.
+ * @return Nanoseconds.
+ */
+static uint64_t now_ns(void);
+
+int client_start(int argc, char **argv)
+{
+	struct client_opts opts;
+	int fd;
+	int res;
+
+	if (process_client_args(argc, argv, &opts) == -1) { return EXIT_FAILURE; }
+
+	fd = connect_server(opts.path);
+	if (fd == -1) {
+		fprintf(stderr, "ipc: %s: %s\n", opts.path, strerror(errno));
+		free(opts.request);
+		return EXIT_INPUT;
+	}
+
+	if (opts.bench) { res = bench(fd, &opts); }
+	else { res = forward(fd, opts.request); }
+
+	close(fd);
+	free(opts.request);
+
+	return res == -1 ? EXIT_INPUT : EXIT_SUCCESS;
+}
+
+static int process_client_args(int argc, char **argv, struct client_opts *opts)
+{
+	unsigned long long val;
+	char *endptr = NULL;
+	size_t len = 0;
+
+	if (!argv || !opts || argc < 1) { return -1; }
+
+	memset(opts, 0, sizeof(struct client_opts));
+	opts->path = argv[0];
+	opts->depth = BENCH_DEPTH;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--bench") == 0 || strcmp(argv[i], "--depth") == 0) {
+			if (i + 1 >= argc) { return -1; }
+			if (argv[i + 1][0] < '0' || argv[i + 1][0] > '9') { return -1; }
+			errno = 0;
+			val = strtoull(argv[i + 1], &endptr, 10);
+			if (errno == ERANGE || *endptr != '\0' || !val) { return -1; }
+			if (val > ((uint64_t) 1 << 32)) { return -1; }
+			if (argv[i][2] == 'b') { opts->bench = val; }
+			else { opts->depth = val; }
+			i++;
+		}
+		else { len += strlen(argv[i]) + 1; }
+	}
+
+	if (!len) { return opts->bench ? -1 : 0; }
+
+	/* The remaining words make up one request line */
+	opts->request = calloc(len + 1, 1);
+	if (!opts->request) { return -1; }
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--bench") == 0 || strcmp(argv[i], "--depth") == 0) {
+			i++;
+			continue;
+		}
+		strcat(opts->request, argv[i]);
+		strcat(opts->request, " ");
+	}
+	opts->request[len - 1] = '\n';
+
+	return 0;
+}
+
+static int connect_server(const char *path)
+{
+	struct sockaddr_un addr;
+	int fd;
+
+	if (strlen(path) >= sizeof(addr.sun_path)) {
+		errno = ENAMETOOLONG;
+		return -1;
+	}
+
+	memset(&addr, 0, sizeof(struct sockaddr_un));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, path);
+
+	fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (fd == -1) { return -1; }
+
+	if (connect(fd, (struct sockaddr *) &addr, sizeof(struct sockaddr_un)) == -1) {
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+static int forward(int fd, const char *request)
+{
+	struct pollfd pfd[2];
+	char *in = NULL;
+	char *out = NULL;
+	size_t in_len = 0, in_pos = 0;
+	int in_eof = request != NULL;
+	int wr_shut = 0;
+	ssize_t got;
+
+	in = malloc(CLIENT_CHUNK);
+	out = malloc(CLIENT_CHUNK);
+	if (!in || !out) { goto handle_error; }
+
+	if (request) {
+		in_len = strlen(request);
+		if (in_len > CLIENT_CHUNK) { goto handle_error; }
+		memcpy(in, request, in_len);
+	}
+
+	/*
+	 * Sending and receiving are interleaved: a client that sends
+	 * everything first stalls once the server stops reading to let
+	 * its own output drain.
+	 */
+	for (;;) {
+		if (in_eof && in_pos == in_len && !wr_shut) {
+			shutdown(fd, SHUT_WR);
+			wr_shut = 1;
+		}
+
+		pfd[0].fd = fd;
+		pfd[0].events = POLLIN | (in_pos < in_len ? POLLOUT : 0);
+		pfd[1].fd = (in_eof || in_pos < in_len) ? -1 : STDIN_FILENO;
+		pfd[1].events = POLLIN;
+
+		if (poll(pfd, 2, -1) == -1) {
+			if (errno == EINTR) { continue; }
+			goto handle_error;
+		}
+
+		if (pfd[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+			got = recv(fd, out, CLIENT_CHUNK, MSG_DONTWAIT);
+			if (got == 0) { break; }
+			if (got > 0) { fwrite(out, 1, got, stdout); }
+			else if (errno != EAGAIN && errno != EINTR) { goto handle_error; }
+		}
+
+		if (pfd[0].revents & POLLOUT) {
+			got = send(fd, in + in_pos, in_len - in_pos, MSG_DONTWAIT | MSG_NOSIGNAL);
+			if (got > 0) { in_pos += got; }
+			else if (errno != EAGAIN && errno != EINTR) { goto handle_error; }
+		}
+
+		if (pfd[1].revents & (POLLIN | POLLHUP)) {
+			got = read(STDIN_FILENO, in, CLIENT_CHUNK);
+			if (got <= 0) { in_eof = 1; }
+			else {
+				in_len = got;
+				in_pos = 0;
+			}
+		}
+	}
+
+	free(in);
+	free(out);
+
+	return fflush(stdout) == EOF ? -1 : 0;
+
+	handle_error:
+		fprintf(stderr, "ipc: %s\n", strerror(errno));
+		free(in);
+		free(out);
+		return -1;
+}
+
+static int bench(int fd, const struct client_opts *opts)
+{
+	static const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+	static const char *const names[] = { "p50 (us)", "p90 (us)", "p99 (us)", "p99.9 (us)" };
+	struct pollfd pfd;
+	uint64_t *sent_at = NULL;
+	uint64_t *latency = NULL;
+	char *in = NULL;
+	char *out = NULL;
+	size_t req_len = strlen(opts->request);
+	size_t in_len = 0, in_pos = 0;
+	uint64_t queued = 0, done = 0;
+	uint64_t start, elapsed;
+	char prev = '\0';
+	ssize_t got;
+	size_t idx;
+
+	sent_at = malloc(opts->bench * sizeof(uint64_t));
+	latency = malloc(opts->bench * sizeof(uint64_t));
+	in = malloc(req_len * (opts->depth < opts->bench ? opts->depth : opts->bench));
+	out = malloc(CLIENT_CHUNK);
+	if (!sent_at || !latency || !in || !out) { goto handle_error; }
+
+	start = now_ns();
+
+	while (done < opts->bench) {
+		/* Top up the window once the previous batch is on the wire */
+		if (in_pos == in_len) {
+			in_len = in_pos = 0;
+			while (queued < opts->bench && queued - done < opts->depth) {
+				memcpy(in + in_len, opts->request, req_len);
+				in_len += req_len;
+				sent_at[queued++] = now_ns();
+			}
+		}
+
+		pfd.fd = fd;
+		pfd.events = POLLIN | (in_pos < in_len ? POLLOUT : 0);
+
+		if (poll(&pfd, 1, -1) == -1) {
+			if (errno == EINTR) { continue; }
+			goto handle_error;
+		}
+
+		if (pfd.revents & POLLOUT) {
+			got = send(fd, in + in_pos, in_len - in_pos, MSG_DONTWAIT | MSG_NOSIGNAL);
+			if (got > 0) { in_pos += got; }
+			else if (errno != EAGAIN && errno != EINTR) { goto handle_error; }
+		}
+
+		if (pfd.revents & (POLLIN | POLLHUP | POLLERR)) {
+			got = recv(fd, out, CLIENT_CHUNK, MSG_DONTWAIT);
+			if (got == 0) {
+				errno = ECONNRESET;
+				goto handle_error;
+			}
+			if (got < 0 && errno != EAGAIN && errno != EINTR) { goto handle_error; }
+
+			/* An empty line ends every response */
+			for (ssize_t i = 0; i < got; i++) {
+				if (out[i] == '\n' && prev == '\n' && done < opts->bench) {
+					latency[done] = now_ns() - sent_at[done];
+					done++;
+				}
+				prev = out[i];
+			}
+		}
+	}
+
+	elapsed = now_ns() - start;
+
+	if (sort_u64(latency, opts->bench) == -1) { goto handle_error; }
+
+	printf("%-15s%" PRIu64 "\n", "Requests", opts->bench);
+	printf("%-15s%" PRIu64 "\n", "Depth", opts->depth);
+	printf("%-15s%.3f\n", "Seconds", elapsed / 1e9);
+	printf("%-15s%.0f\n", "Requests/s", opts->bench / (elapsed / 1e9));
+	for (size_t q = 0; q < sizeof(quantiles) / sizeof(quantiles[0]); q++) {
+		idx = (size_t) (quantiles[q] * (opts->bench - 1));
+		printf("%-15s%.1f\n", names[q], latency[idx] / 1e3);
+	}
+	printf("%-15s%.1f\n", "max (us)", latency[opts->bench - 1] / 1e3);
+
+	free(sent_at);
+	free(latency);
+	free(in);
+	free(out);
+
+	return 0;
+
+	handle_error:
+		fprintf(stderr, "ipc: %s\n", strerror(errno));
+		free(sent_at);
+		free(latency);
+		free(in);
+		free(out);
+		return -1;
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
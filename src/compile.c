@@ -0,0 +1,258 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "prefix_list.h"
+#include "prefix_file.h"
+#include "format.h"
+#include "status.h"
+#include "compile.h"
+
+#define LINE_MAX_LEN		20				/* "255.255.255.255/32\n" */
+
+/**
+ * @brief Append the prefixes of a text stream.
+ * @param fp Source stream.
+ * @param[in,out] items Growing array.
+ * @param[in,out] len Prefixes in the array.
+ * @param[in,out] cap Capacity of the array.
+ * @return 0 on success, -1 on error.
+ */
+static int read_text(FILE *fp, struct prefix **items, size_t *len, size_t *cap);
+
+/**
+ * @brief Compile the inputs into a file.
+ * @param path Output file.
+ * @param with_table Store the lookup table.
+ * @param argc Number of inputs.
+ * @param argv Input paths.
+ * @return EXIT_SUCCESS on success, EXIT_INPUT on error (reported).
+ */
+static int compile_files(const char *path, int with_table, int argc, char **argv);
+
+/**
+ * @brief Check a compiled file.
+ * @param path File.
+ * @return EXIT_SUCCESS if intact, EXIT_INPUT otherwise (reported).
+ */
+static int verify_file(const char *path);
+
+/**
+ * @brief Print the prefixes of a compiled file.
+ * @param path File.
+ * @return EXIT_SUCCESS on success, EXIT_INPUT on error.
+ */
+static int dump_file(const char *path);
+
+int compile_start(int argc, char **argv)
+{
+	const char *out = NULL;
+	int with_table = 1;
+	int i;
+
+	if (!argv || argc < 2) { return EXIT_FAILURE; }
+
+	if (strcmp(argv[0], "--verify") == 0) { return argc == 2 ? verify_file(argv[1]) : EXIT_FAILURE; }
+	if (strcmp(argv[0], "--dump") == 0) { return argc == 2 ? dump_file(argv[1]) : EXIT_FAILURE; }
+
+	for (i = 0; i < argc && argv[i][0] == '-' && argv[i][1] != '\0'; i++) {
+		if (strcmp(argv[i], "--no-table") == 0) { with_table = 0; }
+		else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) { out = argv[++i]; }
+		else { return EXIT_FAILURE; }
+	}
+
+	if (!out) { return EXIT_FAILURE; }
+
+	return compile_files(out, with_table, argc - i, argv + i);
+}
+
+static int read_text(FILE *fp, struct prefix **items, size_t *len, size_t *cap)
+{
+	struct token_reader rd;
+	struct prefix *new_items = NULL;
+	char *tok = NULL;
+
+	if (token_reader_init(&rd, fp) == -1) { return -1; }
+
+	while ((tok = token_reader_next(&rd))) {
+		if (*len == *cap) {
+			*cap = *cap ? *cap * 2 : 4096;
+			new_items = realloc(*items, *cap * sizeof(struct prefix));
+			if (!new_items) { goto handle_error; }
+			*items = new_items;
+		}
+
+		if (parse_prefix(tok, &(*items)[*len]) == -1) {
+			fprintf(stderr, "ipc: invalid entry '%s'\n", tok);
+			goto handle_error;
+		}
+		(*len)++;
+	}
+
+	token_reader_free(&rd);
+	return 0;
+
+	handle_error:
+		token_reader_free(&rd);
+		return -1;
+}
+
+static int compile_files(const char *path, int with_table, int argc, char **argv)
+{
+	struct prefix *items = NULL;
+	size_t len = 0, cap = 0, total;
+	char *tmp = NULL;
+	FILE *fp = NULL;
+	long size;
+	int res;
+
+	if (!argc) {
+		if (read_text(stdin, &items, &len, &cap) == -1) { goto handle_error; }
+	}
+
+	for (int i = 0; i < argc; i++) {
+		fp = fopen(argv[i], "r");
+		if (!fp) {
+			fprintf(stderr, "ipc: %s: %s\n", argv[i], strerror(errno));
+			goto handle_error;
+		}
+
+		res = read_text(fp, &items, &len, &cap);
+		fclose(fp);
+		fp = NULL;
+		if (res == -1) { goto handle_error; }
+	}
+
+	tmp = malloc(strlen(path) + sizeof(".tmp"));
+	if (!tmp) { goto handle_error; }
+	sprintf(tmp, "%s.tmp", path);
+
+	fp = fopen(tmp, "wb");
+	if (!fp) {
+		fprintf(stderr, "ipc: %s: %s\n", tmp, strerror(errno));
+		goto handle_error;
+	}
+
+	total = len;
+	if (prefix_file_write(fp, items, &len, with_table) == -1) { goto handle_write_error; }
+
+	size = ftell(fp);
+	if (fclose(fp) == EOF) {
+		fp = NULL;
+		goto handle_write_error;
+	}
+	fp = NULL;
+
+	if (rename(tmp, path) == -1) { goto handle_write_error; }
+
+	fprintf(stderr, "ipc: %s: %zu prefixes (%zu duplicates), %ld bytes, %.2f bytes per prefix\n",
+			path, len, total - len, size, len ? (double) size / len : 0.0);
+
+	free(tmp);
+	free(items);
+	return EXIT_SUCCESS;
+
+	handle_write_error:
+		fprintf(stderr, "ipc: %s: %s\n", path, strerror(errno));
+		if (fp) { fclose(fp); }
+		fp = NULL;
+		remove(tmp);
+	handle_error:
+		if (fp) { fclose(fp); }
+		free(tmp);
+		free(items);
+		return EXIT_INPUT;
+}
+
+static int verify_file(const char *path)
+{
+	struct prefix_file pf;
+
+	if (prefix_file_open(&pf, path) == -1) {
+		fprintf(stderr, "ipc: %s: not a compiled prefix set or damaged header\n", path);
+		return EXIT_INPUT;
+	}
+
+	if (prefix_file_verify(&pf) == -1) {
+		fprintf(stderr, "ipc: %s: damaged\n", path);
+		prefix_file_close(&pf);
+		return EXIT_INPUT;
+	}
+
+	printf("%s: ok, %llu prefixes, %s\n", path, (unsigned long long) pf.hdr->count,
+		   pf.table.keys ? "lookup table" : "no lookup table");
+
+	prefix_file_close(&pf);
+	return EXIT_SUCCESS;
+}
+
+static int dump_file(const char *path)
+{
+	struct prefix buf[PREFIX_FILE_BLOCK];
+	struct prefix_file pf;
+	struct outbuf *ob = NULL;
+	char *dst = NULL;
+	char *p = NULL;
+	size_t n;
+	int res;
+
+	if (prefix_file_open(&pf, path) == -1) {
+		fprintf(stderr, "ipc: %s: not a compiled prefix set or damaged header\n", path);
+		return EXIT_INPUT;
+	}
+
+	ob = malloc(sizeof(struct outbuf));
+	if (!ob) { goto handle_error; }
+	outbuf_init(ob, stdout);
+
+	for (uint32_t b = 0; b < pf.hdr->block_count; b++) {
+		n = prefix_file_block(&pf, b, buf);
+		if (!n) {
+			fprintf(stderr, "ipc: %s: damaged\n", path);
+			outbuf_flush(ob);
+			goto handle_error;
+		}
+
+		for (size_t i = 0; i < n; i++) {
+			dst = outbuf_reserve(ob, LINE_MAX_LEN);
+			p = format_addr_plain(dst, buf[i].addr);
+			*p++ = '/';
+			if (buf[i].bitmask >= 10) { *p++ = '0' + buf[i].bitmask / 10; }
+			*p++ = '0' + buf[i].bitmask % 10;
+			*p++ = '\n';
+			ob->len += p - dst;
+		}
+	}
+
+	res = outbuf_flush(ob);
+
+	free(ob);
+	prefix_file_close(&pf);
+	return res == -1 ? EXIT_INPUT : EXIT_SUCCESS;
+
+	handle_error:
+		free(ob);
+		prefix_file_close(&pf);
+		return EXIT_INPUT;
+}
@@ -0,0 +1,290 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+
+#include "fill_ipv4.h"
+#include "prefix_list.h"
+#include "interval_set.h"
+#include "status.h"
+#include "coverage.h"
+
+/* Index of arbitrary ranges in the per-length statistics */
+#define RANGE_CLASS			(BITS_IN_IP + 1)
+#define CLASS_COUNT			(BITS_IN_IP + 2)
+
+/**
+ * @struct class_stat
+ * @brief Union of the entries of one prefix length.
+ */
+struct class_stat {
+    uint64_t entries;               /**< Entries in the class */
+    uint64_t addresses;             /**< Unique addresses covered */
+    uint32_t cur_first;             /**< Open block start */
+    uint32_t cur_last;              /**< Open block end */
+    uint8_t open;                   /**< Block is open */
+};
+
+/**
+ * @brief Get prefix length of an interval that is exactly one CIDR block.
+ * @param first First address.
+ * @param last Last address.
+ * @return Mask length, or RANGE_CLASS for any other interval.
+ */
+static int interval_class(uint32_t first, uint32_t last);
+
+/**
+ * @brief Collect per-length union sizes of a sorted set.
+ * @param set Sorted set.
+ * @param stats Array of CLASS_COUNT elements to fill.
+ */
+static void collect_by_length(const struct interval_set *set, struct class_stat *stats);
+
+/**
+ * @brief Prints union size per prefix length to stdout.
+ * @param stats Array of CLASS_COUNT elements.
+ */
+static void print_by_length(const struct class_stat *stats);
+
+/**
+ * @brief Prints one row of the per-parent table.
+ * @param idx Row number.
+ * @param base Parent network address.
+ * @param parent_len Parent mask length.
+ * @param count Unique addresses inside the parent.
+ */
+static void print_parent_row(size_t idx, uint32_t base, uint8_t parent_len, uint64_t count);
+
+/**
+ * @brief Prints union size per enclosing prefix to stdout.
+ * @param set Disjoint sorted blocks.
+ * @param parent_len Mask length of the enclosing prefixes.
+ */
+static void print_by_parent(const struct interval_set *set, uint8_t parent_len);
+
+/**
+ * @brief Append the entries of a stream, reporting an invalid one.
+ * @param set Set to append to.
+ * @param fp Source stream.
+ * @return 0 on success, -1 on error.
+ */
+static int read_entries(struct interval_set *set, FILE *fp);
+
+int coverage_start(int argc, char **argv)
+{
+	struct interval_set set;
+	struct class_stat stats[CLASS_COUNT];
+	uint8_t by_length = 0;
+	int parent_len = -1;
+	long val;
+	char *endptr = NULL;
+	int file_cnt = 0;
+	FILE *fp = NULL;
+	uint64_t entries, addresses;
+
+	if (argc < 0 || !argv) { return EXIT_FAILURE; }
+
+	memset(&set, 0, sizeof(struct interval_set));
+	memset(stats, 0, sizeof(stats));
+
+	for (int i = 0; i < argc; i++) {
+		if (strcmp(argv[i], "--by-length") == 0) { by_length = 1; }
+		else if (strcmp(argv[i], "--by-parent") == 0) {
+			if (i + 1 >= argc) { return EXIT_FAILURE; }
+			errno = 0;
+			val = strtol(argv[++i], &endptr, 10);
+			if (errno == ERANGE || *endptr != '\0') { return EXIT_FAILURE; }
+			if (val < 0 || val > BITS_IN_IP) { return EXIT_FAILURE; }
+			parent_len = (int) val;
+		}
+		else { file_cnt++; }
+	}
+
+	for (int i = 0; i < argc; i++) {
+		if (strcmp(argv[i], "--by-length") == 0) { continue; }
+		if (strcmp(argv[i], "--by-parent") == 0) { i++; continue; }
+
+		fp = fopen(argv[i], "r");
+		if (!fp) {
+			fprintf(stderr, "ipc: %s: %s\n", argv[i], strerror(errno));
+			goto handle_error;
+		}
+		if (read_entries(&set, fp) == -1) {
+			fclose(fp);
+			goto handle_error;
+		}
+		fclose(fp);
+	}
+
+	if (!file_cnt && read_entries(&set, stdin) == -1) { goto handle_error; }
+
+	if (interval_set_sort(&set) == -1) { goto handle_error; }
+
+	entries = set.len;
+	if (by_length) { collect_by_length(&set, stats); }
+	addresses = interval_set_merge(&set);
+
+	printf("%-15s%" PRIu64 "\n", "Entries", entries);
+	printf("%-15s%zu\n", "Blocks", set.len);
+	printf("%-15s%" PRIu64 "\n", "Addresses", addresses);
+
+	if (by_length) { print_by_length(stats); }
+	if (parent_len >= 0) { print_by_parent(&set, (uint8_t) parent_len); }
+
+	interval_set_free(&set);
+
+	return EXIT_SUCCESS;
+
+	handle_error:
+		interval_set_free(&set);
+		return EXIT_INPUT;
+}
+
+static int interval_class(uint32_t first, uint32_t last)
+{
+	uint64_t size = (uint64_t) last - first + 1;
+
+	if (size & (size - 1)) { return RANGE_CLASS; }
+	if (first & (uint32_t) (size - 1)) { return RANGE_CLASS; }
+
+	return BITS_IN_IP - __builtin_ctzll(size);
+}
+
+static void collect_by_length(const struct interval_set *set, struct class_stat *stats)
+{
+	uint32_t first, last;
+	struct class_stat *cls = NULL;
+
+	if (!set || !stats) { return; }
+
+	/* Entries of one class come in order too, merge them separately */
+	for (size_t i = 0; i < set->len; i++) {
+		first = set->keys[i] >> 32;
+		last = (uint32_t) set->keys[i];
+
+		cls = &stats[interval_class(first, last)];
+		cls->entries++;
+		if (cls->open && (uint64_t) first <= (uint64_t) cls->cur_last + 1) {
+			if (last > cls->cur_last) { cls->cur_last = last; }
+			continue;
+		}
+
+		if (cls->open) {
+			cls->addresses += (uint64_t) cls->cur_last - cls->cur_first + 1;
+		}
+		cls->cur_first = first;
+		cls->cur_last = last;
+		cls->open = 1;
+	}
+
+	for (int c = 0; c < CLASS_COUNT; c++) {
+		if (stats[c].open) {
+			stats[c].addresses += (uint64_t) stats[c].cur_last - stats[c].cur_first + 1;
+		}
+	}
+
+	return;
+}
+
+static void print_by_length(const struct class_stat *stats)
+{
+	if (!stats) { return; }
+
+	printf("\n%-5s%-20s%-20s\n", "LEN", "ENTRIES", "ADDRESSES");
+
+	for (int c = 0; c < CLASS_COUNT; c++) {
+		if (!stats[c].entries) { continue; }
+
+		if (c == RANGE_CLASS) { printf("%-5s", "-"); }
+		else { printf("/%-4d", c); }
+
+		printf("%-20" PRIu64 "%-20" PRIu64 "\n", stats[c].entries, stats[c].addresses);
+	}
+
+	return;
+}
+
+static void print_parent_row(size_t idx, uint32_t base, uint8_t parent_len, uint64_t count)
+{
+	uint8_t oct[OCTET_COUNT];
+
+	u32_to_addr(base, oct);
+
+	printf("%-5zu%03d.%03d.%03d.%03d/%-4d%-20" PRIu64 "%.2f%%\n", idx,
+			oct[0], oct[1], oct[2], oct[3], parent_len, count,
+			count * 100.0 / prefix_size(parent_len));
+
+	return;
+}
+
+static void print_by_parent(const struct interval_set *set, uint8_t parent_len)
+{
+	uint32_t pmask = prefix_netmask(parent_len);
+	uint32_t plast = ~pmask;
+	uint32_t first, last, base, seg_last, cur_base = 0;
+	uint64_t count = 0;
+	size_t rows = 0;
+
+	if (!set) { return; }
+
+	printf("\n%5s%-20s%-20s%-11s\n", "", "PARENT", "ADDRESSES", "USAGE");
+
+	for (size_t i = 0; i < set->len; i++) {
+		first = set->keys[i] >> 32;
+		last = (uint32_t) set->keys[i];
+
+		/* A block may span several parents */
+		for (;;) {
+			base = first & pmask;
+			seg_last = base | plast;
+			if (seg_last > last) { seg_last = last; }
+
+			if (count && base != cur_base) {
+				print_parent_row(rows++, cur_base, parent_len, count);
+				count = 0;
+			}
+			cur_base = base;
+			count += (uint64_t) seg_last - first + 1;
+
+			if (seg_last == last) { break; }
+			first = seg_last + 1;
+		}
+	}
+
+	if (count) { print_parent_row(rows, cur_base, parent_len, count); }
+
+	return;
+}
+
+static int read_entries(struct interval_set *set, FILE *fp)
+{
+	char bad[INTERVAL_SET_ENTRY_MAX];
+	int res;
+
+	res = interval_set_read(set, fp, bad, sizeof(bad));
+	if (res == INTERVAL_SET_INVALID) { fprintf(stderr, "ipc: invalid entry '%s'\n", bad); }
+	else if (res == INTERVAL_SET_DAMAGED) { fputs("ipc: damaged compiled prefix set\n", stderr); }
+
+	return res == 0 ? 0 : -1;
+}
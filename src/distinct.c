@@ -0,0 +1,786 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "fill_ipv4.h"
+#include "prefix_list.h"
+#include "prefix_table.h"
+#include "hll.h"
+#include "format.h"
+#include "stats.h"
+#include "status.h"
+#include "distinct.h"
+
+#define DISTINCT_BLOCK			(4 << 20)		/* Bytes parsed in one round */
+#define DISTINCT_THREADS_MAX	64
+#define DEFAULT_LENGTH			24
+#define TOKEN_MAX				32				/* Longer tokens are not addresses */
+#define MAP_MIN_SLOTS			1024
+#define ROW_MAX					96				/* Longest report row */
+#define SKETCH_FILE_MAGIC		"IPCHLL\r\n"	/* \r\n catches text-mode copies */
+#define SKETCH_FILE_VERSION		1
+
+/**
+ * @struct sketch_file_header
+ * @brief First bytes of saved sketches.
+ * Followed by count sketch_file_entry, each with its 2^precision
+ * registers. Numbers are in host byte order.
+ */
+struct sketch_file_header {
+    char magic[8];                  /**< SKETCH_FILE_MAGIC */
+    uint32_t version;               /**< SKETCH_FILE_VERSION */
+    uint32_t precision;             /**< Registers per sketch, log2 */
+    uint64_t count;                 /**< Sketches */
+    uint64_t reserved[2];           /**< Zero */
+};
+
+/**
+ * @struct sketch_file_entry
+ * @brief Bucket of a saved sketch.
+ */
+struct sketch_file_entry {
+    uint32_t addr;                  /**< Prefix network */
+    uint8_t bitmask;                /**< Prefix length */
+    uint8_t pad[3];                 /**< Zero */
+    uint64_t records;               /**< Lines counted */
+};
+
+/**
+ * @struct bucket_map
+ * @brief Sketch per prefix, found by open addressing.
+ */
+struct bucket_map {
+    uint32_t *slots;                /**< Bucket + 1, 0 if free */
+    size_t mask;                    /**< Slots - 1 */
+    uint64_t *keys;                 /**< Prefix as (network << 8 | bitmask) */
+    uint64_t *records;              /**< Lines per bucket */
+    uint8_t *regs;                  /**< 2^precision registers per bucket */
+    size_t len;                     /**< Buckets */
+    size_t cap;                     /**< Allocated buckets */
+    int precision;                  /**< Registers per bucket, log2 */
+};
+
+/**
+ * @struct bucketing
+ * @brief How a destination picks its bucket.
+ */
+struct bucketing {
+    const struct prefix_table *table; /**< Longest match, or NULL */
+    uint8_t length;                 /**< Fixed length without a table */
+    uint32_t netmask;               /**< Netmask of length */
+};
+
+/**
+ * @struct count_task
+ * @brief Lines counted by one thread, into its own sketches.
+ */
+struct count_task {
+    const char *begin;              /**< First byte */
+    const char *end;                /**< Past the last byte, after a '\n' */
+    const struct bucketing *bk;     /**< Bucket choice */
+    struct bucket_map map;          /**< Sketches of every round */
+    uint64_t unmatched;             /**< Destinations without a prefix */
+    int error;                      /**< Invalid entry or no memory */
+    char bad[TOKEN_MAX + 1];        /**< Invalid entry */
+    pthread_t tid;                  /**< Thread */
+};
+
+/**
+ * @brief Prepare an empty map.
+ * @param map Map.
+ * @param precision Registers per bucket, log2.
+ * @return 0 on success, -1 on error.
+ */
+static int map_init(struct bucket_map *map, int precision);
+
+/**
+ * @brief Find the bucket of a prefix, adding it if new.
+ * @param map Map.
+ * @param key Prefix as (network << 8 | bitmask).
+ * @return Bucket, or -1 on no memory.
+ */
+static long map_find(struct bucket_map *map, uint64_t key);
+
+/**
+ * @brief Merge every sketch of a map into another.
+ * @param dst Map, same precision.
+ * @param src Map.
+ * @return 0 on success, -1 on no memory.
+ */
+static int map_merge(struct bucket_map *dst, const struct bucket_map *src);
+
+/**
+ * @brief Free a map.
+ * @param map Map.
+ */
+static void map_free(struct bucket_map *map);
+
+/**
+ * @brief Read a stream block by block, counting each on several threads.
+ * @param fp Source stream.
+ * @param tasks Per-thread state.
+ * @param threads Number of threads.
+ * @return 0 on success, -1 on error.
+ */
+static int count_stream(FILE *fp, struct count_task *tasks, unsigned threads);
+
+/**
+ * @brief Count the lines of a task.
+ * @param arg struct count_task.
+ * @return NULL.
+ */
+static void *count_range(void *arg);
+
+/**
+ * @brief Read the precision of saved sketches.
+ * @param path File.
+ * @return Precision, or -1 on error.
+ */
+static int sketch_precision(const char *path);
+
+/**
+ * @brief Merge saved sketches into a map.
+ * @param map Map.
+ * @param path File.
+ * @return 0 on success, -1 on error.
+ */
+static int sketch_load(struct bucket_map *map, const char *path);
+
+/**
+ * @brief Save the sketches of a map.
+ * @param map Map.
+ * @param path File.
+ * @return 0 on success, -1 on error.
+ */
+static int sketch_save(const struct bucket_map *map, const char *path);
+
+/**
+ * @brief Print the estimates per bucket and the totals.
+ * @param map Sketches.
+ * @param table Buckets from a table, unmatched lines are reported.
+ * @param unmatched Destinations without a prefix.
+ * @param top Buckets to print, largest first, or 0 for all in order.
+ * @return 0 on success, -1 on error.
+ */
+static int report(const struct bucket_map *map, int table, uint64_t unmatched, size_t top);
+
+int distinct_start(int argc, char **argv)
+{
+	struct bucket_map map;
+	struct bucketing bk;
+	struct prefix_table table;
+	struct count_task *tasks = NULL;
+	FILE *fp = NULL;
+	const char *save = NULL;
+	char *endptr = NULL;
+	long threads, n;
+	int precision = 0, loads = 0, files = 0;
+	uint64_t unmatched = 0;
+	size_t top = 0;
+	int res;
+	STATS_DECL(t);
+
+	memset(&map, 0, sizeof(struct bucket_map));
+	memset(&table, 0, sizeof(struct prefix_table));
+	memset(&bk, 0, sizeof(struct bucketing));
+	bk.length = DEFAULT_LENGTH;
+
+	threads = sysconf(_SC_NPROCESSORS_ONLN);
+
+	for (int i = 0; i < argc; i++) {
+		if (strcmp(argv[i], "--length") == 0 || strcmp(argv[i], "--precision") == 0
+			|| strcmp(argv[i], "--threads") == 0 || strcmp(argv[i], "--top") == 0) {
+			if (i + 1 >= argc) { return EXIT_FAILURE; }
+			errno = 0;
+			n = strtol(argv[i + 1], &endptr, 10);
+			if (errno == ERANGE || *endptr != '\0' || n < 0) { return EXIT_FAILURE; }
+
+			if (argv[i][2] == 'l') {
+				if (n > BITS_IN_IP) { return EXIT_FAILURE; }
+				bk.length = (uint8_t) n;
+			}
+			else if (argv[i][2] == 'p') {
+				if (n < HLL_PRECISION_MIN || n > HLL_PRECISION_MAX) { return EXIT_FAILURE; }
+				precision = (int) n;
+			}
+			else if (argv[i][3] == 'h') {
+				if (n < 1) { return EXIT_FAILURE; }
+				threads = n;
+			}
+			else { top = (size_t) n; }
+			i++;
+		}
+		else if (strcmp(argv[i], "--table") == 0 || strcmp(argv[i], "--load") == 0
+				 || strcmp(argv[i], "--save") == 0) {
+			if (i + 1 >= argc) { return EXIT_FAILURE; }
+			if (argv[i][2] == 'l') {
+				/* Without --precision the first saved run sets it */
+				if (!precision && !loads && (precision = sketch_precision(argv[i + 1])) == -1) {
+					return EXIT_INPUT;
+				}
+				loads++;
+			}
+			else if (argv[i][2] == 's') { save = argv[i + 1]; }
+			i++;
+		}
+		else if (strncmp(argv[i], "--", 2) == 0) { return EXIT_FAILURE; }
+		else { files++; }
+	}
+	if (threads < 1) { threads = 1; }
+	if (threads > DISTINCT_THREADS_MAX) { threads = DISTINCT_THREADS_MAX; }
+	if (!precision) { precision = HLL_PRECISION; }
+	bk.netmask = prefix_netmask(bk.length);
+
+	tasks = calloc(threads, sizeof(struct count_task));
+	if (!tasks) { return EXIT_INPUT; }
+
+	if (map_init(&map, precision) == -1) { goto handle_error; }
+	for (long i = 0; i < threads; i++) {
+		tasks[i].bk = &bk;
+		if (map_init(&tasks[i].map, precision) == -1) { goto handle_error; }
+	}
+
+	for (int i = 0; i < argc; i++) {
+		if (strcmp(argv[i], "--table") == 0) {
+			fp = fopen(argv[++i], "r");
+			if (!fp) {
+				fprintf(stderr, "ipc: %s: %s\n", argv[i], strerror(errno));
+				goto handle_error;
+			}
+			prefix_table_free(&table);
+			res = prefix_table_read(&table, &fp, 1);
+			fclose(fp);
+			fp = NULL;
+			if (res == -1) {
+				fputs("ipc: invalid prefix table\n", stderr);
+				goto handle_error;
+			}
+			bk.table = &table;
+		}
+		else if (strcmp(argv[i], "--load") == 0) {
+			if (sketch_load(&map, argv[++i]) == -1) { goto handle_error; }
+		}
+		else if (strncmp(argv[i], "--", 2) == 0) { i++; }
+	}
+	STATS_LAP(t, stage_build);
+
+	for (int i = 0; i < argc; i++) {
+		if (strncmp(argv[i], "--", 2) == 0) {
+			i++;
+			continue;
+		}
+
+		fp = strcmp(argv[i], "-") == 0 ? stdin : fopen(argv[i], "r");
+		if (!fp) {
+			fprintf(stderr, "ipc: %s: %s\n", argv[i], strerror(errno));
+			goto handle_error;
+		}
+		res = count_stream(fp, tasks, (unsigned) threads);
+		if (fp != stdin) { fclose(fp); }
+		fp = NULL;
+		if (res == -1) { goto handle_error; }
+	}
+
+	if (!files && !loads && count_stream(stdin, tasks, (unsigned) threads) == -1) {
+		goto handle_error;
+	}
+	STATS_LAP(t, stage_parse);
+
+	for (long i = 0; i < threads; i++) {
+		if (map_merge(&map, &tasks[i].map) == -1) { goto handle_error; }
+		unmatched += tasks[i].unmatched;
+		STATS_ITEMS(tasks[i].unmatched);
+	}
+	for (size_t i = 0; i < map.len; i++) { STATS_ITEMS(map.records[i]); }
+	STATS_LAP(t, stage_derive);
+
+	if (save && sketch_save(&map, save) == -1) {
+		fprintf(stderr, "ipc: %s: %s\n", save, strerror(errno));
+		goto handle_error;
+	}
+	if (report(&map, bk.table != NULL, unmatched, top) == -1) { goto handle_error; }
+	STATS_LAP(t, stage_output);
+
+	for (long i = 0; i < threads; i++) { map_free(&tasks[i].map); }
+	free(tasks);
+	map_free(&map);
+	prefix_table_free(&table);
+	return EXIT_SUCCESS;
+
+	handle_error:
+		for (long i = 0; i < threads; i++) { map_free(&tasks[i].map); }
+		free(tasks);
+		map_free(&map);
+		prefix_table_free(&table);
+		return EXIT_INPUT;
+}
+
+static int map_init(struct bucket_map *map, int precision)
+{
+	memset(map, 0, sizeof(struct bucket_map));
+	map->precision = precision;
+
+	map->slots = calloc(MAP_MIN_SLOTS, sizeof(uint32_t));
+	if (!map->slots) { return -1; }
+	map->mask = MAP_MIN_SLOTS - 1;
+
+	return 0;
+}
+
+static long map_find(struct bucket_map *map, uint64_t key)
+{
+	size_t m = (size_t) 1 << map->precision;
+	size_t slots = map->mask + 1;
+	size_t i = hll_hash((uint32_t) (key ^ key >> 32)) & map->mask;
+	uint32_t *grown = NULL;
+	void *p = NULL;
+
+	for (; map->slots[i]; i = (i + 1) & map->mask) {
+		if (map->keys[map->slots[i] - 1] == key) { return map->slots[i] - 1; }
+	}
+
+	if (map->len == UINT32_MAX - 1) { return -1; }
+
+	if (map->len == map->cap) {
+		map->cap = map->cap ? map->cap * 2 : 64;
+		if (!(p = realloc(map->keys, map->cap * sizeof(uint64_t)))) { return -1; }
+		map->keys = p;
+		if (!(p = realloc(map->records, map->cap * sizeof(uint64_t)))) { return -1; }
+		map->records = p;
+		if (!(p = realloc(map->regs, map->cap * m))) { return -1; }
+		map->regs = p;
+	}
+
+	map->keys[map->len] = key;
+	map->records[map->len] = 0;
+	memset(map->regs + map->len * m, 0, m);
+	map->slots[i] = (uint32_t) ++map->len;
+
+	/* At half load the slots double, buckets keep their numbers */
+	if (map->len * 2 > slots) {
+		grown = calloc(slots * 2, sizeof(uint32_t));
+		if (!grown) { return -1; }
+		for (size_t b = 0; b < map->len; b++) {
+			key = map->keys[b];
+			i = hll_hash((uint32_t) (key ^ key >> 32)) & (slots * 2 - 1);
+			while (grown[i]) { i = (i + 1) & (slots * 2 - 1); }
+			grown[i] = (uint32_t) (b + 1);
+		}
+		free(map->slots);
+		map->slots = grown;
+		map->mask = slots * 2 - 1;
+	}
+
+	return (long) (map->len - 1);
+}
+
+static int map_merge(struct bucket_map *dst, const struct bucket_map *src)
+{
+	size_t m = (size_t) 1 << dst->precision;
+	long b;
+
+	for (size_t i = 0; i < src->len; i++) {
+		b = map_find(dst, src->keys[i]);
+		if (b == -1) { return -1; }
+		hll_merge(dst->regs + b * m, src->regs + i * m, dst->precision);
+		dst->records[b] += src->records[i];
+	}
+
+	return 0;
+}
+
+static void map_free(struct bucket_map *map)
+{
+	free(map->slots);
+	free(map->keys);
+	free(map->records);
+	free(map->regs);
+	memset(map, 0, sizeof(struct bucket_map));
+
+	return;
+}
+
+static int count_stream(FILE *fp, struct count_task *tasks, unsigned threads)
+{
+	const char *p = NULL;
+	const char *end = NULL;
+	char *buf = NULL;
+	size_t len = 0;
+	size_t got, cut;
+	unsigned started;
+	int eof = 0, error = 0;
+
+	buf = malloc(DISTINCT_BLOCK);
+	if (!buf) { return -1; }
+
+	while (!eof && !error) {
+		got = fread(buf + len, 1, DISTINCT_BLOCK - len, fp);
+		len += got;
+		if (len < DISTINCT_BLOCK) {
+			if (ferror(fp)) {
+				fprintf(stderr, "ipc: %s\n", strerror(errno));
+				goto handle_error;
+			}
+			eof = 1;
+		}
+
+		/* Whole lines only, the rest waits for the next round */
+		cut = len;
+		if (!eof) {
+			while (cut && buf[cut - 1] != '\n') { cut--; }
+			if (!cut) {
+				fputs("ipc: line too long\n", stderr);
+				goto handle_error;
+			}
+		}
+
+		/* Equal shares, each moved forward to the next line */
+		p = buf;
+		end = buf + cut;
+		for (unsigned i = 0; i < threads; i++) {
+			tasks[i].begin = p;
+			p = (i + 1 == threads) ? end : buf + cut / threads * (i + 1);
+			if (p < tasks[i].begin) { p = tasks[i].begin; }
+			while (p > buf && p < end && p[-1] != '\n') { p++; }
+			tasks[i].end = p;
+		}
+
+		for (started = 0; started + 1 < threads; started++) {
+			if (pthread_create(&tasks[started].tid, NULL, count_range, &tasks[started]) != 0) {
+				break;
+			}
+		}
+
+		/* The calling thread counts the last share, and any that did not start */
+		for (unsigned i = started; i < threads; i++) { count_range(&tasks[i]); }
+		for (unsigned i = 0; i < started; i++) { pthread_join(tasks[i].tid, NULL); }
+
+		for (unsigned i = 0; i < threads; i++) {
+			if (!tasks[i].error) { continue; }
+			if (tasks[i].bad[0]) { fprintf(stderr, "ipc: invalid entry '%s'\n", tasks[i].bad); }
+			error = 1;
+		}
+
+		memmove(buf, buf + cut, len - cut);
+		len -= cut;
+	}
+
+	free(buf);
+	return error ? -1 : 0;
+
+	handle_error:
+		free(buf);
+		return -1;
+}
+
+static void *count_range(void *arg)
+{
+	struct count_task *task = arg;
+	struct bucket_map *map = &task->map;
+	const struct bucketing *bk = task->bk;
+	const char *p = task->begin;
+	const char *end = task->end;
+	const char *line_end = NULL;
+	const char *start = NULL;
+	char tok[2][TOKEN_MAX + 1];
+	struct prefix pfx;
+	uint32_t addr[2];
+	uint64_t key;
+	size_t m = (size_t) 1 << map->precision;
+	size_t n;
+	int words;
+	long b;
+
+	for (; p < end; p = line_end + 1) {
+		line_end = memchr(p, '\n', end - p);
+		if (!line_end) { line_end = end; }
+
+		/* Up to two words before a comment */
+		for (words = 0; p < line_end; words++) {
+			while (p < line_end && (*p == ' ' || *p == '\t' || *p == '\r')) { p++; }
+			if (p == line_end || *p == '#') { break; }
+
+			start = p;
+			while (p < line_end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '#') { p++; }
+
+			n = p - start;
+			if (n > TOKEN_MAX) { n = TOKEN_MAX; }
+			if (words == 2 || n == TOKEN_MAX) {
+				memcpy(task->bad, start, n);
+				task->bad[n] = '\0';
+				task->error = 1;
+				return NULL;
+			}
+			memcpy(tok[words], start, n);
+			tok[words][n] = '\0';
+
+			if (parse_prefix(tok[words], &pfx) == -1 || pfx.bitmask != BITS_IN_IP) {
+				memcpy(task->bad, tok[words], n + 1);
+				task->error = 1;
+				return NULL;
+			}
+			addr[words] = pfx.addr;
+		}
+		if (!words) { continue; }
+		if (words == 1) { addr[1] = addr[0]; }
+
+		if (!bk->table) { key = (uint64_t) (addr[1] & bk->netmask) << 8 | bk->length; }
+		else if (prefix_table_lookup(bk->table, addr[1], &pfx)) {
+			key = (uint64_t) pfx.addr << 8 | pfx.bitmask;
+		}
+		else {
+			task->unmatched++;
+			continue;
+		}
+
+		b = map_find(map, key);
+		if (b == -1) {
+			task->error = 1;
+			return NULL;
+		}
+		hll_add(map->regs + b * m, map->precision, addr[0]);
+		map->records[b]++;
+	}
+
+	return NULL;
+}
+
+static int sketch_precision(const char *path)
+{
+	struct sketch_file_header hdr;
+	FILE *fp = fopen(path, "rb");
+	size_t got;
+
+	if (!fp) {
+		fprintf(stderr, "ipc: %s: %s\n", path, strerror(errno));
+		return -1;
+	}
+	got = fread(&hdr, sizeof(struct sketch_file_header), 1, fp);
+	fclose(fp);
+
+	if (got != 1 || memcmp(hdr.magic, SKETCH_FILE_MAGIC, sizeof(hdr.magic)) != 0
+		|| hdr.precision < HLL_PRECISION_MIN || hdr.precision > HLL_PRECISION_MAX) {
+		fprintf(stderr, "ipc: %s: not saved sketches\n", path);
+		return -1;
+	}
+
+	return (int) hdr.precision;
+}
+
+static int sketch_load(struct bucket_map *map, const char *path)
+{
+	struct sketch_file_header hdr;
+	struct sketch_file_entry ent;
+	size_t m = (size_t) 1 << map->precision;
+	uint8_t *regs = NULL;
+	FILE *fp = NULL;
+	long b;
+
+	fp = fopen(path, "rb");
+	if (!fp) {
+		fprintf(stderr, "ipc: %s: %s\n", path, strerror(errno));
+		return -1;
+	}
+
+	if (fread(&hdr, sizeof(struct sketch_file_header), 1, fp) != 1
+		|| memcmp(hdr.magic, SKETCH_FILE_MAGIC, sizeof(hdr.magic)) != 0
+		|| hdr.version != SKETCH_FILE_VERSION) {
+		fprintf(stderr, "ipc: %s: not saved sketches\n", path);
+		goto handle_error;
+	}
+	if (hdr.precision != (uint32_t) map->precision) {
+		fprintf(stderr, "ipc: %s: precision %" PRIu32 ", not %d\n", path, hdr.precision,
+				map->precision);
+		goto handle_error;
+	}
+
+	regs = malloc(m);
+	if (!regs) { goto handle_error; }
+
+	for (uint64_t i = 0; i < hdr.count; i++) {
+		if (fread(&ent, sizeof(struct sketch_file_entry), 1, fp) != 1
+			|| fread(regs, m, 1, fp) != 1 || ent.bitmask > BITS_IN_IP) {
+			fprintf(stderr, "ipc: %s: truncated or damaged\n", path);
+			goto handle_error;
+		}
+
+		b = map_find(map, (uint64_t) ent.addr << 8 | ent.bitmask);
+		if (b == -1) { goto handle_error; }
+		hll_merge(map->regs + b * m, regs, map->precision);
+		map->records[b] += ent.records;
+	}
+
+	free(regs);
+	fclose(fp);
+	return 0;
+
+	handle_error:
+		free(regs);
+		fclose(fp);
+		return -1;
+}
+
+static int sketch_save(const struct bucket_map *map, const char *path)
+{
+	struct sketch_file_header hdr;
+	struct sketch_file_entry ent;
+	size_t m = (size_t) 1 << map->precision;
+	FILE *fp = NULL;
+
+	memset(&hdr, 0, sizeof(struct sketch_file_header));
+	memcpy(hdr.magic, SKETCH_FILE_MAGIC, sizeof(hdr.magic));
+	hdr.version = SKETCH_FILE_VERSION;
+	hdr.precision = (uint32_t) map->precision;
+	hdr.count = map->len;
+
+	fp = fopen(path, "wb");
+	if (!fp) { return -1; }
+
+	if (fwrite(&hdr, sizeof(struct sketch_file_header), 1, fp) != 1) { goto handle_error; }
+
+	memset(&ent, 0, sizeof(struct sketch_file_entry));
+	for (size_t i = 0; i < map->len; i++) {
+		ent.addr = (uint32_t) (map->keys[i] >> 8);
+		ent.bitmask = (uint8_t) (map->keys[i] & 0xFF);
+		ent.records = map->records[i];
+		if (fwrite(&ent, sizeof(struct sketch_file_entry), 1, fp) != 1
+			|| fwrite(map->regs + i * m, m, 1, fp) != 1) {
+			goto handle_error;
+		}
+	}
+
+	return fclose(fp) == EOF ? -1 : 0;
+
+	handle_error:
+		fclose(fp);
+		return -1;
+}
+
+/* Estimates of the buckets being sorted, for the comparators */
+static const double *sort_est;
+static const uint64_t *sort_keys;
+
+/**
+ * @brief Order buckets by prefix.
+ */
+static int by_key(const void *a, const void *b)
+{
+	uint64_t x = sort_keys[*(const size_t *) a];
+	uint64_t y = sort_keys[*(const size_t *) b];
+
+	return (x > y) - (x < y);
+}
+
+/**
+ * @brief Order buckets by estimate, largest first, then by prefix.
+ */
+static int by_estimate(const void *a, const void *b)
+{
+	double x = sort_est[*(const size_t *) a];
+	double y = sort_est[*(const size_t *) b];
+
+	if (x != y) { return (x < y) - (x > y); }
+
+	return by_key(a, b);
+}
+
+static int report(const struct bucket_map *map, int table, uint64_t unmatched, size_t top)
+{
+	size_t m = (size_t) 1 << map->precision;
+	double err = hll_error(map->precision);
+	struct outbuf *ob = NULL;
+	size_t *order = NULL;
+	double *est = NULL;
+	uint64_t records = 0;
+	uint32_t addr;
+	char *dst = NULL;
+	size_t rows;
+	int len, res;
+
+	order = malloc((map->len ? map->len : 1) * sizeof(size_t));
+	est = malloc((map->len ? map->len : 1) * sizeof(double));
+	ob = malloc(sizeof(struct outbuf));
+	if (!order || !est || !ob) { goto handle_error; }
+	outbuf_init(ob, stdout);
+
+	for (size_t i = 0; i < map->len; i++) {
+		order[i] = i;
+		/* Never more sources than lines */
+		est[i] = hll_estimate(map->regs + i * m, map->precision);
+		if (est[i] > map->records[i]) { est[i] = (double) map->records[i]; }
+		records += map->records[i];
+	}
+
+	sort_est = est;
+	sort_keys = map->keys;
+	qsort(order, map->len, sizeof(size_t), top ? by_estimate : by_key);
+	rows = top && top < map->len ? top : map->len;
+
+	dst = outbuf_reserve(ob, ROW_MAX);
+	len = snprintf(dst, ROW_MAX, "%5s%-20s%-14s%-14s%s\n", "", "BUCKET", "RECORDS",
+				   "DISTINCT", "ERROR (95%)");
+	ob->len += len < ROW_MAX ? len : ROW_MAX - 1;
+
+	for (size_t r = 0; r < rows; r++) {
+		addr = (uint32_t) (map->keys[order[r]] >> 8);
+		dst = outbuf_reserve(ob, ROW_MAX);
+		len = snprintf(dst, ROW_MAX, "%-5zu%03u.%03u.%03u.%03u/%-4u%-14" PRIu64 "%-14.0f%.0f\n",
+					   r, addr >> 24, addr >> 16 & 0xff, addr >> 8 & 0xff, addr & 0xff,
+					   (unsigned) (map->keys[order[r]] & 0xff), map->records[order[r]],
+					   est[order[r]], 1.96 * err * est[order[r]]);
+		ob->len += len < ROW_MAX ? len : ROW_MAX - 1;
+	}
+
+	dst = outbuf_reserve(ob, 4 * ROW_MAX);
+	len = snprintf(dst, 4 * ROW_MAX, "\n%-15s%zu\n%-15s%" PRIu64 "\n", "Buckets", map->len,
+				   "Records", records + unmatched);
+	ob->len += len < 4 * ROW_MAX ? len : 4 * ROW_MAX - 1;
+
+	if (table) {
+		dst = outbuf_reserve(ob, ROW_MAX);
+		len = snprintf(dst, ROW_MAX, "%-15s%" PRIu64 "\n", "Unmatched", unmatched);
+		ob->len += len < ROW_MAX ? len : ROW_MAX - 1;
+	}
+
+	dst = outbuf_reserve(ob, ROW_MAX);
+	len = snprintf(dst, ROW_MAX, "%-15s%zu bytes per bucket, %.2f%% standard error\n", "Sketch",
+				   m, err * 100);
+	ob->len += len < ROW_MAX ? len : ROW_MAX - 1;
+
+	res = outbuf_flush(ob);
+
+	free(ob);
+	free(est);
+	free(order);
+	return res;
+
+	handle_error:
+		free(ob);
+		free(est);
+		free(order);
+		return -1;
+}
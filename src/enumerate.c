@@ -0,0 +1,398 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "ipv4_t.h"
+#include "fill_ipv4.h"
+#include "prefix_list.h"
+#include "interval_set.h"
+#include "format.h"
+#include "prng.h"
+#include "status.h"
+#include "enumerate.h"
+
+#define FEISTEL_ROUNDS		4
+
+/**
+ * @struct enum_opts
+ * @brief Options of the enumeration mode.
+ */
+struct enum_opts {
+    uint32_t stride;                /**< Distance between listed hosts */
+    uint64_t seed;                  /**< Shuffle seed */
+    uint8_t shuffle;                /**< Random order */
+    uint8_t seed_set;               /**< Seed given by the user */
+};
+
+/**
+ * @struct feistel
+ * @brief Keyed bijection on [0, 2^(2 * half_bits)).
+ */
+struct feistel {
+    uint64_t keys[FEISTEL_ROUNDS];  /**< Round keys */
+    uint32_t half_bits;             /**< Bits in each half */
+    uint64_t half_mask;             /**< Mask of one half */
+};
+
+/**
+ * @brief Parse the options of the enumeration mode.
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ * @param[out] opts Parsed options.
+ * @param[out] excl Excluded intervals, merged.
+ * @return 0 on success, -1 on an invalid option, -2 on an unusable
+ *         --exclude-file (reported) or no memory.
+ */
+static int process_enum_args(int argc, char **argv, struct enum_opts *opts,
+                             struct interval_set *excl);
+
+/**
+ * @brief List hosts in ascending order.
+ *
+ * Consecutive hosts only rewrite the digits of the last octet.
+ *
+ * @param ob Output buffer.
+ * @param first First host.
+ * @param count Number of host positions.
+ * @param stride Distance between positions.
+ * @param excl Excluded blocks, merged.
+ */
+static void list_sequential(struct outbuf *ob, uint32_t first, uint64_t count,
+                            uint32_t stride, const struct interval_set *excl);
+
+/**
+ * @brief List hosts in a random order without repeats.
+ * @param ob Output buffer.
+ * @param first First host.
+ * @param count Number of host positions.
+ * @param stride Distance between positions.
+ * @param excl Excluded blocks, merged.
+ * @param seed Seed of the permutation.
+ */
+static void list_shuffled(struct outbuf *ob, uint32_t first, uint64_t count,
+                          uint32_t stride, const struct interval_set *excl,
+                          uint64_t seed);
+
+/**
+ * @brief Find an excluded block holding the address.
+ * @param excl Excluded blocks, merged.
+ * @param addr Address.
+ * @return Index of the block, or -1 if the address is not excluded.
+ */
+static long find_excluded(const struct interval_set *excl, uint32_t addr);
+
+/**
+ * @brief Increase the decimal last octet at the end of a line by one.
+ * @param line Address text.
+ * @param len Length of the text, updated when a digit is added.
+ * @param oct_start Index of the first digit of the last octet.
+ */
+static void bump_last_octet(char *line, size_t *len, size_t oct_start);
+
+/**
+ * @brief Prepare a Feistel network that covers the domain.
+ * @param fn Network to set up.
+ * @param domain Number of values to permute.
+ * @param seed Key seed.
+ */
+static void feistel_init(struct feistel *fn, uint64_t domain, uint64_t seed);
+
+/**
+ * @brief Map a value through the Feistel network.
+ * @param fn Network.
+ * @param x Value below 2^(2 * half_bits).
+ * @return Permuted value.
+ */
+static uint64_t feistel_permute(const struct feistel *fn, uint64_t x);
+
+int enumerate_start(int argc, char **argv)
+{
+	struct enum_opts opts;
+	struct interval_set excl;
+	struct outbuf *ob = NULL;
+	ipv4_t ip;
+	uint32_t first, last;
+	uint64_t count;
+	int res;
+
+	if (argc < 1 || !argv) { return EXIT_FAILURE; }
+
+	memset(&ip, 0, sizeof(ipv4_t));
+	memset(&excl, 0, sizeof(struct interval_set));
+
+	res = process_enum_args(argc, argv, &opts, &excl);
+	if (res == -2) {
+		interval_set_free(&excl);
+		return EXIT_INPUT;
+	}
+	if (res == -1) { goto handle_error; }
+
+	if (!fill_addr(&ip, argv[0])) { goto handle_error; }
+	if (!fill_bitmask(&ip, argv[0])) { goto handle_error; }
+	if (!fill_netmask(&ip)) { goto handle_error; }
+	if (!fill_wildcard(&ip)) { goto handle_error; }
+	if (!fill_network(&ip)) { goto handle_error; }
+	if (!fill_broadcast(&ip)) { goto handle_error; }
+	if (!fill_hostmin(&ip)) { goto handle_error; }
+	if (!fill_hostmax(&ip)) { goto handle_error; }
+
+	first = addr_to_u32(ip.hostmin);
+	last = addr_to_u32(ip.hostmax);
+	count = ((uint64_t) last - first) / opts.stride + 1;
+
+	ob = malloc(sizeof(struct outbuf));
+	if (!ob) { goto handle_error; }
+	outbuf_init(ob, stdout);
+
+	if (opts.shuffle) {
+		if (!opts.seed_set) { opts.seed = prng_entropy(); }
+		list_shuffled(ob, first, count, opts.stride, &excl, opts.seed);
+	}
+	else { list_sequential(ob, first, count, opts.stride, &excl); }
+
+	res = outbuf_flush(ob);
+
+	free(ob);
+	interval_set_free(&excl);
+
+	return res == -1 ? EXIT_INPUT : EXIT_SUCCESS;
+
+	handle_error:
+		free(ob);
+		interval_set_free(&excl);
+		return EXIT_FAILURE;
+}
+
+static int process_enum_args(int argc, char **argv, struct enum_opts *opts,
+                             struct interval_set *excl)
+{
+	unsigned long long val;
+	char *endptr = NULL;
+	char bad[INTERVAL_SET_ENTRY_MAX];
+	uint32_t first, last;
+	FILE *fp = NULL;
+	int res;
+
+	if (!argv || !opts || !excl) { return -1; }
+
+	memset(opts, 0, sizeof(struct enum_opts));
+	opts->stride = 1;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--shuffle") == 0) { opts->shuffle = 1; continue; }
+
+		/* The rest of the options take a value */
+		if (i + 1 >= argc) { return -1; }
+
+		if (strcmp(argv[i], "--stride") == 0) {
+			if (argv[i + 1][0] < '0' || argv[i + 1][0] > '9') { return -1; }
+			errno = 0;
+			val = strtoull(argv[++i], &endptr, 10);
+			if (errno == ERANGE || *endptr != '\0') { return -1; }
+			if (val == 0 || val > UINT32_MAX) { return -1; }
+			opts->stride = (uint32_t) val;
+		}
+		else if (strcmp(argv[i], "--seed") == 0) {
+			errno = 0;
+			val = strtoull(argv[++i], &endptr, 0);
+			if (errno == ERANGE || *endptr != '\0') { return -1; }
+			opts->seed = val;
+			opts->seed_set = 1;
+		}
+		else if (strcmp(argv[i], "--exclude") == 0) {
+			if (parse_interval(argv[++i], &first, &last) == -1) { return -1; }
+			if (interval_set_add(excl, first, last) == -1) { return -2; }
+		}
+		else if (strcmp(argv[i], "--exclude-file") == 0) {
+			fp = fopen(argv[++i], "r");
+			if (!fp) {
+				fprintf(stderr, "ipc: %s: %s\n", argv[i], strerror(errno));
+				return -2;
+			}
+			res = interval_set_read(excl, fp, bad, sizeof(bad));
+			fclose(fp);
+			if (res == INTERVAL_SET_INVALID) { fprintf(stderr, "ipc: invalid entry '%s'\n", bad); }
+			else if (res == INTERVAL_SET_DAMAGED) { fputs("ipc: damaged compiled prefix set\n", stderr); }
+			if (res != 0) { return -2; }
+		}
+		else { return -1; }
+	}
+
+	if (interval_set_sort(excl) == -1) { return -2; }
+	interval_set_merge(excl);
+
+	return 0;
+}
+
+static void list_sequential(struct outbuf *ob, uint32_t first, uint64_t count,
+                            uint32_t stride, const struct interval_set *excl)
+{
+	char line[ADDR_STR_LEN + 1];
+	size_t len = 0, oct_start = 0;
+	uint32_t addr, prev = 0;
+	uint32_t block_last;
+	uint8_t have_prev = 0;
+	size_t next_excl = 0;
+	uint64_t pos = 0;
+	char *dst = NULL;
+
+	/* Skip blocks that end before the first host */
+	while (next_excl < excl->len && (uint32_t) excl->keys[next_excl] < first) {
+		next_excl++;
+	}
+
+	while (pos < count && !ob->error) {
+		addr = first + (uint32_t) (pos * stride);
+
+		if (next_excl < excl->len && (uint32_t) (excl->keys[next_excl] >> 32) <= addr) {
+			/* Jump to the first position after the excluded block */
+			block_last = (uint32_t) excl->keys[next_excl];
+			next_excl++;
+			pos = ((uint64_t) block_last - first) / stride + 1;
+			have_prev = 0;
+			continue;
+		}
+
+		if (have_prev && addr == prev + 1 && (addr & 0xFF) != 0) {
+			bump_last_octet(line, &len, oct_start);
+		}
+		else {
+			len = format_addr_plain(line, addr) - line;
+			oct_start = len;
+			while (line[oct_start - 1] != '.') { oct_start--; }
+		}
+
+		dst = outbuf_reserve(ob, ADDR_STR_LEN + 1);
+		memcpy(dst, line, ADDR_STR_LEN);
+		dst[len] = '\n';
+		ob->len += len + 1;
+
+		prev = addr;
+		have_prev = 1;
+		pos++;
+	}
+
+	return;
+}
+
+static void list_shuffled(struct outbuf *ob, uint32_t first, uint64_t count,
+                          uint32_t stride, const struct interval_set *excl,
+                          uint64_t seed)
+{
+	struct feistel fn;
+	uint64_t x, pos;
+	uint32_t addr;
+	char *dst = NULL;
+
+	feistel_init(&fn, count, seed);
+
+	for (x = 0; x < count && !ob->error; x++) {
+		/* Cycle walking keeps the image inside the domain */
+		pos = feistel_permute(&fn, x);
+		while (pos >= count) { pos = feistel_permute(&fn, pos); }
+
+		addr = first + (uint32_t) (pos * stride);
+		if (find_excluded(excl, addr) != -1) { continue; }
+
+		dst = outbuf_reserve(ob, ADDR_STR_LEN + 1);
+		dst = format_addr_plain(dst, addr);
+		*dst++ = '\n';
+		ob->len = dst - ob->data;
+	}
+
+	return;
+}
+
+static long find_excluded(const struct interval_set *excl, uint32_t addr)
+{
+	size_t lo = 0, hi = excl->len, mid;
+
+	/* Last block starting at or before addr */
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if ((uint32_t) (excl->keys[mid] >> 32) <= addr) { lo = mid + 1; }
+		else { hi = mid; }
+	}
+
+	if (lo == 0) { return -1; }
+	if ((uint32_t) excl->keys[lo - 1] < addr) { return -1; }
+
+	return (long) lo - 1;
+}
+
+static void bump_last_octet(char *line, size_t *len, size_t oct_start)
+{
+	size_t i = *len;
+
+	while (i > oct_start) {
+		i--;
+		if (line[i] != '9') {
+			line[i]++;
+			return;
+		}
+		line[i] = '0';
+	}
+
+	/* 9 -> 10, 99 -> 100 */
+	line[oct_start] = '1';
+	line[(*len)++] = '0';
+
+	return;
+}
+
+static void feistel_init(struct feistel *fn, uint64_t domain, uint64_t seed)
+{
+	struct prng rng;
+	uint32_t bits = 2;
+
+	while (bits < 64 && ((uint64_t) 1 << bits) < domain) { bits++; }
+
+	fn->half_bits = (bits + 1) / 2;
+	fn->half_mask = ((uint64_t) 1 << fn->half_bits) - 1;
+
+	prng_seed(&rng, seed);
+	for (int i = 0; i < FEISTEL_ROUNDS; i++) { fn->keys[i] = prng_next(&rng); }
+
+	return;
+}
+
+static uint64_t feistel_permute(const struct feistel *fn, uint64_t x)
+{
+	uint64_t left = x >> fn->half_bits;
+	uint64_t right = x & fn->half_mask;
+	uint64_t f, tmp;
+
+	for (int i = 0; i < FEISTEL_ROUNDS; i++) {
+		f = (right ^ fn->keys[i]) * 0x9e3779b97f4a7c15ULL;
+		f ^= f >> 29;
+		f *= 0xbf58476d1ce4e5b9ULL;
+		f ^= f >> 32;
+
+		tmp = right;
+		right = left ^ (f & fn->half_mask);
+		left = tmp;
+	}
+
+	return left << fn->half_bits | right;
+}
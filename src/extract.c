@@ -0,0 +1,196 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "scan.h"
+#include "format.h"
+#include "stats.h"
+#include "status.h"
+#include "extract.h"
+
+#define READ_CHUNK		(1 << 20)		/* Bytes read at once from a stream */
+#define POS_STR_LEN		20				/* Decimal digits of a uint64_t */
+
+enum position { pos_none, pos_offset, pos_line };
+
+/**
+ * @struct sink
+ * @brief Where found addresses go.
+ */
+struct sink {
+    struct outbuf *ob;              /**< Output */
+    enum position pos;              /**< Position to append */
+    const char *name;               /**< File name to append, or NULL */
+    size_t name_len;                /**< Length of name */
+    uint64_t count;                 /**< Addresses found */
+};
+
+/**
+ * @brief Print one address.
+ * @param ctx Sink.
+ * @param addr Address.
+ * @param offset Byte offset.
+ * @param line Line number.
+ */
+static void put_addr(void *ctx, uint32_t addr, uint64_t offset, uint64_t line);
+
+/**
+ * @brief Scan a file, mapped if possible.
+ * @param fd File.
+ * @param sk Sink.
+ * @return 0 on success, -1 on error.
+ */
+static int scan_fd(int fd, struct sink *sk);
+
+int extract_start(int argc, char **argv)
+{
+	struct sink sk;
+	int fd = -1;
+	int files = 0;
+	STATS_DECL(t);
+
+	memset(&sk, 0, sizeof(struct sink));
+
+	for (int i = 0; i < argc; i++) {
+		if (strcmp(argv[i], "--offset") == 0) { sk.pos = pos_offset; }
+		else if (strcmp(argv[i], "--line") == 0) { sk.pos = pos_line; }
+		else if (strncmp(argv[i], "--", 2) == 0) { return EXIT_FAILURE; }
+		else { files++; }
+	}
+
+	sk.ob = malloc(sizeof(struct outbuf));
+	if (!sk.ob) { return EXIT_INPUT; }
+	outbuf_init(sk.ob, stdout);
+
+	if (!files && scan_fd(STDIN_FILENO, &sk) == -1) {
+		fprintf(stderr, "ipc: stdin: %s\n", strerror(errno));
+		goto handle_error;
+	}
+
+	for (int i = 0; i < argc; i++) {
+		if (strncmp(argv[i], "--", 2) == 0) { continue; }
+
+		if (files > 1) {
+			sk.name = argv[i];
+			sk.name_len = strlen(argv[i]);
+		}
+
+		fd = open(argv[i], O_RDONLY);
+		if (fd == -1 || scan_fd(fd, &sk) == -1) {
+			fprintf(stderr, "ipc: %s: %s\n", argv[i], strerror(errno));
+			goto handle_error;
+		}
+		close(fd);
+		fd = -1;
+	}
+	STATS_LAP(t, stage_parse);
+	STATS_ITEMS(sk.count);
+
+	if (outbuf_flush(sk.ob) == -1) { goto handle_error; }
+	STATS_LAP(t, stage_output);
+
+	free(sk.ob);
+	return EXIT_SUCCESS;
+
+	handle_error:
+		if (fd != -1) { close(fd); }
+		free(sk.ob);
+		return EXIT_INPUT;
+}
+
+static int scan_fd(int fd, struct sink *sk)
+{
+	struct scan_state st;
+	struct stat sb;
+	char *map = NULL;
+	char *buf = NULL;
+	ssize_t got;
+
+	scan_init(&st);
+
+	/* Regular files are scanned in one piece */
+	if (fstat(fd, &sb) == 0 && S_ISREG(sb.st_mode) && sb.st_size > 0) {
+		map = mmap(NULL, sb.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+		if (map != MAP_FAILED) {
+			madvise(map, sb.st_size, MADV_SEQUENTIAL);
+			scan_feed(&st, map, sb.st_size, put_addr, sk);
+			scan_finish(&st, put_addr, sk);
+			munmap(map, sb.st_size);
+			return sk->ob->error ? -1 : 0;
+		}
+	}
+
+	buf = malloc(READ_CHUNK);
+	if (!buf) { return -1; }
+
+	while ((got = read(fd, buf, READ_CHUNK)) != 0) {
+		if (got == -1) {
+			if (errno == EINTR) { continue; }
+			free(buf);
+			return -1;
+		}
+		scan_feed(&st, buf, got, put_addr, sk);
+	}
+	scan_finish(&st, put_addr, sk);
+
+	free(buf);
+
+	return sk->ob->error ? -1 : 0;
+}
+
+static void put_addr(void *ctx, uint32_t addr, uint64_t offset, uint64_t line)
+{
+	struct sink *sk = ctx;
+	char digits[POS_STR_LEN];
+	uint64_t pos = sk->pos == pos_offset ? offset : line;
+	char *dst = outbuf_reserve(sk->ob, ADDR_STR_LEN + sk->name_len + POS_STR_LEN + 6);
+	char *p = format_addr_plain(dst, addr);
+	int n = 0;
+
+	if (sk->pos != pos_none) {
+		memcpy(p, " # ", 3);
+		p += 3;
+		if (sk->name) {
+			memcpy(p, sk->name, sk->name_len);
+			p += sk->name_len;
+			*p++ = ':';
+		}
+
+		do {
+			digits[n++] = '0' + pos % 10;
+			pos /= 10;
+		} while (pos);
+		while (n) { *p++ = digits[--n]; }
+	}
+	*p++ = '\n';
+
+	sk->ob->len += p - dst;
+	sk->count++;
+
+	return;
+}
@@ -243,3 +243,23 @@ ipv4_t *fill_hostcnt(ipv4_t *ip)
 
 	return ip;
 }
+
+uint32_t addr_to_u32(const uint8_t *octets)
+{
+	if (!octets) { return 0; }
+
+	return ((uint32_t) octets[0] << 24) | ((uint32_t) octets[1] << 16) |
+		   ((uint32_t) octets[2] << 8) | (uint32_t) octets[3];
+}
+
+void u32_to_addr(uint32_t num, uint8_t *octets)
+{
+	if (!octets) { return; }
+
+	octets[0] = num >> 24;
+	octets[1] = num >> 16 & 0xFF;
+	octets[2] = num >> 8 & 0xFF;
+	octets[3] = num & 0xFF;
+
+	return;
+}
@@ -0,0 +1,391 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "prefix_list.h"
+#include "format.h"
+#include "stats.h"
+#include "special.h"
+#include "acl.h"
+#include "status.h"
+#include "filter.h"
+
+#define FILTER_BATCH		4096			/* Addresses matched at once */
+#define RULE_MAX_LEN		48				/* "permit 255.255.255.255 255.255.255.255" */
+
+/**
+ * @struct filter_opts
+ * @brief Options of the ACL mode.
+ */
+struct filter_opts {
+    const char *acl;                /**< ACL file */
+    uint8_t check;                  /**< Report only */
+    uint8_t count;                  /**< Hits per entry */
+    uint8_t binary;                 /**< Binary input */
+};
+
+/**
+ * @struct addr_reader
+ * @brief Source of addresses, text or binary.
+ */
+struct addr_reader {
+    FILE *fp;                       /**< Source stream */
+    struct token_reader rd;         /**< Text tokens */
+    uint8_t binary;                 /**< 4-byte big-endian input */
+};
+
+/**
+ * @brief Parse the options of the ACL mode.
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ * @param[out] opts Parsed options.
+ * @return 0 on success, -1 on error.
+ */
+static int process_filter_args(int argc, char **argv, struct filter_opts *opts);
+
+/**
+ * @brief Load and compile the access list.
+ * @param acl Access list to fill.
+ * @param path ACL file.
+ * @return 0 on success, -1 on error.
+ */
+static int load_acl(struct acl *acl, const char *path);
+
+/**
+ * @brief Report entries without effect.
+ * @param acl Compiled access list.
+ * @param fp Destination stream.
+ * @return Number of entries reported, -1 on error.
+ */
+static long report_issues(const struct acl *acl, FILE *fp);
+
+/**
+ * @brief Read the next addresses.
+ * @param ar Reader.
+ * @param[out] addrs At least n addresses.
+ * @param n Addresses wanted.
+ * @return Addresses read, 0 at the end, -1 on an invalid entry.
+ */
+static long read_addrs(struct addr_reader *ar, uint32_t *addrs, size_t n);
+
+/**
+ * @brief Match and print or count one stream.
+ * @param acl Compiled access list.
+ * @param opts Options.
+ * @param fp Source stream.
+ * @param ob Output buffer.
+ * @param hits Hits per entry, one more for no match.
+ * @return 0 on success, -1 on error.
+ */
+static int filter_stream(const struct acl *acl, const struct filter_opts *opts, FILE *fp,
+                         struct outbuf *ob, uint64_t *hits);
+
+/**
+ * @brief Format a number in decimal.
+ * @param dst Destination, at least 10 bytes. Not terminated.
+ * @param val Number.
+ * @return Pointer past the last written character.
+ */
+static char *format_u32(char *dst, uint32_t val);
+
+/**
+ * @brief Format an entry as ACL text.
+ * @param dst Destination, at least RULE_MAX_LEN bytes. Not terminated.
+ * @param e Entry.
+ * @return Pointer past the last written character.
+ */
+static char *format_rule(char *dst, const struct acl_entry *e);
+
+int filter_start(int argc, char **argv)
+{
+	struct filter_opts opts;
+	struct acl acl;
+	struct outbuf *ob = NULL;
+	uint64_t *hits = NULL;
+	char rule[RULE_MAX_LEN];
+	size_t file_cnt = 0;
+	long issues;
+	FILE *fp = NULL;
+	int res;
+
+	memset(&acl, 0, sizeof(struct acl));
+
+	if (process_filter_args(argc, argv, &opts) == -1) { return EXIT_FAILURE; }
+	if (load_acl(&acl, opts.acl) == -1) { goto handle_error; }
+
+	issues = report_issues(&acl, opts.check ? stdout : stderr);
+	if (issues == -1) { goto handle_error; }
+
+	if (opts.check) {
+		printf("%zu entries, %zu wildcard classes, %ld without effect\n",
+			   acl.len, acl.class_count, issues);
+		acl_free(&acl);
+		return EXIT_SUCCESS;
+	}
+
+	hits = calloc(acl.len + 1, sizeof(uint64_t));
+	ob = malloc(sizeof(struct outbuf));
+	if (!hits || !ob) { goto handle_error; }
+	outbuf_init(ob, stdout);
+
+	for (int i = 1; i < argc; i++) {
+		if (strncmp(argv[i], "--", 2) == 0) { continue; }
+
+		file_cnt++;
+		fp = fopen(argv[i], "r");
+		if (!fp) {
+			fprintf(stderr, "ipc: %s: %s\n", argv[i], strerror(errno));
+			goto handle_error;
+		}
+		res = filter_stream(&acl, &opts, fp, ob, hits);
+		fclose(fp);
+		if (res == -1) { goto handle_error; }
+	}
+
+	if (!file_cnt && filter_stream(&acl, &opts, stdin, ob, hits) == -1) { goto handle_error; }
+
+	if (opts.count) {
+		fprintf(ob->fp, "%-7s %-15s %s\n", "Entry", "Hits", "Rule");
+		for (size_t i = 0; i < acl.len; i++) {
+			*format_rule(rule, &acl.entries[i]) = '\0';
+			fprintf(ob->fp, "%-7zu %-15llu %s\n", i + 1, (unsigned long long) hits[i], rule);
+		}
+		fprintf(ob->fp, "%-7s %-15llu %s\n", "-", (unsigned long long) hits[acl.len],
+				"deny any (implicit)");
+	}
+
+	res = outbuf_flush(ob);
+
+	free(ob);
+	free(hits);
+	acl_free(&acl);
+
+	return res == -1 ? EXIT_INPUT : EXIT_SUCCESS;
+
+	handle_error:
+		free(ob);
+		free(hits);
+		acl_free(&acl);
+		return EXIT_INPUT;
+}
+
+static int process_filter_args(int argc, char **argv, struct filter_opts *opts)
+{
+	if (!argv || !opts || argc < 1) { return -1; }
+
+	memset(opts, 0, sizeof(struct filter_opts));
+	opts->acl = argv[0];
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--check") == 0) { opts->check = 1; }
+		else if (strcmp(argv[i], "--count") == 0) { opts->count = 1; }
+		else if (strcmp(argv[i], "--binary") == 0) { opts->binary = 1; }
+		else if (strncmp(argv[i], "--", 2) == 0) { return -1; }
+	}
+
+	return 0;
+}
+
+static int load_acl(struct acl *acl, const char *path)
+{
+	FILE *fp = NULL;
+	int res;
+
+	fp = fopen(path, "r");
+	if (!fp) {
+		fprintf(stderr, "ipc: %s: %s\n", path, strerror(errno));
+		return -1;
+	}
+
+	res = acl_read(acl, fp);
+	fclose(fp);
+
+	if (res == -1) {
+		fprintf(stderr, "ipc: %s: invalid entry %zu\n", path, acl->len + 1);
+		return -1;
+	}
+
+	return acl_compile(acl);
+}
+
+static long report_issues(const struct acl *acl, FILE *fp)
+{
+	struct acl_issue *issues = NULL;
+	char rule[RULE_MAX_LEN];
+	char by[RULE_MAX_LEN];
+	size_t len;
+
+	if (acl_check(acl, &issues, &len) == -1) { return -1; }
+
+	for (size_t i = 0; i < len; i++) {
+		*format_rule(rule, &acl->entries[issues[i].entry]) = '\0';
+		*format_rule(by, &acl->entries[issues[i].by]) = '\0';
+		fprintf(fp, "%s entry %u (%s) by %s entry %u (%s)\n",
+				issues[i].kind == acl_shadowed ? "shadowed:" : "redundant:",
+				issues[i].entry + 1, rule, issues[i].by < issues[i].entry ? "earlier" : "later",
+				issues[i].by + 1, by);
+	}
+
+	free(issues);
+	return (long) len;
+}
+
+static long read_addrs(struct addr_reader *ar, uint32_t *addrs, size_t n)
+{
+	unsigned char buf[FILTER_BATCH * 4];
+	struct prefix pfx;
+	char *tok = NULL;
+	size_t got;
+
+	if (ar->binary) {
+		got = fread(buf, 4, n < FILTER_BATCH ? n : FILTER_BATCH, ar->fp);
+		for (size_t i = 0; i < got; i++) {
+			addrs[i] = (uint32_t) buf[4 * i] << 24 | (uint32_t) buf[4 * i + 1] << 16 |
+					   (uint32_t) buf[4 * i + 2] << 8 | buf[4 * i + 3];
+		}
+		return (long) got;
+	}
+
+	for (got = 0; got < n && (tok = token_reader_next(&ar->rd)); got++) {
+		if (parse_prefix(tok, &pfx) == -1 || pfx.bitmask != 32) {
+			fprintf(stderr, "ipc: invalid entry '%s'\n", tok);
+			return -1;
+		}
+		addrs[got] = pfx.addr;
+	}
+
+	return (long) got;
+}
+
+static int filter_stream(const struct acl *acl, const struct filter_opts *opts, FILE *fp,
+                         struct outbuf *ob, uint64_t *hits)
+{
+	uint32_t addrs[FILTER_BATCH];
+	uint32_t match[FILTER_BATCH];
+	struct addr_reader ar;
+	const char *name = NULL;
+	char *dst = NULL;
+	uint32_t entry;
+	size_t len;
+	long n;
+
+	STATS_DECL(t);
+
+	ar.fp = fp;
+	ar.binary = opts->binary;
+	if (!ar.binary && token_reader_init(&ar.rd, fp) == -1) { return -1; }
+
+	while (1) {
+		STATS_MARK(t);
+
+		n = read_addrs(&ar, addrs, FILTER_BATCH);
+		if (n <= 0) { break; }
+
+		STATS_LAP(t, stage_parse);
+		STATS_ITEMS(n);
+
+		for (long i = 0; i < n; i++) { match[i] = acl_match(acl, addrs[i]); }
+
+		STATS_LAP(t, stage_derive);
+
+		for (long i = 0; i < n; i++) {
+			entry = match[i] == ACL_NO_MATCH ? acl->len : match[i];
+			hits[entry]++;
+			if (opts->count) { continue; }
+
+			dst = outbuf_reserve(ob, ADDR_STR_LEN + 40);
+			dst = format_addr_plain(dst, addrs[i]);
+			if (match[i] == ACL_NO_MATCH) {
+				memcpy(dst, " deny - ", 8);
+				dst += 8;
+			}
+			else if (acl->entries[entry].action == acl_permit) {
+				memcpy(dst, " permit ", 8);
+				dst = format_u32(dst + 8, entry + 1);
+				*dst++ = ' ';
+			}
+			else {
+				memcpy(dst, " deny ", 6);
+				dst = format_u32(dst + 6, entry + 1);
+				*dst++ = ' ';
+			}
+			name = special_name(special_classify(addrs[i]));
+			len = strlen(name);
+			memcpy(dst, name, len);
+			dst += len;
+			*dst++ = '\n';
+			ob->len = dst - ob->data;
+		}
+
+		STATS_LAP(t, stage_output);
+	}
+
+	if (!ar.binary) { token_reader_free(&ar.rd); }
+	if (n == -1) { return -1; }
+
+	if (ar.binary && ferror(fp)) {
+		fprintf(stderr, "ipc: %s\n", strerror(errno));
+		return -1;
+	}
+
+	return 0;
+}
+
+static char *format_u32(char *dst, uint32_t val)
+{
+	char tmp[10];
+	int n = 0;
+
+	do {
+		tmp[n++] = '0' + val % 10;
+		val /= 10;
+	} while (val);
+
+	while (n) { *dst++ = tmp[--n]; }
+
+	return dst;
+}
+
+static char *format_rule(char *dst, const struct acl_entry *e)
+{
+	const char *action = e->action == acl_permit ? "permit " : "deny ";
+
+	memcpy(dst, action, strlen(action));
+	dst += strlen(action);
+
+	if (e->wildcard == UINT32_MAX) {
+		memcpy(dst, "any", 3);
+		return dst + 3;
+	}
+
+	if (!e->wildcard) {
+		memcpy(dst, "host ", 5);
+		return format_addr_plain(dst + 5, e->addr);
+	}
+
+	dst = format_addr_plain(dst, e->addr);
+	*dst++ = ' ';
+
+	return format_addr_plain(dst, e->wildcard);
+}
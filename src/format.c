@@ -0,0 +1,131 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "format.h"
+
+/**
+ * @brief Write an octet without leading zeros.
+ * @param dst Destination.
+ * @param octet Octet value.
+ * @return Pointer past the last written character.
+ */
+static char *put_octet(char *dst, uint8_t octet);
+
+char *format_addr(char *dst, uint32_t addr)
+{
+	uint8_t octet;
+
+	for (int shift = 24; shift >= 0; shift -= 8) {
+		octet = addr >> shift & 0xFF;
+		dst[0] = '0' + octet / 100;
+		dst[1] = '0' + octet / 10 % 10;
+		dst[2] = '0' + octet % 10;
+		dst[3] = '.';
+		dst += 4;
+	}
+
+	/* No dot after the last octet */
+	return dst - 1;
+}
+
+char *format_addr_plain(char *dst, uint32_t addr)
+{
+	dst = put_octet(dst, addr >> 24);
+	*dst++ = '.';
+	dst = put_octet(dst, addr >> 16 & 0xFF);
+	*dst++ = '.';
+	dst = put_octet(dst, addr >> 8 & 0xFF);
+	*dst++ = '.';
+
+	return put_octet(dst, addr & 0xFF);
+}
+
+void outbuf_init(struct outbuf *ob, FILE *fp)
+{
+	if (!ob) { return; }
+
+	ob->fp = fp;
+	ob->len = 0;
+	ob->error = 0;
+
+	return;
+}
+
+char *outbuf_reserve(struct outbuf *ob, size_t n)
+{
+	if (ob->len + n > OUTBUF_SIZE) { outbuf_flush(ob); }
+
+	return ob->data + ob->len;
+}
+
+void outbuf_write(struct outbuf *ob, const void *data, size_t n)
+{
+	size_t part;
+
+	while (n) {
+		if (ob->len == OUTBUF_SIZE) { outbuf_flush(ob); }
+
+		part = OUTBUF_SIZE - ob->len;
+		if (part > n) { part = n; }
+
+		memcpy(ob->data + ob->len, data, part);
+		ob->len += part;
+		data = (const char *) data + part;
+		n -= part;
+	}
+
+	return;
+}
+
+int outbuf_flush(struct outbuf *ob)
+{
+	if (!ob) { return -1; }
+
+	if (ob->len && fwrite(ob->data, 1, ob->len, ob->fp) != ob->len) {
+		ob->error = 1;
+	}
+	ob->len = 0;
+
+	if (fflush(ob->fp) == EOF) { ob->error = 1; }
+
+	return ob->error ? -1 : 0;
+}
+
+static char *put_octet(char *dst, uint8_t octet)
+{
+	if (octet >= 100) {
+		dst[0] = '0' + octet / 100;
+		dst[1] = '0' + octet / 10 % 10;
+		dst[2] = '0' + octet % 10;
+		return dst + 3;
+	}
+
+	if (octet >= 10) {
+		dst[0] = '0' + octet / 10;
+		dst[1] = '0' + octet % 10;
+		return dst + 2;
+	}
+
+	dst[0] = '0' + octet;
+
+	return dst + 1;
+}
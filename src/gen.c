@@ -0,0 +1,533 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+
+#include "fill_ipv4.h"
+#include "prefix_list.h"
+#include "prng.h"
+#include "format.h"
+#include "status.h"
+#include "gen.h"
+
+#define GEN_SEED			1
+#define GEN_CLUSTERS		4096
+#define GEN_SKEW			1.0
+#define GEN_NESTED			10				/* Percent */
+#define GEN_RECENT			1024			/* Entries nested prefixes derive from */
+#define LENGTH_LUT_BITS		12
+#define LENGTH_LUT_SIZE		(1 << LENGTH_LUT_BITS)
+#define LINE_MAX_LEN		20				/* "255.255.255.255/32\n" */
+#define GEN_RETRIES			16				/* Popular draws before spilling */
+#define GEN_TRIES_MAX		1024			/* Draws before a duplicate is kept */
+#define SEEN_PAGE_BITS		15				/* 4 KiB pages of the seen bitmap */
+#define SEEN_PAGES			((size_t) 1 << (BITS_IN_IP + 1 - SEEN_PAGE_BITS))
+
+/*
+ * Share of each prefix length in a public BGP table, per 10000.
+ * /24 dominates, /22 and /23 follow, little beyond /24.
+ */
+static const uint16_t length_weights[BITS_IN_IP + 1] = {
+	[8] = 2, [9] = 1, [10] = 3, [11] = 8, [12] = 15, [13] = 30, [14] = 50,
+	[15] = 80, [16] = 140, [17] = 120, [18] = 200, [19] = 330, [20] = 480,
+	[21] = 550, [22] = 1050, [23] = 900, [24] = 5924, [25] = 20, [26] = 25,
+	[27] = 15, [28] = 20, [29] = 15, [30] = 15, [31] = 2, [32] = 5
+};
+
+/**
+ * @enum gen_kind
+ * @brief Kind of dataset.
+ */
+enum gen_kind { gen_prefixes, gen_addresses };
+
+/**
+ * @struct gen_opts
+ * @brief Options of the generator.
+ */
+struct gen_opts {
+    enum gen_kind kind;             /**< Dataset kind */
+    uint64_t count;                 /**< Lines to write */
+    uint64_t seed;                  /**< Generator seed */
+    size_t clusters;                /**< Allocation blocks */
+    double skew;                    /**< Zipf exponent */
+    unsigned nested;                /**< Percent of derived prefixes */
+    const char *table;              /**< Blocks from a file, or NULL */
+    int unique;                     /**< Draw again until a prefix is new */
+};
+
+/**
+ * @struct cluster_set
+ * @brief Allocation blocks that entries are drawn from.
+ */
+struct cluster_set {
+    struct prefix *items;           /**< Blocks */
+    size_t len;                     /**< Number of blocks */
+    struct prng_alias pick;         /**< Block popularity, Zipf over the index */
+};
+
+/**
+ * @struct seen_set
+ * @brief Prefixes written so far, one bit each.
+ *
+ * addr/len is bit 2^len + (addr >> (32 - len)), the layout of a binary
+ * heap over the address space. The 2^33 bits are split in pages
+ * allocated on first use, so only the blocks entries come from cost
+ * memory.
+ */
+struct seen_set {
+    uint64_t **pages;               /**< SEEN_PAGES pages, NULL if untouched */
+};
+
+/**
+ * @brief Parse the options of the generator.
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ * @param[out] opts Parsed options.
+ * @return 0 on success, -1 on error.
+ */
+static int process_gen_args(int argc, char **argv, struct gen_opts *opts);
+
+/**
+ * @brief Make random allocation blocks, /10 to /16.
+ * @param set Blocks to fill.
+ * @param len Number of blocks.
+ * @param rng Generator.
+ * @return 0 on success, -1 on error.
+ */
+static int make_clusters(struct cluster_set *set, size_t len, struct prng *rng);
+
+/**
+ * @brief Take the allocation blocks from a prefix file.
+ * @param set Blocks to fill.
+ * @param path File.
+ * @return 0 on success, -1 on error.
+ */
+static int load_clusters(struct cluster_set *set, const char *path);
+
+/**
+ * @brief Set up Zipf popularity, block i has weight 1 / (i + 1)^skew.
+ * @param set Blocks.
+ * @param skew Exponent.
+ * @return 0 on success, -1 on error.
+ */
+static int zipf_init(struct cluster_set *set, double skew);
+
+/**
+ * @brief Draw a block by popularity.
+ * @param set Blocks.
+ * @param rng Generator.
+ * @return Block.
+ */
+static const struct prefix *draw_cluster(const struct cluster_set *set, struct prng *rng);
+
+/**
+ * @brief Mark a prefix as written.
+ * @param seen Written prefixes.
+ * @param pfx Prefix, host bits clear.
+ * @return 1 if it was new, 0 if already written, -1 on no memory.
+ */
+static int seen_add(struct seen_set *seen, const struct prefix *pfx);
+
+/**
+ * @brief Free the written prefixes.
+ * @param seen Written prefixes.
+ */
+static void seen_free(struct seen_set *seen);
+
+/**
+ * @brief Write the prefix table.
+ *
+ * Draws may repeat a prefix. With opts->unique a duplicate is drawn
+ * again: popular blocks fill up, so after GEN_RETRIES draws the entry
+ * spills to a block picked uniformly, one bit longer with every further
+ * draw. Tracking the written prefixes costs a bit each in pages of the
+ * touched blocks, about 7 bytes per prefix, and the redraws and cache
+ * misses make it several times slower.
+ *
+ * @param ob Output buffer.
+ * @param opts Options.
+ * @param set Blocks.
+ * @param rng Generator.
+ * @return 0 on success, -1 on no memory.
+ */
+static int write_prefixes(struct outbuf *ob, const struct gen_opts *opts,
+                          const struct cluster_set *set, struct prng *rng);
+
+/**
+ * @brief Write the address stream.
+ * @param ob Output buffer.
+ * @param opts Options.
+ * @param set Blocks.
+ * @param rng Generator.
+ */
+static void write_addresses(struct outbuf *ob, const struct gen_opts *opts,
+                            const struct cluster_set *set, struct prng *rng);
+
+int gen_start(int argc, char **argv)
+{
+	struct gen_opts opts;
+	struct cluster_set set;
+	struct prng rng;
+	struct outbuf *ob = NULL;
+	int res;
+
+	memset(&set, 0, sizeof(struct cluster_set));
+
+	if (process_gen_args(argc, argv, &opts) == -1) { return EXIT_FAILURE; }
+
+	prng_seed(&rng, opts.seed);
+
+	if (opts.table) { res = load_clusters(&set, opts.table); }
+	else { res = make_clusters(&set, opts.clusters, &rng); }
+	if (res == -1) { goto handle_error; }
+
+	if (zipf_init(&set, opts.skew) == -1) { goto handle_error; }
+
+	ob = malloc(sizeof(struct outbuf));
+	if (!ob) { goto handle_error; }
+	outbuf_init(ob, stdout);
+
+	if (opts.kind == gen_prefixes) { res = write_prefixes(ob, &opts, &set, &rng); }
+	else { write_addresses(ob, &opts, &set, &rng); }
+
+	if (outbuf_flush(ob) == -1) { res = -1; }
+
+	free(ob);
+	free(set.items);
+	prng_alias_free(&set.pick);
+
+	return res == -1 ? EXIT_INPUT : EXIT_SUCCESS;
+
+	handle_error:
+		free(ob);
+		free(set.items);
+		prng_alias_free(&set.pick);
+		return EXIT_INPUT;
+}
+
+static int process_gen_args(int argc, char **argv, struct gen_opts *opts)
+{
+	unsigned long long val;
+	char *endptr = NULL;
+
+	if (!argv || !opts || argc < 2) { return -1; }
+
+	memset(opts, 0, sizeof(struct gen_opts));
+	opts->seed = GEN_SEED;
+	opts->clusters = GEN_CLUSTERS;
+	opts->skew = GEN_SKEW;
+	opts->nested = GEN_NESTED;
+
+	if (strcmp(argv[0], "prefixes") == 0) { opts->kind = gen_prefixes; }
+	else if (strcmp(argv[0], "addresses") == 0) { opts->kind = gen_addresses; }
+	else { return -1; }
+
+	/* strtoull accepts a sign, the count must not have one */
+	if (argv[1][0] < '0' || argv[1][0] > '9') { return -1; }
+	errno = 0;
+	val = strtoull(argv[1], &endptr, 10);
+	if (errno == ERANGE || *endptr != '\0') { return -1; }
+	opts->count = val;
+
+	for (int i = 2; i < argc; i++) {
+		if (strcmp(argv[i], "--unique") == 0) {
+			opts->unique = 1;
+			continue;
+		}
+
+		if (i + 1 >= argc) { return -1; }
+
+		if (strcmp(argv[i], "--skew") == 0) {
+			errno = 0;
+			opts->skew = strtod(argv[++i], &endptr);
+			if (errno == ERANGE || *endptr != '\0' || opts->skew < 0) { return -1; }
+			continue;
+		}
+
+		if (strcmp(argv[i], "--table") == 0) {
+			opts->table = argv[++i];
+			continue;
+		}
+
+		if (argv[i + 1][0] < '0' || argv[i + 1][0] > '9') { return -1; }
+		errno = 0;
+		val = strtoull(argv[i + 1], &endptr, 0);
+		if (errno == ERANGE || *endptr != '\0') { return -1; }
+
+		if (strcmp(argv[i], "--seed") == 0) { opts->seed = val; }
+		else if (strcmp(argv[i], "--clusters") == 0) {
+			if (!val || val > ((uint64_t) 1 << 24)) { return -1; }
+			opts->clusters = val;
+		}
+		else if (strcmp(argv[i], "--nested") == 0) {
+			if (val > 100) { return -1; }
+			opts->nested = val;
+		}
+		else { return -1; }
+
+		i++;
+	}
+
+	return 0;
+}
+
+static int make_clusters(struct cluster_set *set, size_t len, struct prng *rng)
+{
+	uint32_t addr;
+	uint8_t bitmask;
+
+	set->items = malloc(len * sizeof(struct prefix));
+	if (!set->items) { return -1; }
+	set->len = len;
+
+	for (size_t i = 0; i < len; i++) {
+		/* Unicast space only: first octet 1..223 */
+		addr = (uint32_t) (1 + prng_bounded(rng, 223)) << 24 | (uint32_t) prng_next(rng) >> 8;
+		bitmask = 10 + prng_bounded(rng, 7);
+
+		set->items[i].addr = addr & prefix_netmask(bitmask);
+		set->items[i].bitmask = bitmask;
+	}
+
+	return 0;
+}
+
+static int load_clusters(struct cluster_set *set, const char *path)
+{
+	struct token_reader rd;
+	struct prefix *new_items = NULL;
+	size_t cap = 0;
+	char *tok = NULL;
+	FILE *fp = NULL;
+
+	fp = fopen(path, "r");
+	if (!fp) {
+		fprintf(stderr, "ipc: %s: %s\n", path, strerror(errno));
+		return -1;
+	}
+
+	if (token_reader_init(&rd, fp) == -1) {
+		fclose(fp);
+		return -1;
+	}
+
+	while ((tok = token_reader_next(&rd))) {
+		if (set->len == cap) {
+			cap = cap ? cap * 2 : 1024;
+			new_items = realloc(set->items, cap * sizeof(struct prefix));
+			if (!new_items) { goto handle_error; }
+			set->items = new_items;
+		}
+
+		if (parse_prefix(tok, &set->items[set->len]) == -1) {
+			fprintf(stderr, "ipc: invalid entry '%s'\n", tok);
+			goto handle_error;
+		}
+		set->items[set->len].addr &= prefix_netmask(set->items[set->len].bitmask);
+		set->len++;
+	}
+
+	token_reader_free(&rd);
+	fclose(fp);
+
+	if (!set->len) {
+		fprintf(stderr, "ipc: %s: no prefixes\n", path);
+		return -1;
+	}
+
+	return 0;
+
+	handle_error:
+		token_reader_free(&rd);
+		fclose(fp);
+		return -1;
+}
+
+static int zipf_init(struct cluster_set *set, double skew)
+{
+	double *weights = NULL;
+	int res;
+
+	weights = malloc(set->len * sizeof(double));
+	if (!weights) { return -1; }
+
+	for (size_t i = 0; i < set->len; i++) { weights[i] = pow(i + 1, -skew); }
+
+	res = prng_alias_init(&set->pick, weights, set->len);
+	free(weights);
+
+	return res;
+}
+
+static const struct prefix *draw_cluster(const struct cluster_set *set, struct prng *rng)
+{
+	uint64_t r = prng_next(rng);
+
+	/* High half picks the column, low half is the coin */
+	return &set->items[prng_alias_pick(&set->pick, ((r >> 32) * set->len) >> 32, (uint32_t) r)];
+}
+
+static int seen_add(struct seen_set *seen, const struct prefix *pfx)
+{
+	uint64_t bit = ((uint64_t) 1 << pfx->bitmask) +
+				   (pfx->bitmask ? pfx->addr >> (BITS_IN_IP - pfx->bitmask) : 0);
+	uint64_t **page = &seen->pages[bit >> SEEN_PAGE_BITS];
+	uint64_t *word = NULL;
+	uint64_t mask;
+
+	if (!*page) {
+		*page = calloc((size_t) 1 << (SEEN_PAGE_BITS - 6), sizeof(uint64_t));
+		if (!*page) { return -1; }
+	}
+
+	word = &(*page)[(bit & (((uint64_t) 1 << SEEN_PAGE_BITS) - 1)) >> 6];
+	mask = (uint64_t) 1 << (bit & 63);
+	if (*word & mask) { return 0; }
+	*word |= mask;
+
+	return 1;
+}
+
+static void seen_free(struct seen_set *seen)
+{
+	if (!seen->pages) { return; }
+
+	for (size_t i = 0; i < SEEN_PAGES; i++) { free(seen->pages[i]); }
+	free(seen->pages);
+	seen->pages = NULL;
+
+	return;
+}
+
+static int write_prefixes(struct outbuf *ob, const struct gen_opts *opts,
+                          const struct cluster_set *set, struct prng *rng)
+{
+	uint8_t lut[LENGTH_LUT_SIZE];
+	struct prefix recent[GEN_RECENT];
+	struct prefix pfx;
+	struct seen_set seen;
+	const struct prefix *base = NULL;
+	size_t recent_len = 0;
+	size_t fill = 0, share;
+	unsigned tries, len;
+	uint64_t r;
+	char *dst = NULL;
+	char *p = NULL;
+	int up, res = 0;
+
+	seen.pages = NULL;
+	if (opts->unique) {
+		seen.pages = calloc(SEEN_PAGES, sizeof(uint64_t *));
+		if (!seen.pages) { return -1; }
+	}
+
+	/* Length draws become one table lookup */
+	for (int l = 0; l <= BITS_IN_IP; l++) {
+		share = (size_t) length_weights[l] * LENGTH_LUT_SIZE / 10000;
+		for (size_t i = 0; i < share && fill < LENGTH_LUT_SIZE; i++) { lut[fill++] = l; }
+	}
+	while (fill < LENGTH_LUT_SIZE) { lut[fill++] = 24; }
+
+	for (uint64_t i = 0; i < opts->count && !ob->error; i++) {
+		/* A table of a few tiny blocks runs out of new prefixes, then repeats */
+		for (tries = 0, res = 0; tries < GEN_TRIES_MAX && !res; tries++) {
+			r = prng_next(rng);
+
+			if (tries >= GEN_RETRIES) {
+				/* Spill: any block, one bit longer with every draw */
+				len = lut[r & (LENGTH_LUT_SIZE - 1)] + (tries - GEN_RETRIES);
+				pfx.bitmask = len < BITS_IN_IP ? len : BITS_IN_IP;
+				base = &set->items[prng_bounded(rng, set->len)];
+				pfx.addr = base->addr | ((uint32_t) (r >> 32) & ~prefix_netmask(base->bitmask));
+			}
+			else if (recent_len && r % 100 < opts->nested) {
+				/* More specific inside, or a cover of, a recent entry */
+				base = &recent[(r >> 8) % recent_len];
+				up = base->bitmask == BITS_IN_IP || (base->bitmask > 8 && (r >> 40 & 1));
+
+				if (up) {
+					pfx.bitmask = base->bitmask - 1 -
+								  (r >> 41) % (base->bitmask - 8 < 4 ? base->bitmask - 8 : 4);
+				}
+				else {
+					pfx.bitmask = base->bitmask + 1 + (r >> 41) %
+								  (BITS_IN_IP - base->bitmask < 8 ? BITS_IN_IP - base->bitmask : 8);
+				}
+				pfx.addr = base->addr | ((uint32_t) prng_next(rng) & ~prefix_netmask(base->bitmask));
+			}
+			else {
+				pfx.bitmask = lut[r & (LENGTH_LUT_SIZE - 1)];
+				base = draw_cluster(set, rng);
+				pfx.addr = base->addr | ((uint32_t) (r >> 32) & ~prefix_netmask(base->bitmask));
+			}
+
+			pfx.addr &= prefix_netmask(pfx.bitmask);
+
+			res = opts->unique ? seen_add(&seen, &pfx) : 1;
+			if (res == -1) { goto handle_error; }
+		}
+
+		recent[recent_len < GEN_RECENT ? recent_len++ : (r >> 16) % GEN_RECENT] = pfx;
+
+		dst = outbuf_reserve(ob, LINE_MAX_LEN);
+		p = format_addr_plain(dst, pfx.addr);
+		*p++ = '/';
+		if (pfx.bitmask >= 10) { *p++ = '0' + pfx.bitmask / 10; }
+		*p++ = '0' + pfx.bitmask % 10;
+		*p++ = '\n';
+		ob->len += p - dst;
+	}
+
+	seen_free(&seen);
+	return 0;
+
+	handle_error:
+		seen_free(&seen);
+		return -1;
+}
+
+static void write_addresses(struct outbuf *ob, const struct gen_opts *opts,
+                            const struct cluster_set *set, struct prng *rng)
+{
+	const struct prefix *base = NULL;
+	uint64_t size, u, offset;
+	char *dst = NULL;
+	char *p = NULL;
+
+	for (uint64_t i = 0; i < opts->count && !ob->error; i++) {
+		base = draw_cluster(set, rng);
+		size = prefix_size(base->bitmask);
+
+		/* u^2 on [0, 1) favours the low hosts of a block */
+		u = prng_next(rng) >> 32;
+		offset = (((u * u) >> 32) * size) >> 32;
+
+		dst = outbuf_reserve(ob, LINE_MAX_LEN);
+		p = format_addr_plain(dst, base->addr + (uint32_t) offset);
+		*p++ = '\n';
+		ob->len += p - dst;
+	}
+
+	return;
+}
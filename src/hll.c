@@ -0,0 +1,65 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+
+#include "hll.h"
+
+void hll_merge(uint8_t *dst, const uint8_t *src, int p)
+{
+	size_t m = (size_t) 1 << p;
+
+	for (size_t i = 0; i < m; i++) {
+		if (src[i] > dst[i]) { dst[i] = src[i]; }
+	}
+
+	return;
+}
+
+double hll_estimate(const uint8_t *regs, int p)
+{
+	size_t m = (size_t) 1 << p;
+	size_t zeros = 0;
+	double sum = 0.0, alpha, est;
+
+	for (size_t i = 0; i < m; i++) {
+		sum += ldexp(1.0, -regs[i]);
+		zeros += !regs[i];
+	}
+
+	/* Flajolet et al., bias constant of the harmonic mean */
+	switch (m) {
+		case 16: alpha = 0.673; break;
+		case 32: alpha = 0.697; break;
+		case 64: alpha = 0.709; break;
+		default: alpha = 0.7213 / (1.0 + 1.079 / m); break;
+	}
+	est = alpha * m * m / sum;
+
+	/* 64-bit hashes need no large range correction */
+	if (est <= 2.5 * m && zeros) { est = m * log((double) m / zeros); }
+
+	return est;
+}
+
+double hll_error(int p)
+{
+	return 1.04 / sqrt((double) ((size_t) 1 << p));
+}
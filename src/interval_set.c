@@ -0,0 +1,170 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "prefix_list.h"
+#include "sort.h"
+#include "prefix_file.h"
+#include "interval_set.h"
+
+/**
+ * @brief Add every prefix of a compiled set.
+ * @param set Set to fill.
+ * @param fp Stream at offset 0 holding a compiled set.
+ * @return 0 on success, INTERVAL_SET_DAMAGED on a damaged set, -1 on
+ *         other errors.
+ *
+ * @see prefix_file_map
+ */
+static int read_compiled(struct interval_set *set, FILE *fp);
+
+int interval_set_add(struct interval_set *set, uint32_t first, uint32_t last)
+{
+	uint64_t *new_keys = NULL;
+	size_t new_cap;
+
+	if (!set || first > last) { return -1; }
+
+	if (set->len == set->cap) {
+		new_cap = set->cap ? set->cap * 2 : 4096;
+		new_keys = realloc(set->keys, new_cap * sizeof(uint64_t));
+		if (!new_keys) { return -1; }
+		set->keys = new_keys;
+		set->cap = new_cap;
+	}
+
+	set->keys[set->len++] = (uint64_t) first << 32 | last;
+
+	return 0;
+}
+
+int interval_set_read(struct interval_set *set, FILE *fp, char *bad, size_t size)
+{
+	struct token_reader rd;
+	uint32_t first, last;
+	char *tok = NULL;
+
+	if (!set || !fp) { return -1; }
+
+	if (prefix_file_sniff(fp)) { return read_compiled(set, fp); }
+
+	if (token_reader_init(&rd, fp) == -1) { return -1; }
+
+	while ((tok = token_reader_next(&rd))) {
+		if (parse_interval(tok, &first, &last) == -1) { goto handle_invalid; }
+		if (interval_set_add(set, first, last) == -1) { goto handle_error; }
+	}
+
+	token_reader_free(&rd);
+	return 0;
+
+	handle_invalid:
+		if (bad && size) { snprintf(bad, size, "%s", tok); }
+		token_reader_free(&rd);
+		return INTERVAL_SET_INVALID;
+
+	handle_error:
+		token_reader_free(&rd);
+		return -1;
+}
+
+int interval_set_sort(struct interval_set *set)
+{
+	if (!set) { return -1; }
+
+	return sort_u64(set->keys, set->len);
+}
+
+uint64_t interval_set_merge(struct interval_set *set)
+{
+	uint64_t total = 0;
+	uint32_t first, last, cur_first, cur_last;
+	size_t blocks = 0;
+
+	if (!set || !set->len) { return 0; }
+
+	cur_first = set->keys[0] >> 32;
+	cur_last = (uint32_t) set->keys[0];
+
+	for (size_t i = 1; i < set->len; i++) {
+		first = set->keys[i] >> 32;
+		last = (uint32_t) set->keys[i];
+
+		/* Adjacent blocks are merged as well as overlapping ones */
+		if ((uint64_t) first <= (uint64_t) cur_last + 1) {
+			if (last > cur_last) { cur_last = last; }
+			continue;
+		}
+
+		total += (uint64_t) cur_last - cur_first + 1;
+		set->keys[blocks++] = (uint64_t) cur_first << 32 | cur_last;
+		cur_first = first;
+		cur_last = last;
+	}
+
+	total += (uint64_t) cur_last - cur_first + 1;
+	set->keys[blocks++] = (uint64_t) cur_first << 32 | cur_last;
+	set->len = blocks;
+
+	return total;
+}
+
+void interval_set_free(struct interval_set *set)
+{
+	if (!set) { return; }
+
+	free(set->keys);
+	memset(set, 0, sizeof(struct interval_set));
+
+	return;
+}
+
+static int read_compiled(struct interval_set *set, FILE *fp)
+{
+	struct prefix buf[PREFIX_FILE_BLOCK];
+	struct prefix_file pf;
+	size_t n;
+
+	if (prefix_file_map(&pf, fileno(fp)) == -1) { return INTERVAL_SET_DAMAGED; }
+
+	for (uint32_t b = 0; b < pf.hdr->block_count; b++) {
+		n = prefix_file_block(&pf, b, buf);
+		if (!n) {
+			prefix_file_close(&pf);
+			return INTERVAL_SET_DAMAGED;
+		}
+
+		for (size_t i = 0; i < n; i++) {
+			if (interval_set_add(set, buf[i].addr,
+								 buf[i].addr | ~prefix_netmask(buf[i].bitmask)) == -1) {
+				goto handle_error;
+			}
+		}
+	}
+
+	prefix_file_close(&pf);
+	return 0;
+
+	handle_error:
+		prefix_file_close(&pf);
+		return -1;
+}
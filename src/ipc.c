@@ -0,0 +1,371 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ipv4_t.h"
+#include "fill_ipv4.h"
+#include "prefix_list.h"
+#include "format.h"
+#include "special.h"
+#include "ipc.h"
+
+/**
+ * @brief Format one DEC/BIN/HEX row of the report.
+ * 
+ * @param buf Destination buffer.
+ * @param size Size of buf.
+ * @param name Row title.
+ * @param oct Octets to show.
+ * @param pad Append the column padding after the HEX value.
+ * 
+ * @return Number of characters written, or -1 on error.
+ */
+static int format_row(char *buf, size_t size, const char *name,
+					  const uint8_t *oct, int pad);
+
+/**
+ * @brief Format the special-purpose class row of the report.
+ * @param buf Destination buffer.
+ * @param size Size of buf.
+ * @param cls Class of the address.
+ * @return Number of characters written, or -1 on error.
+ */
+static int format_class(char *buf, size_t size, uint8_t cls);
+
+/**
+ * @brief Parse the network of a split.
+ * @param cidr Network in CIDR notation.
+ * @param[out] base Network address, host bits cleared.
+ * @param[out] bitmask Mask length.
+ * @return 0 on success, -1 on error.
+ */
+static int parse_network(const char *cidr, uint32_t *base, uint8_t *bitmask);
+
+/**
+ * @brief Calculates the minimal power-of-two exponent to accommodate a given number.
+ * @param target The required minimum capacity.
+ * @return The smallest integer k such that 2^k >= target, or 0 if target <= 1.
+ */
+static int min_power_of_two(uint64_t target);
+
+/**
+ * @brief Format a number in decimal.
+ * @param dst Destination, at least 20 bytes. Not terminated.
+ * @param val Number.
+ * @return Pointer past the last written character.
+ */
+static char *format_uint(char *dst, uint64_t val);
+
+/* 
+ * For qsort in ipc_split_part.
+ * Sorts in descending order.
+ */
+static int compare(const void *p1, const void *p2) 
+{ return *(const int *) p2 - *(const int *) p1; }
+
+int ipc_analyze(ipv4_t *ip, const char *cidr)
+{
+	uint32_t addr, mask, network, broadcast;
+
+	if (!ip || !cidr) { return -1; }
+
+	memset(ip, 0, sizeof(ipv4_t));
+
+	if (!fill_addr(ip, cidr)) { return -1; }
+	if (!fill_bitmask(ip, cidr)) { return -1; }
+
+	/* Same results as the fill_* chain, computed on whole words */
+	addr = addr_to_u32(ip->addr);
+	mask = prefix_netmask(ip->bitmask);
+	network = addr & mask;
+	broadcast = network | ~mask;
+
+	u32_to_addr(mask, ip->netmask);
+	u32_to_addr(~mask, ip->wildcard);
+	u32_to_addr(network, ip->network);
+	u32_to_addr(broadcast, ip->broadcast);
+	ip->netmask_set = 1;
+	ip->wildcard_set = 1;
+	ip->network_set = 1;
+	ip->broadcast_set = 1;
+	/* A prefix may reach past the registry entry of its address */
+	ip->special = ip->bitmask == BITS_IN_IP ? special_classify(addr)
+											: special_classify_prefix(network, ip->bitmask);
+
+	if (ip->is_host_route) {
+		u32_to_addr(network, ip->hostmin);
+		u32_to_addr(network, ip->hostmax);
+		ip->hostcnt = 1;
+	}
+	else if (ip->is_point_to_point) {
+		u32_to_addr(network, ip->hostmin);
+		u32_to_addr(network + 1, ip->hostmax);
+		ip->hostcnt = 2;
+	}
+	else {
+		u32_to_addr(network + 1, ip->hostmin);
+		u32_to_addr(broadcast - 1, ip->hostmax);
+		ip->hostcnt = prefix_size(ip->bitmask) - 2; /* network and broadcast */
+	}
+
+	return 0;
+}
+
+int ipc_format_analysis(const ipv4_t *ip, char *buf, size_t size)
+{
+	size_t len = 0;
+	int res;
+
+	if (!ip || !buf) { return -1; }
+
+/* Append to buf, fail if it does not fit */
+#define APPEND(call)												\
+	do {															\
+		res = (call);												\
+		if (res < 0 || (size_t) res >= size - len) { return -1; }	\
+		len += res;													\
+	} while (0)
+
+	/* Title */
+	APPEND(snprintf(buf + len, size - len, "%15s%-20s%-40s%-11s\n", "", "DEC", "BIN", "HEX"));
+
+	APPEND(format_row(buf + len, size - len, "Addr", ip->addr, 0));
+	APPEND(snprintf(buf + len, size - len, "%-15s%d\n", "Bitmask", ip->bitmask));
+	APPEND(format_row(buf + len, size - len, "Netmask", ip->netmask, 1));
+	APPEND(format_row(buf + len, size - len, "Wildcard", ip->wildcard, 1));
+
+	/* No network and broadcast for /31 and /32 */
+	if (ip->is_point_to_point || ip->is_host_route) {
+		APPEND(snprintf(buf + len, size - len, "%-15s%s\n", "Network", "No network"));
+		APPEND(snprintf(buf + len, size - len, "%-15s%s\n", "Broadcast", "No broadcast"));
+	}
+	else {
+		APPEND(format_row(buf + len, size - len, "Network", ip->network, 1));
+		APPEND(format_row(buf + len, size - len, "Broadcast", ip->broadcast, 1));
+	}
+
+	APPEND(format_row(buf + len, size - len, "Hostmin", ip->hostmin, 1));
+	APPEND(format_row(buf + len, size - len, "Hostmax", ip->hostmax, 1));
+	APPEND(snprintf(buf + len, size - len, "%-15s%ld\n", "Hosts", ip->hostcnt));
+	APPEND(format_class(buf + len, size - len, ip->special));
+
+#undef APPEND
+
+	return (int) len;
+}
+
+int ipc_split_equal(struct ipc_split *sp, const char *cidr, uint64_t count)
+{
+	int pow;
+
+	if (!sp || !cidr || !count) { return -1; }
+
+	memset(sp, 0, sizeof(struct ipc_split));
+
+	if (parse_network(cidr, &sp->base, &sp->bitmask) == -1) { return -1; }
+
+	/* Past 2^32 no network fits, and min_power_of_two would shift by 64 */
+	if (count > prefix_size(0)) { return -1; }
+
+	pow = min_power_of_two(count);
+	if (sp->bitmask + pow > BITS_IN_IP - 1) { return -1; }
+
+	sp->sub_bitmask = sp->bitmask + pow;
+	sp->count = count;
+
+	return 0;
+}
+
+int ipc_split_part(struct ipc_split *sp, const char *cidr, int *parts, size_t len)
+{
+	uint64_t demand = 0;
+	int pow;
+
+	if (!sp || !cidr || !parts || !len) { return -1; }
+
+	memset(sp, 0, sizeof(struct ipc_split));
+
+	for (size_t i = 0; i < len; i++) {
+		if (parts[i] <= 0) { return -1; }
+	}
+
+	if (parse_network(cidr, &sp->base, &sp->bitmask) == -1) { return -1; }
+
+	qsort(parts, len, sizeof(int), compare);
+
+	for (size_t i = 0; i < len; i++) {
+		pow = min_power_of_two(parts[i]);
+		demand += (uint64_t) 1 << pow;
+		sp->runs[pow]++;
+	}
+	if (demand > prefix_size(sp->bitmask)) { return -1; }
+
+	/* Sorted parts: the first runs[k] are the ones of 2^k or more */
+	for (int k = BITS_IN_IP - 1; k >= 0; k--) { sp->runs[k] += sp->runs[k + 1]; }
+
+	sp->parts = parts;
+	sp->count = len;
+
+	return 0;
+}
+
+int ipc_split_next(struct ipc_split *sp, struct ipc_subnet *out)
+{
+	uint8_t bitmask;
+	uint64_t size;
+
+	if (!sp || !out) { return 0; }
+	if (sp->pos >= sp->count) { return 0; }
+
+	bitmask = sp->parts ? BITS_IN_IP - min_power_of_two(sp->parts[sp->pos])
+						: sp->sub_bitmask;
+	size = prefix_size(bitmask);
+
+	out->first = sp->base + (uint32_t) sp->offset;
+	out->last = out->first + (uint32_t) (size - 1);
+	out->bitmask = bitmask;
+
+	sp->offset += size;
+	sp->pos++;
+
+	return 1;
+}
+
+size_t ipc_split_fill(struct ipc_split *sp, struct ipc_subnet *arr, size_t n)
+{
+	size_t done = 0;
+
+	if (!sp || !arr) { return 0; }
+
+	while (done < n && ipc_split_next(sp, &arr[done])) { done++; }
+
+	return done;
+}
+
+int ipc_split_seek(struct ipc_split *sp, uint64_t idx)
+{
+	uint64_t n, prev = 0;
+
+	if (!sp || idx > sp->count) { return -1; }
+
+	if (!sp->parts) {
+		sp->offset = idx * prefix_size(sp->sub_bitmask);
+	}
+	else {
+		/* Subnets before idx, largest size first */
+		sp->offset = 0;
+		for (int k = BITS_IN_IP; k >= 0; k--) {
+			n = idx < sp->runs[k] ? idx : sp->runs[k];
+			sp->offset += (n - prev) << k;
+			prev = n;
+		}
+	}
+	sp->pos = idx;
+
+	return 0;
+}
+
+int ipc_format_subnet(const struct ipc_subnet *sn, uint64_t idx, char *buf, size_t size)
+{
+	char *p = buf;
+
+	if (!sn || !buf || size < IPC_SUBNET_ROW_MAX) { return -1; }
+
+	/* Row number is left-aligned in a column of at least 5 */
+	p = format_uint(p, idx);
+	while (p - buf < 5) { *p++ = ' '; }
+
+	p = format_addr(p, sn->first);
+	memset(p, ' ', 5);
+	p = format_addr(p + 5, sn->last);
+	memset(p, ' ', 5);
+	p += 5;
+
+	p = format_uint(p, sn->bitmask);
+	*p++ = '\n';
+
+	return (int) (p - buf);
+}
+
+static int format_row(char *buf, size_t size, const char *name,
+					  const uint8_t *oct, int pad)
+{
+	return snprintf(buf, size,
+					"%-15s%03d.%03d.%03d.%03d%5s"
+					"%08b.%08b.%08b.%08b%5s"
+					"%02x.%02x.%02x.%02x%s\n",
+					name, oct[0], oct[1], oct[2], oct[3], "",
+					oct[0], oct[1], oct[2], oct[3], "",
+					oct[0], oct[1], oct[2], oct[3], pad ? "     " : "");
+}
+
+static int format_class(char *buf, size_t size, uint8_t cls)
+{
+	const struct special_info *info = NULL;
+
+	if (cls >= SPECIAL_CLASSES) { cls = special_none; }
+	info = &special_registry[cls];
+
+	if (!info->rfc) { return snprintf(buf, size, "%-15s%s\n", "Class", info->name); }
+
+	return snprintf(buf, size, "%-15s%s (%s)\n", "Class", info->name, info->rfc);
+}
+
+static int parse_network(const char *cidr, uint32_t *base, uint8_t *bitmask)
+{
+	ipv4_t ip;
+
+	memset(&ip, 0, sizeof(ipv4_t));
+
+	if (!fill_addr(&ip, cidr)) { return -1; }
+	if (!fill_bitmask(&ip, cidr)) { return -1; }
+
+	*bitmask = ip.bitmask;
+	*base = addr_to_u32(ip.addr) & prefix_netmask(ip.bitmask);
+
+	return 0;
+}
+
+static int min_power_of_two(uint64_t target)
+{
+	int pow = 0;
+
+	while (((uint64_t) 1 << pow) < target) { pow++; }
+
+	return pow;
+}
+
+static char *format_uint(char *dst, uint64_t val)
+{
+	char tmp[20];
+	int n = 0;
+
+	do {
+		tmp[n++] = '0' + (int) (val % 10);
+		val /= 10;
+	} while (val);
+
+	while (n) { *dst++ = tmp[--n]; }
+
+	return dst;
+}
@@ -0,0 +1,527 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ipv6.h"
+
+#define GROUPS				8				/* 16-bit groups of an address */
+
+/**
+ * @brief Value of a hex digit.
+ * @param c Character.
+ * @return 0-15, or -1 if c is not a hex digit.
+ */
+static int hex_value(char c);
+
+/**
+ * @brief Parse the full eight-group form.
+ * @param str Address.
+ * @param[out] addr Parsed address.
+ * @return 0 on success, -1 if str is not in the full form.
+ */
+static int parse_full(const char *str, ipv6_u128 *addr);
+
+/**
+ * @brief Parse a dotted IPv4 tail into two groups.
+ * @param str Tail, ending at '\0' or '/'.
+ * @param[out] groups Two groups.
+ * @return Characters consumed, or -1 on error.
+ */
+static int parse_dotted(const char *str, uint16_t *groups);
+
+/**
+ * @brief Format one analysis row: both forms of an address.
+ * @param buf Destination buffer.
+ * @param size Size of buf.
+ * @param name Row title.
+ * @param addr Address.
+ * @return Number of characters written, or -1 on error.
+ */
+static int format_row(char *buf, size_t size, const char *name, ipv6_u128 addr);
+
+/**
+ * @brief Smallest k with 2^k >= target.
+ * @param target Required capacity.
+ * @return k, 0 if target <= 1.
+ */
+static int min_power_of_two(ipv6_u128 target);
+
+/* For qsort in ipv6_split_part, descending order */
+static int compare(const void *p1, const void *p2)
+{
+	ipv6_u128 a = *(const ipv6_u128 *) p1;
+	ipv6_u128 b = *(const ipv6_u128 *) p2;
+
+	return (a < b) - (a > b);
+}
+
+int ipv6_parse(const char *str, ipv6_u128 *addr)
+{
+	uint16_t groups[GROUPS];
+	const char *p = str;
+	const char *start = NULL;
+	ipv6_u128 res = 0;
+	int n = 0, gap = -1;
+	int val, digits, used;
+
+	if (!str || !addr) { return -1; }
+
+	if (parse_full(str, addr) == 0) { return IPV6_STR_LEN; }
+
+	if (p[0] == ':') {
+		if (p[1] != ':') { return -1; }
+		gap = 0;
+		p += 2;
+	}
+
+	while (*p && *p != '/') {
+		if (n == GROUPS) { return -1; }
+
+		start = p;
+		for (val = 0, digits = 0; digits < 5 && hex_value(*p) != -1; digits++, p++) {
+			val = val << 4 | hex_value(*p);
+		}
+
+		/* Digits before a '.' start an IPv4 tail */
+		if (*p == '.') {
+			if (n > GROUPS - 2) { return -1; }
+			used = parse_dotted(start, &groups[n]);
+			if (used == -1) { return -1; }
+			n += 2;
+			p = start + used;
+			break;
+		}
+
+		if (!digits || digits > 4) { return -1; }
+		groups[n++] = (uint16_t) val;
+
+		if (*p == ':') {
+			if (p[1] == ':') {
+				if (gap != -1) { return -1; }
+				gap = n;
+				p += 2;
+			}
+			else {
+				p++;
+				if (!*p || *p == '/') { return -1; }
+			}
+		}
+		else if (*p && *p != '/') { return -1; }
+	}
+
+	if (*p && *p != '/') { return -1; }
+
+	/* "::" stands for at least one zero group */
+	if (gap == -1 ? n != GROUPS : n > GROUPS - 1) { return -1; }
+
+	for (int i = 0; i < n; i++) {
+		if (i == gap) { res <<= 16 * (GROUPS - n); }
+		res = res << 16 | groups[i];
+	}
+	if (gap == n) { res <<= 16 * (GROUPS - n); }
+
+	*addr = res;
+
+	return (int) (p - str);
+}
+
+int ipv6_parse_cidr(const char *cidr, ipv6_u128 *addr, uint8_t *bitmask)
+{
+	int used, len = 0;
+	const char *p = NULL;
+
+	if (!cidr || !addr || !bitmask) { return -1; }
+
+	used = ipv6_parse(cidr, addr);
+	if (used == -1) { return -1; }
+
+	p = cidr + used;
+	if (!*p) {
+		*bitmask = BITS_IN_IP6;
+		return 0;
+	}
+
+	/* '/' and one to three digits */
+	if (!p[1]) { return -1; }
+	for (p++; *p; p++) {
+		if (*p < '0' || *p > '9' || len > BITS_IN_IP6) { return -1; }
+		len = len * 10 + (*p - '0');
+	}
+	if (len > BITS_IN_IP6 || p - (cidr + used) > 4) { return -1; }
+
+	*bitmask = (uint8_t) len;
+
+	return 0;
+}
+
+ipv6_u128 ipv6_netmask(uint8_t bitmask)
+{
+	if (!bitmask) { return 0; }
+	if (bitmask >= BITS_IN_IP6) { return ~(ipv6_u128) 0; }
+
+	return ~(ipv6_u128) 0 << (BITS_IN_IP6 - bitmask);
+}
+
+char *ipv6_format(char *dst, ipv6_u128 addr)
+{
+	static const char digits[] = "0123456789abcdef";
+	uint16_t groups[GROUPS];
+	int best = -1, best_len = 1;
+	int run, i, shift;
+
+	for (i = 0; i < GROUPS; i++) {
+		groups[i] = (uint16_t) (addr >> (16 * (GROUPS - 1 - i)));
+	}
+
+	/* IPv4-mapped addresses keep the dotted tail (RFC 5952, 5) */
+	if (addr >> 32 == 0xffff) {
+		return dst + sprintf(dst, "::ffff:%u.%u.%u.%u", groups[6] >> 8, groups[6] & 0xFF,
+							 groups[7] >> 8, groups[7] & 0xFF);
+	}
+
+	/* Longest run of two or more zero groups, the first on a tie */
+	for (i = 0; i < GROUPS; i += run ? run : 1) {
+		for (run = 0; i + run < GROUPS && !groups[i + run]; run++);
+		if (run > best_len) {
+			best = i;
+			best_len = run;
+		}
+	}
+
+	for (i = 0; i < GROUPS; i++) {
+		if (i == best) {
+			*dst++ = ':';
+			*dst++ = ':';
+			i += best_len - 1;
+			continue;
+		}
+		if (i && i != best + best_len) { *dst++ = ':'; }
+
+		for (shift = 12; shift > 0 && !(groups[i] >> shift); shift -= 4);
+		for (; shift >= 0; shift -= 4) { *dst++ = digits[(groups[i] >> shift) & 0xF]; }
+	}
+
+	return dst;
+}
+
+char *ipv6_format_full(char *dst, ipv6_u128 addr)
+{
+	static const char digits[] = "0123456789abcdef";
+	uint64_t half;
+
+	/* Two 64-bit halves keep the shifts out of 128-bit arithmetic */
+	for (int h = 1; h >= 0; h--) {
+		half = (uint64_t) (addr >> (64 * h));
+		for (int shift = 60; shift >= 0; shift -= 4) {
+			*dst++ = digits[(half >> shift) & 0xF];
+			if (!(shift & 0xF) && (shift || h)) { *dst++ = ':'; }
+		}
+	}
+
+	return dst;
+}
+
+char *ipv6_format_u128(char *dst, ipv6_u128 val)
+{
+	const uint64_t chunk = 10000000000000000000ULL;	/* 10^19 */
+	char tmp[40];
+	uint64_t low;
+	int n = 0;
+
+	/* Full 19-digit chunks while the value is wider than 64 bits */
+	while (val >> 64) {
+		low = (uint64_t) (val % chunk);
+		val /= chunk;
+		for (int i = 0; i < 19; i++, low /= 10) { tmp[n++] = '0' + (int) (low % 10); }
+	}
+
+	low = (uint64_t) val;
+	do {
+		tmp[n++] = '0' + (int) (low % 10);
+		low /= 10;
+	} while (low);
+
+	while (n) { *dst++ = tmp[--n]; }
+
+	return dst;
+}
+
+int ipv6_parse_u128(const char *str, ipv6_u128 *val)
+{
+	const ipv6_u128 max = ~(ipv6_u128) 0;
+	ipv6_u128 res = 0;
+
+	if (!str || !val || !*str) { return -1; }
+
+	for (; *str; str++) {
+		if (*str < '0' || *str > '9') { return -1; }
+		if (res > (max - (*str - '0')) / 10) { return -1; }
+		res = res * 10 + (*str - '0');
+	}
+
+	*val = res;
+
+	return 0;
+}
+
+int ipv6_analyze(struct ipv6 *ip, const char *cidr)
+{
+	if (!ip || !cidr) { return -1; }
+
+	memset(ip, 0, sizeof(struct ipv6));
+
+	if (ipv6_parse_cidr(cidr, &ip->addr, &ip->bitmask) == -1) { return -1; }
+
+	ip->netmask = ipv6_netmask(ip->bitmask);
+	ip->wildcard = ~ip->netmask;
+	ip->network = ip->addr & ip->netmask;
+	ip->last = ip->network | ip->wildcard;
+
+	return 0;
+}
+
+int ipv6_format_analysis(const struct ipv6 *ip, char *buf, size_t size)
+{
+	char hosts[48];
+	size_t len = 0;
+	int res;
+
+	if (!ip || !buf) { return -1; }
+
+/* Append to buf, fail if it does not fit */
+#define APPEND(call)												\
+	do {															\
+		res = (call);												\
+		if (res < 0 || (size_t) res >= size - len) { return -1; }	\
+		len += res;													\
+	} while (0)
+
+	/* Title */
+	APPEND(snprintf(buf + len, size - len, "%15s%-44s%s\n", "", "EXPANDED", "COMPRESSED"));
+
+	APPEND(format_row(buf + len, size - len, "Addr", ip->addr));
+	APPEND(snprintf(buf + len, size - len, "%-15s%d\n", "Bitmask", ip->bitmask));
+	APPEND(format_row(buf + len, size - len, "Netmask", ip->netmask));
+	APPEND(format_row(buf + len, size - len, "Wildcard", ip->wildcard));
+	APPEND(format_row(buf + len, size - len, "Network", ip->network));
+
+	/* Every address of an IPv6 prefix is usable */
+	APPEND(snprintf(buf + len, size - len, "%-15s%s\n", "Broadcast", "No broadcast"));
+	APPEND(format_row(buf + len, size - len, "Hostmin", ip->network));
+	APPEND(format_row(buf + len, size - len, "Hostmax", ip->last));
+
+	/* 2^128 does not fit, /0 is spelled out */
+	if (!ip->bitmask) { strcpy(hosts, "340282366920938463463374607431768211456"); }
+	else { *ipv6_format_u128(hosts, ip->wildcard + 1) = '\0'; }
+	APPEND(snprintf(buf + len, size - len, "%-15s%s\n", "Hosts", hosts));
+
+#undef APPEND
+
+	return (int) len;
+}
+
+int ipv6_split_equal(struct ipv6_split *sp, const char *cidr, ipv6_u128 count)
+{
+	int pow;
+
+	if (!sp || !cidr || !count) { return -1; }
+
+	memset(sp, 0, sizeof(struct ipv6_split));
+
+	if (ipv6_parse_cidr(cidr, &sp->base, &sp->bitmask) == -1) { return -1; }
+	sp->base &= ipv6_netmask(sp->bitmask);
+
+	pow = min_power_of_two(count);
+	if (sp->bitmask + pow > BITS_IN_IP6) { return -1; }
+
+	sp->sub_bitmask = sp->bitmask + pow;
+	sp->count = count;
+
+	return 0;
+}
+
+int ipv6_split_part(struct ipv6_split *sp, const char *cidr, ipv6_u128 *parts, size_t len)
+{
+	ipv6_u128 left, span;
+	int pow, full = 0;
+
+	if (!sp || !cidr || !parts || !len) { return -1; }
+
+	memset(sp, 0, sizeof(struct ipv6_split));
+
+	for (size_t i = 0; i < len; i++) {
+		if (!parts[i]) { return -1; }
+	}
+
+	if (ipv6_parse_cidr(cidr, &sp->base, &sp->bitmask) == -1) { return -1; }
+	sp->base &= ipv6_netmask(sp->bitmask);
+
+	qsort(parts, len, sizeof(ipv6_u128), compare);
+
+	/* Free addresses minus one, so a whole ::/0 fits the arithmetic */
+	left = ~ipv6_netmask(sp->bitmask);
+	for (size_t i = 0; i < len; i++) {
+		pow = min_power_of_two(parts[i]);
+		if (full || pow > BITS_IN_IP6 - sp->bitmask) { return -1; }
+
+		span = ~ipv6_netmask(BITS_IN_IP6 - pow);
+		if (span > left) { return -1; }
+		if (span == left) { full = 1; }
+		else { left -= span + 1; }
+	}
+
+	sp->parts = parts;
+	sp->count = len;
+
+	return 0;
+}
+
+int ipv6_split_next(struct ipv6_split *sp, struct ipv6_subnet *out)
+{
+	uint8_t bitmask;
+	ipv6_u128 span;
+
+	if (!sp || !out) { return 0; }
+	if (sp->pos >= sp->count) { return 0; }
+
+	bitmask = sp->parts ? BITS_IN_IP6 - min_power_of_two(sp->parts[sp->pos])
+						: sp->sub_bitmask;
+	span = ~ipv6_netmask(bitmask);
+
+	out->first = sp->base + sp->offset;
+	out->last = out->first + span;
+	out->bitmask = bitmask;
+
+	/* Wraps to 0 only after the last subnet of ::/0 */
+	sp->offset += span + 1;
+	sp->pos++;
+
+	return 1;
+}
+
+int ipv6_format_subnet(const struct ipv6_subnet *sn, ipv6_u128 idx, char *buf, size_t size)
+{
+	char *p = buf;
+	char *num = NULL;
+
+	if (!sn || !buf || size < IPV6_SUBNET_ROW_MAX) { return -1; }
+
+	/* Row number is left-aligned in a column of 5, wider ones get a space */
+	num = p;
+	p = ipv6_format_u128(p, idx);
+	do { *p++ = ' '; } while (p - num < 5);
+
+	p = ipv6_format_full(p, sn->first);
+	memset(p, ' ', 5);
+	p = ipv6_format_full(p + 5, sn->last);
+	memset(p, ' ', 5);
+	p += 5;
+
+	p = ipv6_format_u128(p, sn->bitmask);
+	*p++ = '\n';
+
+	return (int) (p - buf);
+}
+
+static int hex_value(char c)
+{
+	if (c >= '0' && c <= '9') { return c - '0'; }
+	if (c >= 'a' && c <= 'f') { return c - 'a' + 10; }
+	if (c >= 'A' && c <= 'F') { return c - 'A' + 10; }
+
+	return -1;
+}
+
+static int parse_full(const char *str, ipv6_u128 *addr)
+{
+	ipv6_u128 res = 0;
+	int val;
+
+	for (int i = 0; i < IPV6_STR_LEN; i++) {
+		if (i % 5 == 4) {
+			if (str[i] != ':') { return -1; }
+			continue;
+		}
+
+		val = hex_value(str[i]);
+		if (val == -1) { return -1; }
+		res = res << 4 | val;
+	}
+
+	if (str[IPV6_STR_LEN] && str[IPV6_STR_LEN] != '/') { return -1; }
+
+	*addr = res;
+
+	return 0;
+}
+
+static int parse_dotted(const char *str, uint16_t *groups)
+{
+	const char *p = str;
+	int octets[4];
+	int val, digits;
+
+	for (int i = 0; i < 4; i++) {
+		for (val = 0, digits = 0; *p >= '0' && *p <= '9' && digits < 4; p++, digits++) {
+			val = val * 10 + (*p - '0');
+		}
+		if (!digits || digits > 3 || val > 255) { return -1; }
+		octets[i] = val;
+
+		if (i < 3) {
+			if (*p != '.') { return -1; }
+			p++;
+		}
+	}
+
+	if (*p && *p != '/') { return -1; }
+
+	groups[0] = (uint16_t) (octets[0] << 8 | octets[1]);
+	groups[1] = (uint16_t) (octets[2] << 8 | octets[3]);
+
+	return (int) (p - str);
+}
+
+static int format_row(char *buf, size_t size, const char *name, ipv6_u128 addr)
+{
+	char full[IPV6_STR_LEN + 1];
+	char compressed[IPV6_STR_LEN + 1];
+
+	*ipv6_format_full(full, addr) = '\0';
+	*ipv6_format(compressed, addr) = '\0';
+
+	return snprintf(buf, size, "%-15s%-44s%s\n", name, full, compressed);
+}
+
+static int min_power_of_two(ipv6_u128 target)
+{
+	ipv6_u128 x;
+	uint64_t hi;
+
+	if (target <= 1) { return 0; }
+
+	x = target - 1;
+	hi = (uint64_t) (x >> 64);
+
+	return hi ? 128 - __builtin_clzll(hi) : 64 - __builtin_clzll((uint64_t) x);
+}
@@ -27,12 +27,40 @@
 #include "fill_ipv4.h"
 #include "analysis.h"
 #include "subnet.h"
+#include "coverage.h"
+#include "sample.h"
+#include "enumerate.h"
+#include "target.h"
+#include "batch.h"
+#include "server.h"
+#include "client.h"
+#include "gen.h"
+#include "compile.h"
+#include "filter.h"
+#include "supernet.h"
+#include "analysis6.h"
+#include "subnet6.h"
+#include "aggregate.h"
+#include "profile.h"
+#include "query.h"
+#include "extract.h"
+#include "occupancy.h"
+#include "publish.h"
+#include "distinct.h"
+#include "stats.h"
+#include "status.h"
+
+#define MAX_THREADS		256		/* Upper bound of -s --threads */
 
 /**
  * @enum mode
  * @brief Command line options. 
  */
-enum mode { analysis, subnetting };
+enum mode { analysis, subnetting, coverage, sampling, enumeration, targets,
+		   batch, serving, client, generation, compiling,
+		   filtering, supernetting, analysis6, subnetting6,
+		   aggregating, profiling, querying, extracting,
+		   occupying, sharing, distinct_counting };
 
 /**
  * @brief Process main() command-line arguments.
@@ -40,6 +68,9 @@ enum mode { analysis, subnetting };
  * Parses command-line arguments to determine program operation mode,
  * extract IP address string, and defining parameters for subnetting.
  * 
+ * Modes with their own options (e.g. -c) get the remaining arguments
+ * unparsed, ip_str and arg_arr are left untouched for them.
+ * 
  * @param argc Argument count.
  * @param argv Argument vector.
  * @param[out] mode Program operation mode.
@@ -59,14 +90,44 @@ static int process_args(int argc, char **argv,
 				 		enum mode *mode, char **ip_str,
 						int **arg_arr, size_t *arr_len);
 
+/**
+ * @brief Take the --stats option out of the arguments.
+ *
+ * Accepted anywhere: --stats (text report) or --stats=json.
+ * 
+ * @param[in,out] argc Argument count.
+ * @param[in,out] argv Argument vector, the option is removed.
+ * 
+ * @return 0 on success, -1 on error (including --stats in a build
+ *         without STATS=1).
+ */
+static int process_stats_arg(int *argc, char **argv);
+
+/**
+ * @brief Take the --threads option of -s out of the arguments.
+ *
+ * Accepted anywhere after -s: --threads <n>, 1 <= n <= MAX_THREADS.
+ *
+ * @param[in,out] argc Argument count.
+ * @param[in,out] argv Argument vector, the option is removed.
+ * @param[out] threads Number of threads, 0 if the option is absent.
+ *
+ * @return 0 on success, -1 on error.
+ */
+static int process_threads_arg(int *argc, char **argv, unsigned *threads);
+
 int main(int argc, char **argv)
 {
-	int res;
+	int res = EXIT_FAILURE;
 	enum mode mode;
 	char *ip_str = NULL;
 	ipv4_t *ip = NULL;
 	int *parts = NULL;
 	size_t parts_len;
+	unsigned threads;
+
+	if (process_stats_arg(&argc, argv) == -1) { return EXIT_FAILURE; }
+	if (process_threads_arg(&argc, argv, &threads) == -1) { return EXIT_FAILURE; }
 
 	ip = malloc(sizeof(ipv4_t));
 	if (!ip) { goto handle_error; }
@@ -77,12 +138,114 @@ int main(int argc, char **argv)
 	switch (mode) {
 		case analysis:
 			res = analysis_start(ip, ip_str);	
-			if (res == EXIT_FAILURE) { goto handle_error; }
+			if (res != EXIT_SUCCESS) { goto handle_error; }
 			break;
 		
 		case subnetting:
-			res = subnetting_start(ip, ip_str, parts, parts_len);
-			if (res == EXIT_FAILURE) { goto handle_error; }
+			res = subnetting_start(ip_str, parts, parts_len, threads);
+			if (res != EXIT_SUCCESS) { goto handle_error; }
+			break;
+
+		case coverage:
+			res = coverage_start(argc - 2, argv + 2);
+			if (res != EXIT_SUCCESS) { goto handle_error; }
+			break;
+
+		case sampling:
+			res = sample_start(argc - 2, argv + 2);
+			if (res != EXIT_SUCCESS) { goto handle_error; }
+			break;
+
+		case enumeration:
+			res = enumerate_start(argc - 2, argv + 2);
+			if (res != EXIT_SUCCESS) { goto handle_error; }
+			break;
+
+		case targets:
+			res = target_start(argc - 2, argv + 2);
+			if (res != EXIT_SUCCESS) { goto handle_error; }
+			break;
+
+		case batch:
+			res = batch_start(argc - 2, argv + 2);
+			if (res != EXIT_SUCCESS) { goto handle_error; }
+			break;
+
+		case serving:
+			res = server_start(argc - 2, argv + 2);
+			if (res != EXIT_SUCCESS) { goto handle_error; }
+			break;
+
+		case client:
+			res = client_start(argc - 2, argv + 2);
+			if (res != EXIT_SUCCESS) { goto handle_error; }
+			break;
+
+		case generation:
+			res = gen_start(argc - 2, argv + 2);
+			if (res != EXIT_SUCCESS) { goto handle_error; }
+			break;
+
+		case compiling:
+			res = compile_start(argc - 2, argv + 2);
+			if (res != EXIT_SUCCESS) { goto handle_error; }
+			break;
+
+		case filtering:
+			res = filter_start(argc - 2, argv + 2);
+			if (res != EXIT_SUCCESS) { goto handle_error; }
+			break;
+
+		case supernetting:
+			res = supernet_start(argc - 2, argv + 2);
+			if (res != EXIT_SUCCESS) { goto handle_error; }
+			break;
+
+		case analysis6:
+			res = analysis6_start(argc - 2, argv + 2);
+			if (res != EXIT_SUCCESS) { goto handle_error; }
+			break;
+
+		case subnetting6:
+			/* IPv6 splits are single-threaded */
+			if (threads) { goto handle_error; }
+			res = subnetting6_start(argc - 2, argv + 2);
+			if (res != EXIT_SUCCESS) { goto handle_error; }
+			break;
+
+		case aggregating:
+			res = aggregate_start(argc - 2, argv + 2);
+			if (res != EXIT_SUCCESS) { goto handle_error; }
+			break;
+
+		case profiling:
+			res = profile_start(argc - 2, argv + 2);
+			if (res != EXIT_SUCCESS) { goto handle_error; }
+			break;
+
+		case querying:
+			res = query_start(argc - 2, argv + 2);
+			if (res != EXIT_SUCCESS) { goto handle_error; }
+			break;
+
+		case extracting:
+			res = extract_start(argc - 2, argv + 2);
+			if (res != EXIT_SUCCESS) { goto handle_error; }
+			break;
+
+		case occupying:
+			res = occupancy_start(argc - 2, argv + 2);
+			if (res != EXIT_SUCCESS) { goto handle_error; }
+			break;
+
+		case sharing:
+			res = publish_start(argc - 2, argv + 2);
+			if (res != EXIT_SUCCESS) { goto handle_error; }
+			break;
+
+		case distinct_counting:
+			res = distinct_start(argc - 2, argv + 2);
+			if (res != EXIT_SUCCESS) { goto handle_error; }
 			break;
 	}
 
@@ -90,19 +253,124 @@ int main(int argc, char **argv)
 	free(ip_str);
 	free(parts);
 
+	stats_report();
+
 	return EXIT_SUCCESS;
 
 	handle_error:
 		free(ip);
 		free(ip_str);
 		free(parts);
+		stats_report();
+		/* The mode has reported what is wrong with its input */
+		if (res == EXIT_INPUT) { return EXIT_FAILURE; }
 		fputs("Usage:\tipc <-a> <ip/bitmask>\n"
 			  "\tipc <-s> <ip/bitmask> <--equal> <count>\n"
-			  "\tipc <-s> <ip/bitmask> <--part> <uint, ...>\n\n"
-			  "-a\tanalysis\n"
-			  "-s\tsubnetting\n"
+			  "\tipc <-s> <ip/bitmask> <--part> <uint, ...>\n"
+			  "\t\t[--threads <n>] (IPv4, either split)\n"
+			  "\tipc <-c> [--by-length] [--by-parent <len>] [file, ...]\n"
+			  "\tipc <-r> <count> [--weighted] [--seed <n>] [--binary] [file, ...]\n"
+			  "\tipc <-e> <ip/bitmask> [--stride <n>] [--exclude <entry>]\n"
+			  "\t\t[--exclude-file <file>] [--shuffle] [--seed <n>]\n"
+			  "\tipc <-t> <expression, ...> [--cidr] [--count]\n"
+			  "\tipc <-b> [--cache <n>] [--key <raw|parsed>] [file, ...]\n"
+			  "\tipc <--serve> <socket> [--table <file>, ... | --shm <name>]\n"
+			  "\tipc <--client> <socket> [--bench <n>] [--depth <n>] [request]\n"
+			  "\tipc <gen> <prefixes|addresses> <count> [--seed <n>] [--clusters <n>]\n"
+			  "\t\t[--skew <s>] [--nested <pct>] [--table <file>] [--unique]\n"
+			  "\tipc <compile> <-o <file> [--no-table] [file...] | --verify <file> | --dump <file>>\n"
+			  "\tipc <acl> <acl-file> [--check] [--count] [--binary] [file, ...]\n"
+			  "\tipc <supernet> [--binary] [--no-waste] [file, ...]\n"
+			  "\tipc <aggregate> [--mark] [file, ...] (commands on stdin)\n"
+			  "\tipc <profile> [--json] [--threads <n>] [file, ...]\n"
+			  "\tipc <query> <file, ...> [--inside <prefix>] [--containing <prefix>]\n"
+			  "\t\t[--queries <file|->]\n"
+			  "\tipc <extract> [--offset | --line] [file, ...]\n"
+			  "\tipc <occupancy> <ip/bitmask> <--equal <count> | --part <uint, ...>>\n"
+			  "\t\t[--threshold <pct>] [--flagged] [file, ...]\n"
+			  "\tipc <shm> <publish|lookup> <name> [file, ...] | <shm> <remove> <name>\n"
+			  "\tipc <distinct> [--length <n> | --table <file>] [--precision <p>] [--threads <n>]\n"
+			  "\t\t[--load <file>, ...] [--save <file>] [--top <n>] [file, ...]\n"
+			  "Any mode:\t[--stats[=json]] (build with make STATS=1)\n\n"
+			  "-a\tanalysis, IPv4 or IPv6\n"
+			  "-s\tsubnetting, IPv4 or IPv6 (counts up to 2^128 - 1)\n"
 			  "\t--equal\tsplitting into equal parts\n"
-			  "\t--part\tsplit into pieces of different sizes\n", stderr);
+			  "\t--part\tsplit into pieces of different sizes\n"
+			  "\t--threads\tformat rows on n threads, output unchanged\n"
+			  "-c\tunique addresses covered by prefixes and ranges\n"
+			  "\t--by-length\tbreakdown by prefix length\n"
+			  "\t--by-parent\tbreakdown by enclosing prefix\n"
+			  "-r\trandom addresses from prefixes\n"
+			  "\t--weighted\tpick prefixes by weight (number after prefix)\n"
+			  "\t--seed\treproducible sequence\n"
+			  "\t--binary\t4-byte addresses in network byte order\n"
+			  "-e\tlist every usable host\n"
+			  "\t--stride\tevery n-th host\n"
+			  "\t--exclude\tskip a prefix or range\n"
+			  "\t--exclude-file\tskip prefixes and ranges of a file\n"
+			  "\t--shuffle\trandom order without repeats\n"
+			  "-t\texpand target expressions (e.g. 10.0-255.1-254.1,5,9)\n"
+			  "\t--cidr\tminimal CIDR cover\n"
+			  "\t--count\tnumber of addresses\n"
+			  "-b\tanalysis of every address of a list\n"
+			  "\t--cache\tcached reports, 0 disables\n"
+			  "\t--key\tcache by input text or by parsed address\n"
+			  "--serve\tanswer requests (analyze, split, lookup, count, ping)\n"
+			  "\ton a Unix domain socket\n"
+			  "\t--table\tprefixes for lookup\n"
+			  "\t--shm\tshared table for lookup, new generations followed\n"
+			  "--client\tsend a request, or stdin lines, to a server\n"
+			  "\t--bench\tsend the request n times, print latency\n"
+			  "\t--depth\trequests in flight\n"
+			  "gen\tsynthetic prefix table or address stream\n"
+			  "\t--seed\tdifferent dataset (default 1)\n"
+			  "\t--clusters\tallocation blocks entries are drawn from\n"
+			  "\t--skew\tZipf exponent of block popularity\n"
+			  "\t--nested\tpercent of prefixes inside or around earlier ones\n"
+			  "\t--table\tblocks from a prefix file\n"
+			  "\t--unique\tno repeated prefixes, slower and ~7 bytes per prefix\n"
+			  "compile\tbinary prefix set, read wherever a prefix file is\n"
+			  "\t--no-table\tleave out the lookup table\n"
+			  "\t--verify\tcheck a compiled file\n"
+			  "\t--dump\tprint a compiled file as text\n"
+			  "acl\tfirst matching permit/deny entry of each address\n"
+			  "\t--check\treport shadowed and redundant entries only\n"
+			  "\t--count\thits per entry\n"
+			  "\t--binary\t4-byte addresses in network byte order\n"
+			  "supernet\tsmallest prefix holding every entry\n"
+			  "\t--binary\t4-byte addresses in network byte order\n"
+			  "\t--no-waste\tskip the union, reduce at read speed\n"
+			  "aggregate\tminimal cover kept up to date by add/del/dump\n"
+			  "\tcommands, changes printed as +/- lines\n"
+			  "\t--mark\tend the output of every command with a '.' line\n"
+			  "profile\tlengths, duplicates, host bits, coverage and nesting\n"
+			  "\tof a prefix table\n"
+			  "\t--json\tone JSON object\n"
+			  "\t--threads\tparsing threads (default: number of CPUs)\n"
+			  "query\tstored prefixes inside or holding a prefix\n"
+			  "\t--inside\tprefixes within it, in address order\n"
+			  "\t--containing\tprefixes holding it, shortest first\n"
+			  "\t--queries\t'inside|containing <prefix>' lines (default stdin)\n"
+			  "extract\tIPv4 addresses found in log text, one per line\n"
+			  "\t--offset\tappend ' # <byte offset>'\n"
+			  "\t--line\tappend ' # <line number>'\n"
+			  "occupancy\thosts per subnet of a -s plan, from an address list\n"
+			  "\t--threshold\tutilization marking a subnet over (default 80)\n"
+			  "\t--flagged\tonly over and empty subnets\n"
+			  "shm\tprefix table in shared memory, one copy for all processes\n"
+			  "\tpublish\tmake the prefixes of the files the next generation\n"
+			  "\tlookup\tlongest match per address, following new generations\n"
+			  "\tremove\tdrop the table, readers keep what they mapped\n"
+			  "distinct\testimated distinct sources per destination prefix,\n"
+			  "\tfrom '<source> <destination>' lines\n"
+			  "\t--length\tbucket by this prefix length (default 24)\n"
+			  "\t--table\tbucket by the longest matching prefix of the file\n"
+			  "\t--precision\t2^p bytes per bucket, 4-16 (default 12)\n"
+			  "\t--threads\tparsing threads (default: number of CPUs)\n"
+			  "\t--load\tmerge sketches saved by an earlier run\n"
+			  "\t--save\twrite the sketches for a later --load\n"
+			  "\t--top\tonly the n buckets with most sources\n"
+			  "--stats\tstage times, counters and latencies to stderr\n", stderr);
 		return EXIT_FAILURE;
 }
 
@@ -119,13 +387,39 @@ static int process_args(int argc, char **argv,
 	if (!ip_str) { return -1; }
 	if (!arr_len) { return -1; }
 
-	if (argc < 3) { return -1; }
+	if (argc < 2) { return -1; }
 
 	/* Checking the first parameter */
 	if (strcmp(argv[1], "-a") == 0) { *mode = analysis; }
 	else if (strcmp(argv[1], "-s") == 0) { *mode = subnetting; }
+	else if (strcmp(argv[1], "-c") == 0) { *mode = coverage; return 0; }
+	else if (strcmp(argv[1], "-r") == 0) { *mode = sampling; return 0; }
+	else if (strcmp(argv[1], "-e") == 0) { *mode = enumeration; return 0; }
+	else if (strcmp(argv[1], "-t") == 0) { *mode = targets; return 0; }
+	else if (strcmp(argv[1], "-b") == 0) { *mode = batch; return 0; }
+	else if (strcmp(argv[1], "--serve") == 0) { *mode = serving; return 0; }
+	else if (strcmp(argv[1], "--client") == 0) { *mode = client; return 0; }
+	else if (strcmp(argv[1], "gen") == 0) { *mode = generation; return 0; }
+	else if (strcmp(argv[1], "compile") == 0) { *mode = compiling; return 0; }
+	else if (strcmp(argv[1], "acl") == 0) { *mode = filtering; return 0; }
+	else if (strcmp(argv[1], "supernet") == 0) { *mode = supernetting; return 0; }
+	else if (strcmp(argv[1], "aggregate") == 0) { *mode = aggregating; return 0; }
+	else if (strcmp(argv[1], "profile") == 0) { *mode = profiling; return 0; }
+	else if (strcmp(argv[1], "query") == 0) { *mode = querying; return 0; }
+	else if (strcmp(argv[1], "extract") == 0) { *mode = extracting; return 0; }
+	else if (strcmp(argv[1], "occupancy") == 0) { *mode = occupying; return 0; }
+	else if (strcmp(argv[1], "shm") == 0) { *mode = sharing; return 0; }
+	else if (strcmp(argv[1], "distinct") == 0) { *mode = distinct_counting; return 0; }
 	else { return -1; }
 
+	if (argc < 3) { return -1; }
+
+	/* IPv6 addresses go to their own modes, numbers stay unparsed */
+	if (strchr(argv[2], ':')) {
+		*mode = (*mode == analysis) ? analysis6 : subnetting6;
+		return 0;
+	}
+
 	if (*mode == subnetting && argc < 5) { return -1; }
 
 	/* Checking the second parameter */
@@ -168,3 +462,88 @@ static int process_args(int argc, char **argv,
 		*arg_arr = NULL;
 		return -1;
 }
+
+static int process_stats_arg(int *argc, char **argv)
+{
+	int json;
+
+	for (int i = 1; i < *argc; i++) {
+		if (strcmp(argv[i], "--stats") == 0 || strcmp(argv[i], "--stats=text") == 0) { json = 0; }
+		else if (strcmp(argv[i], "--stats=json") == 0) { json = 1; }
+		else { continue; }
+
+#ifdef IPC_STATS
+		stats_enable(json);
+#else
+		(void) json;
+		fputs("ipc: --stats needs a build with STATS=1\n", stderr);
+		return -1;
+#endif
+
+		/* Shift the rest, argv[argc] stays NULL */
+		memmove(&argv[i], &argv[i + 1], (*argc - i) * sizeof(char *));
+		(*argc)--;
+		i--;
+	}
+
+	return 0;
+}
+
+static int process_threads_arg(int *argc, char **argv, unsigned *threads)
+{
+	long n;
+	char *endptr = NULL;
+
+	*threads = 0;
+	if (*argc < 2 || strcmp(argv[1], "-s") != 0) { return 0; }
+
+	for (int i = 2; i < *argc; i++) {
+		if (strcmp(argv[i], "--threads") != 0) { continue; }
+		if (i + 1 >= *argc) { return -1; }
+
+		errno = 0;
+		n = strtol(argv[i + 1], &endptr, 10);
+		if (errno == ERANGE || *endptr != '\0' || n < 1 || n > MAX_THREADS) { return -1; }
+		*threads = (unsigned) n;
+
+		/* Shift the rest, argv[argc] stays NULL */
+		memmove(&argv[i], &argv[i + 2], (*argc - i - 1) * sizeof(char *));
+		*argc -= 2;
+		i--;
+	}
+
+	return 0;
+}
+
+#ifdef IPC_STATS
+/*
+ * Allocation counters. The binary is linked with
+ * -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc, so every call in
+ * the program and in libipc.a lands here first. Worker threads
+ * allocate too, hence the atomic adds.
+ */
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size)
+{
+	__atomic_fetch_add(&ipc_stats.allocs, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&ipc_stats.alloc_bytes, size, __ATOMIC_RELAXED);
+	return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+	__atomic_fetch_add(&ipc_stats.allocs, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&ipc_stats.alloc_bytes, nmemb * size, __ATOMIC_RELAXED);
+	return __real_calloc(nmemb, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+	__atomic_fetch_add(&ipc_stats.allocs, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&ipc_stats.alloc_bytes, size, __ATOMIC_RELAXED);
+	return __real_realloc(ptr, size);
+}
+#endif /* IPC_STATS */
@@ -0,0 +1,347 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <inttypes.h>
+
+#include "ipc.h"
+#include "fill_ipv4.h"
+#include "prefix_list.h"
+#include "format.h"
+#include "stats.h"
+#include "status.h"
+#include "occupancy.h"
+
+#define OCC_BATCH			4096	/* Addresses parsed before bucketing */
+#define DEFAULT_THRESHOLD	80.0	/* Percent of usable addresses */
+#define ROW_MAX				96		/* Longest report row */
+
+/**
+ * @struct plan
+ * @brief Split plan with a host count per subnet.
+ */
+struct plan {
+    struct ipc_split sp;            /**< Split, at its first subnet */
+    uint32_t span_last;             /**< Last offset inside the network */
+    int shift;                      /**< Equal split: host bits of a subnet */
+    uint32_t *first;                /**< Part split: first address of each subnet */
+    uint32_t *last;                 /**< Part split: last address of each subnet */
+    uint64_t *hosts;                /**< Hosts in each subnet */
+    uint64_t total;                 /**< Hosts read */
+    uint64_t outside;               /**< Hosts in no subnet */
+};
+
+/**
+ * @brief Set up the plan from the arguments.
+ * @param pl Plan to fill.
+ * @param argc Number of arguments.
+ * @param argv Network, then --equal or --part and its numbers.
+ * @param parts Part sizes are stored here, argc elements.
+ * @return Number of arguments used, or -1 on error.
+ */
+static int plan_init(struct plan *pl, int argc, char **argv, int *parts);
+
+/**
+ * @brief Free the plan arrays.
+ * @param pl Plan.
+ */
+static void plan_free(struct plan *pl);
+
+/**
+ * @brief Subnet of an address.
+ * @param pl Plan.
+ * @param addr Address.
+ * @return Subnet index, or -1 if no subnet holds the address.
+ */
+static inline int64_t plan_bucket(const struct plan *pl, uint32_t addr);
+
+/**
+ * @brief Count the addresses of a stream.
+ * @param pl Plan.
+ * @param fp Addresses, whitespace separated.
+ * @return 0 on success, -1 on an invalid entry or read error.
+ */
+static int count_stream(struct plan *pl, FILE *fp);
+
+/**
+ * @brief Print the per-subnet table and the totals.
+ * @param pl Plan.
+ * @param threshold Utilization in percent above which a subnet is over.
+ * @param flagged Print only over and empty subnets.
+ * @return 0 on success, -1 on a write error.
+ */
+static int report(const struct plan *pl, double threshold, int flagged);
+
+int occupancy_start(int argc, char **argv)
+{
+	struct plan pl;
+	FILE *fp = NULL;
+	int *parts = NULL;
+	double threshold = DEFAULT_THRESHOLD;
+	int flagged = 0, files = 0;
+	int status = EXIT_FAILURE;
+	int used;
+	char *endptr = NULL;
+	STATS_DECL(t);
+
+	memset(&pl, 0, sizeof(struct plan));
+
+	parts = calloc(argc ? argc : 1, sizeof(int));
+	if (!parts) { return EXIT_INPUT; }
+
+	used = plan_init(&pl, argc, argv, parts);
+	if (used == -1) { goto handle_error; }
+
+	for (int i = used; i < argc; i++) {
+		if (strcmp(argv[i], "--threshold") == 0) {
+			if (i + 1 >= argc) { goto handle_error; }
+			errno = 0;
+			threshold = strtod(argv[++i], &endptr);
+			if (errno == ERANGE || *endptr != '\0' || threshold < 0) { goto handle_error; }
+		}
+		else if (strcmp(argv[i], "--flagged") == 0) { flagged = 1; }
+		else if (strncmp(argv[i], "--", 2) == 0) { goto handle_error; }
+		else { files++; }
+	}
+	STATS_LAP(t, stage_build);
+
+	/* The arguments are fine, what fails from here on is the input */
+	status = EXIT_INPUT;
+
+	if (!files && count_stream(&pl, stdin) == -1) { goto handle_error; }
+
+	for (int i = used; i < argc; i++) {
+		if (strcmp(argv[i], "--threshold") == 0) { i++; continue; }
+		if (strncmp(argv[i], "--", 2) == 0) { continue; }
+
+		fp = fopen(argv[i], "r");
+		if (!fp) {
+			fprintf(stderr, "ipc: %s: %s\n", argv[i], strerror(errno));
+			goto handle_error;
+		}
+		if (count_stream(&pl, fp) == -1) { goto handle_error; }
+		fclose(fp);
+		fp = NULL;
+	}
+
+	STATS_MARK(t);
+	if (report(&pl, threshold, flagged) == -1) { goto handle_error; }
+	STATS_LAP(t, stage_output);
+
+	plan_free(&pl);
+	free(parts);
+	return EXIT_SUCCESS;
+
+	handle_error:
+		if (fp) { fclose(fp); }
+		plan_free(&pl);
+		free(parts);
+		return status;
+}
+
+static int plan_init(struct plan *pl, int argc, char **argv, int *parts)
+{
+	struct ipc_split sp;
+	struct ipc_subnet sn;
+	unsigned long long count;
+	long part;
+	char *endptr = NULL;
+	int i = 2;
+
+	if (argc < 3) { return -1; }
+
+	if (strcmp(argv[1], "--equal") == 0) {
+		errno = 0;
+		count = strtoull(argv[2], &endptr, 10);
+		if (errno == ERANGE || *endptr != '\0' || argv[2][0] == '-') { return -1; }
+		if (ipc_split_equal(&pl->sp, argv[0], count) == -1) { return -1; }
+		i = 3;
+	}
+	else if (strcmp(argv[1], "--part") == 0) {
+		/* Sizes run up to the first argument that is not one */
+		for (; i < argc; i++) {
+			errno = 0;
+			part = strtol(argv[i], &endptr, 10);
+			if (errno == ERANGE || *endptr != '\0' || part <= 0 || part > INT_MAX) { break; }
+			parts[i - 2] = (int) part;
+		}
+		if (ipc_split_part(&pl->sp, argv[0], parts, i - 2) == -1) { return -1; }
+	}
+	else { return -1; }
+
+	pl->span_last = (uint32_t) (prefix_size(pl->sp.bitmask) - 1);
+	pl->shift = BITS_IN_IP - pl->sp.sub_bitmask;
+
+	pl->hosts = calloc(pl->sp.count, sizeof(uint64_t));
+	if (!pl->hosts) { return -1; }
+
+	/* Part splits are short: keep the boundaries for the search */
+	if (pl->sp.parts) {
+		pl->first = malloc(pl->sp.count * sizeof(uint32_t));
+		pl->last = malloc(pl->sp.count * sizeof(uint32_t));
+		if (!pl->first || !pl->last) { return -1; }
+
+		sp = pl->sp;
+		for (uint64_t j = 0; ipc_split_next(&sp, &sn); j++) {
+			pl->first[j] = sn.first;
+			pl->last[j] = sn.last;
+		}
+	}
+
+	return i;
+}
+
+static void plan_free(struct plan *pl)
+{
+	free(pl->first);
+	free(pl->last);
+	free(pl->hosts);
+
+	return;
+}
+
+static inline int64_t plan_bucket(const struct plan *pl, uint32_t addr)
+{
+	uint32_t off = addr - pl->sp.base;
+	uint64_t idx;
+	size_t lo = 0, hi = pl->sp.count, mid;
+
+	if (off > pl->span_last) { return -1; }
+
+	if (!pl->sp.parts) {
+		/* A single /0 subnet shifts by 32, out of range for off itself */
+		idx = (uint64_t) off >> pl->shift;
+		return idx < pl->sp.count ? (int64_t) idx : -1;
+	}
+
+	/* Last subnet starting at or before addr */
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (pl->first[mid] <= addr) { lo = mid + 1; }
+		else { hi = mid; }
+	}
+	if (!lo || addr > pl->last[lo - 1]) { return -1; }
+
+	return (int64_t) (lo - 1);
+}
+
+static int count_stream(struct plan *pl, FILE *fp)
+{
+	uint32_t addrs[OCC_BATCH];
+	struct token_reader rd;
+	struct prefix pfx;
+	char *tok = NULL;
+	size_t n;
+	int64_t idx;
+	STATS_DECL(t);
+
+	if (token_reader_init(&rd, fp) == -1) { return -1; }
+
+	do {
+		STATS_MARK(t);
+		for (n = 0; n < OCC_BATCH && (tok = token_reader_next(&rd)); n++) {
+			if (parse_prefix(tok, &pfx) == -1 || pfx.bitmask != 32) {
+				fprintf(stderr, "ipc: invalid entry '%s'\n", tok);
+				token_reader_free(&rd);
+				return -1;
+			}
+			addrs[n] = pfx.addr;
+		}
+		STATS_LAP(t, stage_parse);
+		STATS_ITEMS(n);
+
+		for (size_t i = 0; i < n; i++) {
+			idx = plan_bucket(pl, addrs[i]);
+			if (idx < 0) { pl->outside++; }
+			else { pl->hosts[idx]++; }
+		}
+		pl->total += n;
+		STATS_LAP(t, stage_derive);
+	} while (n == OCC_BATCH);
+
+	token_reader_free(&rd);
+
+	if (ferror(fp)) { return -1; }
+
+	return 0;
+}
+
+static int report(const struct plan *pl, double threshold, int flagged)
+{
+	struct ipc_split sp = pl->sp;
+	struct ipc_subnet sn;
+	struct outbuf *ob = NULL;
+	uint64_t usable, empty = 0, over = 0;
+	double util;
+	const char *status;
+	char pct[16];
+	char *dst = NULL;
+	int len, res;
+
+	ob = malloc(sizeof(struct outbuf));
+	if (!ob) { return -1; }
+	outbuf_init(ob, stdout);
+
+	dst = outbuf_reserve(ob, ROW_MAX);
+	len = snprintf(dst, ROW_MAX, "%5s%-20s%-12s%-12s%-10s%s\n", "", "SUBNET", "HOSTS",
+				   "USABLE", "UTIL", "STATUS");
+	ob->len += len < ROW_MAX ? len : ROW_MAX - 1;
+
+	for (uint64_t i = 0; ipc_split_next(&sp, &sn); i++) {
+		/* /31 has two hosts, /32 one (RFC 3021) */
+		usable = sn.bitmask >= BITS_IN_IP - 1 ? prefix_size(sn.bitmask)
+											   : prefix_size(sn.bitmask) - 2;
+		util = pl->hosts[i] * 100.0 / usable;
+
+		status = "";
+		if (!pl->hosts[i]) {
+			status = "empty";
+			empty++;
+		}
+		else if (util > threshold) {
+			status = "over";
+			over++;
+		}
+		if (flagged && !*status) { continue; }
+
+		snprintf(pct, sizeof(pct), "%.2f%%", util);
+		dst = outbuf_reserve(ob, ROW_MAX);
+		len = snprintf(dst, ROW_MAX, "%-5" PRIu64 "%03u.%03u.%03u.%03u/%-4u%-12" PRIu64
+					   "%-12" PRIu64 "%-10s%s\n", i, sn.first >> 24, sn.first >> 16 & 0xff,
+					   sn.first >> 8 & 0xff, sn.first & 0xff, sn.bitmask, pl->hosts[i],
+					   usable, pct, status);
+		ob->len += len < ROW_MAX ? len : ROW_MAX - 1;
+	}
+
+	dst = outbuf_reserve(ob, 4 * ROW_MAX);
+	len = snprintf(dst, 4 * ROW_MAX, "\n%-15s%" PRIu64 "\n%-15s%" PRIu64 "\n%-15s%" PRIu64
+				   "\n%-15s%" PRIu64 " (above %.2f%%)\n", "Hosts", pl->total, "Outside plan",
+				   pl->outside, "Empty", empty, "Over", over, threshold);
+	ob->len += len < 4 * ROW_MAX ? len : 4 * ROW_MAX - 1;
+
+	res = outbuf_flush(ob);
+	free(ob);
+
+	return res;
+}
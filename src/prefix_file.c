@@ -0,0 +1,381 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "sort.h"
+#include "prefix_file.h"
+
+#define VARINT_MAX			10				/* Bytes of a 64-bit LEB128 */
+#define TABLE_HEAD_SIZE		((PREFIX_LENGTHS + 1) * sizeof(uint32_t))
+
+/* Sections start on 8-byte boundaries */
+#define ALIGN8(n)			(((n) + 7) & ~(uint64_t) 7)
+
+/**
+ * @brief Checksum of a byte range.
+ *
+ * Word at a time multiply-xorshift, a few GB/s.
+ *
+ * @param p Bytes.
+ * @param n Number of bytes, a multiple of 8.
+ * @return Checksum.
+ */
+static uint64_t checksum(const uint8_t *p, size_t n);
+
+/**
+ * @brief Append a LEB128 varint.
+ * @param dst Destination, VARINT_MAX bytes free.
+ * @param val Value.
+ * @return Pointer past the last written byte.
+ */
+static uint8_t *put_varint(uint8_t *dst, uint64_t val);
+
+/**
+ * @brief Check the lookup table section and point a table at it.
+ * @param pf Mapping with the header set.
+ * @return 0 on success, -1 if the section is out of bounds or damaged.
+ */
+static int map_table(struct prefix_file *pf);
+
+int prefix_file_write(FILE *fp, struct prefix *items, size_t *len, int with_table)
+{
+	struct prefix_file_header hdr;
+	struct prefix_file_block *index = NULL;
+	struct prefix_table tab;
+	uint64_t *keys = NULL;
+	uint8_t *body = NULL;
+	uint8_t *p = NULL;
+	uint64_t index_size, data_max, data_size, table_size, body_size;
+	uint32_t block_count;
+	size_t uniq = 0;
+
+	if (!fp || !len || (!items && *len)) { return -1; }
+
+	memset(&tab, 0, sizeof(struct prefix_table));
+
+	keys = malloc((*len ? *len : 1) * sizeof(uint64_t));
+	if (!keys) { return -1; }
+
+	for (size_t i = 0; i < *len; i++) {
+		keys[i] = (uint64_t) (items[i].addr & prefix_netmask(items[i].bitmask)) << 8 |
+				  items[i].bitmask;
+	}
+	if (sort_u64(keys, *len) == -1) { goto handle_error; }
+
+	for (size_t i = 0; i < *len; i++) {
+		if (i && keys[i] == keys[i - 1]) { continue; }
+		keys[uniq] = keys[i];
+		items[uniq].addr = keys[i] >> 8;
+		items[uniq].bitmask = keys[i] & 0xFF;
+		uniq++;
+	}
+	*len = uniq;
+
+	if (with_table && prefix_table_build(&tab, items, uniq) == -1) { goto handle_error; }
+
+	block_count = (uniq + PREFIX_FILE_BLOCK - 1) / PREFIX_FILE_BLOCK;
+	index_size = (uint64_t) block_count * sizeof(struct prefix_file_block);
+	data_max = ALIGN8((uint64_t) uniq * VARINT_MAX);
+	table_size = with_table ? ALIGN8(TABLE_HEAD_SIZE + (uint64_t) uniq * sizeof(uint32_t)) : 0;
+
+	/* Everything after the header, sized for the worst case */
+	body = calloc(1, index_size + data_max + table_size);
+	if (!body) { goto handle_error; }
+
+	index = (struct prefix_file_block *) body;
+	p = body + index_size;
+
+	for (size_t i = 0; i < uniq; i++) {
+		if (i % PREFIX_FILE_BLOCK == 0) {
+			index[i / PREFIX_FILE_BLOCK].first_key = keys[i];
+			index[i / PREFIX_FILE_BLOCK].offset = p - (body + index_size);
+			continue;
+		}
+		p = put_varint(p, keys[i] - keys[i - 1]);
+	}
+
+	data_size = p - (body + index_size);
+	body_size = index_size + ALIGN8(data_size);
+
+	if (with_table) {
+		p = body + body_size;
+		memcpy(p, tab.offsets, TABLE_HEAD_SIZE);
+		memcpy(p + TABLE_HEAD_SIZE, tab.keys, (size_t) uniq * sizeof(uint32_t));
+		body_size += table_size;
+	}
+
+	memset(&hdr, 0, sizeof(struct prefix_file_header));
+	memcpy(hdr.magic, PREFIX_FILE_MAGIC, sizeof(hdr.magic));
+	hdr.version = PREFIX_FILE_VERSION;
+	hdr.flags = with_table ? PREFIX_FILE_TABLE : 0;
+	hdr.count = uniq;
+	hdr.block_keys = PREFIX_FILE_BLOCK;
+	hdr.block_count = block_count;
+	hdr.index_offset = sizeof(struct prefix_file_header);
+	hdr.data_offset = hdr.index_offset + index_size;
+	hdr.data_size = data_size;
+	hdr.table_offset = with_table ? hdr.data_offset + ALIGN8(data_size) : 0;
+	hdr.file_size = sizeof(struct prefix_file_header) + body_size;
+	hdr.checksum = checksum(body, body_size);
+
+	if (fwrite(&hdr, sizeof(struct prefix_file_header), 1, fp) != 1) { goto handle_error; }
+	if (body_size && fwrite(body, body_size, 1, fp) != 1) { goto handle_error; }
+
+	free(keys);
+	free(body);
+	prefix_table_free(&tab);
+
+	return 0;
+
+	handle_error:
+		free(keys);
+		free(body);
+		prefix_table_free(&tab);
+		return -1;
+}
+
+int prefix_file_sniff(FILE *fp)
+{
+	char magic[sizeof(PREFIX_FILE_MAGIC) - 1];
+	size_t got;
+
+	/* Pipes can not seek back, they are text */
+	if (!fp || ftell(fp) != 0) { return 0; }
+
+	got = fread(magic, 1, sizeof(magic), fp);
+	if (fseek(fp, 0, SEEK_SET) == -1) { return 0; }
+
+	return got == sizeof(magic) && memcmp(magic, PREFIX_FILE_MAGIC, sizeof(magic)) == 0;
+}
+
+int prefix_file_map(struct prefix_file *pf, int fd)
+{
+	const struct prefix_file_header *hdr = NULL;
+	struct stat st;
+	void *map = NULL;
+	uint64_t size;
+
+	if (!pf) { return -1; }
+
+	memset(pf, 0, sizeof(struct prefix_file));
+
+	if (fstat(fd, &st) == -1) { return -1; }
+	if ((uint64_t) st.st_size < sizeof(struct prefix_file_header)) { return -1; }
+	size = st.st_size;
+
+	map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (map == MAP_FAILED) { return -1; }
+
+	pf->map = map;
+	pf->size = size;
+	pf->hdr = hdr = map;
+
+	if (memcmp(hdr->magic, PREFIX_FILE_MAGIC, sizeof(hdr->magic)) != 0) { goto handle_error; }
+	if (hdr->version != PREFIX_FILE_VERSION) { goto handle_error; }
+	if (hdr->file_size != size || size % 8) { goto handle_error; }
+	if (hdr->block_keys != PREFIX_FILE_BLOCK) { goto handle_error; }
+	if (hdr->count > ((uint64_t) 1 << 40)) { goto handle_error; }
+	if (hdr->block_count != (hdr->count + PREFIX_FILE_BLOCK - 1) / PREFIX_FILE_BLOCK) { goto handle_error; }
+
+	/* Sections inside the file, offsets small enough not to overflow */
+	if (hdr->index_offset % 8 || hdr->index_offset > size) { goto handle_error; }
+	if ((uint64_t) hdr->block_count * sizeof(struct prefix_file_block) > size - hdr->index_offset) {
+		goto handle_error;
+	}
+	if (hdr->data_offset > size || hdr->data_size > size - hdr->data_offset) { goto handle_error; }
+
+	pf->index = (const struct prefix_file_block *) (pf->map + hdr->index_offset);
+	pf->data = pf->map + hdr->data_offset;
+
+	if ((hdr->flags & PREFIX_FILE_TABLE) && map_table(pf) == -1) { goto handle_error; }
+
+	return 0;
+
+	handle_error:
+		prefix_file_close(pf);
+		return -1;
+}
+
+int prefix_file_open(struct prefix_file *pf, const char *path)
+{
+	int fd;
+	int res;
+
+	if (!path) { return -1; }
+
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd == -1) { return -1; }
+
+	res = prefix_file_map(pf, fd);
+	close(fd);
+
+	return res;
+}
+
+size_t prefix_file_block(const struct prefix_file *pf, uint32_t block, struct prefix *out)
+{
+	const uint8_t *p = NULL;
+	const uint8_t *end = NULL;
+	uint64_t key, delta, start, stop;
+	size_t n;
+	int shift;
+
+	if (!pf || !pf->hdr || block >= pf->hdr->block_count) { return 0; }
+
+	n = block + 1 < pf->hdr->block_count ? PREFIX_FILE_BLOCK :
+		pf->hdr->count - (uint64_t) block * PREFIX_FILE_BLOCK;
+
+	start = pf->index[block].offset;
+	stop = block + 1 < pf->hdr->block_count ? pf->index[block + 1].offset : pf->hdr->data_size;
+	if (start > stop || stop > pf->hdr->data_size) { return 0; }
+
+	p = pf->data + start;
+	end = pf->data + stop;
+	key = pf->index[block].first_key;
+
+	for (size_t i = 0; i < n; i++) {
+		if (i) {
+			delta = 0;
+			shift = 0;
+			do {
+				if (p == end || shift > 63) { return 0; }
+				delta |= (uint64_t) (*p & 0x7F) << shift;
+				shift += 7;
+			} while (*p++ & 0x80);
+			key += delta;
+		}
+
+		if ((key & 0xFF) > BITS_IN_IP) { return 0; }
+		out[i].addr = (uint32_t) (key >> 8);
+		out[i].bitmask = key & 0xFF;
+	}
+
+	return n;
+}
+
+int prefix_file_verify(const struct prefix_file *pf)
+{
+	struct prefix buf[PREFIX_FILE_BLOCK];
+	const struct prefix_table *tab = NULL;
+	uint64_t key, prev = 0;
+	uint64_t total = 0;
+	size_t n;
+
+	if (!pf || !pf->hdr) { return -1; }
+
+	if (checksum(pf->map + sizeof(struct prefix_file_header),
+				 pf->size - sizeof(struct prefix_file_header)) != pf->hdr->checksum) {
+		return -1;
+	}
+
+	for (uint32_t b = 0; b < pf->hdr->block_count; b++) {
+		n = prefix_file_block(pf, b, buf);
+		if (!n) { return -1; }
+
+		for (size_t i = 0; i < n; i++) {
+			key = (uint64_t) buf[i].addr << 8 | buf[i].bitmask;
+			if (total && key <= prev) { return -1; }
+			if (buf[i].addr & ~prefix_netmask(buf[i].bitmask)) { return -1; }
+			prev = key;
+			total++;
+		}
+	}
+
+	if (total != pf->hdr->count) { return -1; }
+
+	/* Lookup table: every group ascending */
+	tab = &pf->table;
+	for (int l = 0; l < PREFIX_LENGTHS && tab->keys; l++) {
+		for (uint32_t i = tab->offsets[l] + 1; i < tab->offsets[l + 1]; i++) {
+			if (tab->keys[i] <= tab->keys[i - 1]) { return -1; }
+		}
+	}
+
+	return 0;
+}
+
+void prefix_file_close(struct prefix_file *pf)
+{
+	if (!pf) { return; }
+
+	if (pf->map) { munmap((void *) pf->map, pf->size); }
+	memset(pf, 0, sizeof(struct prefix_file));
+
+	return;
+}
+
+static int map_table(struct prefix_file *pf)
+{
+	const struct prefix_file_header *hdr = pf->hdr;
+	const uint32_t *offsets = NULL;
+	uint64_t need;
+
+	if (hdr->table_offset % 8 || hdr->table_offset > pf->size) { return -1; }
+
+	need = TABLE_HEAD_SIZE + hdr->count * sizeof(uint32_t);
+	if (need > pf->size - hdr->table_offset) { return -1; }
+
+	offsets = (const uint32_t *) (pf->map + hdr->table_offset);
+	if (offsets[0] != 0 || offsets[PREFIX_LENGTHS] != hdr->count) { return -1; }
+
+	for (int l = 0; l < PREFIX_LENGTHS; l++) {
+		if (offsets[l + 1] < offsets[l]) { return -1; }
+		if (offsets[l + 1] > offsets[l]) { pf->table.lengths |= (uint64_t) 1 << l; }
+		pf->table.offsets[l] = offsets[l];
+	}
+	pf->table.offsets[PREFIX_LENGTHS] = offsets[PREFIX_LENGTHS];
+
+	/* Queries read the mapping, nothing is copied */
+	pf->table.keys = (const uint32_t *) (pf->map + hdr->table_offset + TABLE_HEAD_SIZE);
+	pf->table.owned = NULL;
+
+	return 0;
+}
+
+static uint64_t checksum(const uint8_t *p, size_t n)
+{
+	uint64_t h = 0x9e3779b97f4a7c15ULL ^ n;
+	uint64_t w;
+
+	for (size_t i = 0; i + 8 <= n; i += 8) {
+		memcpy(&w, p + i, 8);
+		h = (h ^ w) * 0xff51afd7ed558ccdULL;
+		h ^= h >> 32;
+	}
+
+	return h;
+}
+
+static uint8_t *put_varint(uint8_t *dst, uint64_t val)
+{
+	while (val >= 0x80) {
+		*dst++ = (uint8_t) val | 0x80;
+		val >>= 7;
+	}
+	*dst++ = (uint8_t) val;
+
+	return dst;
+}
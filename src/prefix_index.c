@@ -0,0 +1,187 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "fill_ipv4.h"
+#include "prefix_list.h"
+#include "prefix_table.h"
+#include "sort.h"
+#include "prefix_index.h"
+
+/**
+ * @brief Position of the first key not less than key.
+ * @param keys Sorted keys.
+ * @param len Number of keys.
+ * @param key Key to find.
+ * @return Position, len if every key is less.
+ */
+static size_t lower_bound(const uint64_t *keys, size_t len, uint64_t key);
+
+/**
+ * @brief Check whether a stored prefix holds a network.
+ * @param key Stored prefix.
+ * @param addr Network address.
+ * @param bitmask Mask length.
+ * @return 1 if it does, 0 otherwise.
+ */
+static int holds(uint64_t key, uint32_t addr, uint8_t bitmask);
+
+int prefix_index_build(struct prefix_index *ix, const struct prefix *items, size_t len)
+{
+	/* Last addresses of the holders of the current prefix */
+	uint64_t last[PREFIX_LENGTHS];
+	uint32_t holder[PREFIX_LENGTHS];
+	uint64_t first;
+	size_t uniq = 0;
+	uint8_t bitmask;
+	int depth = 0;
+
+	if (!ix || (!items && len)) { return -1; }
+	if (len >= UINT32_MAX) { return -1; }
+
+	memset(ix, 0, sizeof(struct prefix_index));
+
+	ix->keys = malloc((len ? len : 1) * sizeof(uint64_t));
+	ix->parent = malloc((len ? len : 1) * sizeof(uint32_t));
+	if (!ix->keys || !ix->parent) { goto handle_error; }
+
+	for (size_t i = 0; i < len; i++) {
+		bitmask = items[i].bitmask;
+		ix->keys[i] = (uint64_t) (items[i].addr & prefix_netmask(bitmask)) << 8 | bitmask;
+	}
+
+	if (sort_u64(ix->keys, len) == -1) { goto handle_error; }
+
+	/* Holders come first in this order, a stack tracks the open ones */
+	for (size_t i = 0; i < len; i++) {
+		if (uniq && ix->keys[i] == ix->keys[uniq - 1]) { continue; }
+		ix->keys[uniq] = ix->keys[i];
+
+		first = ix->keys[uniq] >> 8;
+		while (depth && last[depth - 1] < first) { depth--; }
+
+		ix->parent[uniq] = depth ? holder[depth - 1] : PREFIX_INDEX_NONE;
+
+		last[depth] = first + prefix_size((uint8_t) ix->keys[uniq]) - 1;
+		holder[depth++] = (uint32_t) uniq;
+		uniq++;
+	}
+
+	ix->len = uniq;
+
+	return 0;
+
+	handle_error:
+		prefix_index_free(ix);
+		return -1;
+}
+
+int prefix_index_read(struct prefix_index *ix, FILE *const *fps, size_t n)
+{
+	struct prefix *items = NULL;
+	size_t len = 0;
+	int res;
+
+	if (!ix || (!fps && n)) { return -1; }
+
+	if (prefix_table_collect(fps, n, &items, &len) == -1) { return -1; }
+
+	res = prefix_index_build(ix, items, len);
+	free(items);
+
+	return res;
+}
+
+size_t prefix_index_inside(const struct prefix_index *ix, uint32_t addr, uint8_t bitmask,
+						   size_t *first)
+{
+	uint64_t lo, hi;
+	size_t begin;
+
+	if (!ix || !first || bitmask > BITS_IN_IP) { return 0; }
+
+	addr &= prefix_netmask(bitmask);
+	lo = (uint64_t) addr << 8 | bitmask;
+	hi = (addr + prefix_size(bitmask)) << 8;
+
+	/* Shorter prefixes at the same address hold it and sort before lo */
+	begin = lower_bound(ix->keys, ix->len, lo);
+	*first = begin;
+
+	return lower_bound(ix->keys + begin, ix->len - begin, hi);
+}
+
+size_t prefix_index_containing(const struct prefix_index *ix, uint32_t addr, uint8_t bitmask,
+							   uint32_t *out)
+{
+	uint32_t chain[PREFIX_LENGTHS];
+	uint32_t i;
+	size_t pos, n = 0;
+
+	if (!ix || !out || bitmask > BITS_IN_IP) { return 0; }
+
+	addr &= prefix_netmask(bitmask);
+
+	/* Last prefix not after the query; its holders include the query's */
+	pos = lower_bound(ix->keys, ix->len, ((uint64_t) addr << 8 | bitmask) + 1);
+	if (!pos) { return 0; }
+
+	i = (uint32_t) (pos - 1);
+	while (i != PREFIX_INDEX_NONE && !holds(ix->keys[i], addr, bitmask)) { i = ix->parent[i]; }
+
+	for (; i != PREFIX_INDEX_NONE; i = ix->parent[i]) { chain[n++] = i; }
+
+	for (size_t k = 0; k < n; k++) { out[k] = chain[n - 1 - k]; }
+
+	return n;
+}
+
+void prefix_index_free(struct prefix_index *ix)
+{
+	if (!ix) { return; }
+
+	free(ix->keys);
+	free(ix->parent);
+	memset(ix, 0, sizeof(struct prefix_index));
+
+	return;
+}
+
+static size_t lower_bound(const uint64_t *keys, size_t len, uint64_t key)
+{
+	size_t lo = 0, hi = len, mid;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (keys[mid] < key) { lo = mid + 1; }
+		else { hi = mid; }
+	}
+
+	return lo;
+}
+
+static int holds(uint64_t key, uint32_t addr, uint8_t bitmask)
+{
+	uint8_t len = (uint8_t) key;
+
+	return len <= bitmask && (addr & prefix_netmask(len)) == (uint32_t) (key >> 8);
+}
@@ -0,0 +1,205 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ipv4_t.h"
+#include "fill_ipv4.h"
+#include "prefix_list.h"
+
+#define READER_CHUNK		(1 << 20)
+#define ADDR_STR_MAX		16
+
+/**
+ * @brief Move unread data to the buffer start and read more.
+ * @param rd Reader.
+ * @return 0 on success, -1 on error.
+ */
+static int refill(struct token_reader *rd);
+
+static int is_space(char c)
+{ return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f'; }
+
+int token_reader_init(struct token_reader *rd, FILE *fp)
+{
+	if (!rd || !fp) { return -1; }
+
+	memset(rd, 0, sizeof(struct token_reader));
+
+	/* One extra byte for the terminator of the last token */
+	rd->buf = malloc(READER_CHUNK + 1);
+	if (!rd->buf) { return -1; }
+
+	rd->fp = fp;
+	rd->cap = READER_CHUNK;
+
+	return 0;
+}
+
+char *token_reader_next(struct token_reader *rd)
+{
+	size_t start, end;
+
+	if (!rd || !rd->buf) { return NULL; }
+
+	for (;;) {
+		/* Skip separators and comments */
+		while (rd->pos < rd->len) {
+			if (rd->in_comment) {
+				if (rd->buf[rd->pos] == '\n') { rd->in_comment = 0; }
+			}
+			else if (rd->buf[rd->pos] == '#') { rd->in_comment = 1; }
+			else if (!is_space(rd->buf[rd->pos])) { break; }
+			rd->pos++;
+		}
+
+		if (rd->pos == rd->len) {
+			if (rd->eof) { return NULL; }
+			if (refill(rd) == -1) { return NULL; }
+			continue;
+		}
+
+		start = rd->pos;
+		end = start;
+		while (end < rd->len && !is_space(rd->buf[end]) && rd->buf[end] != '#') {
+			end++;
+		}
+
+		/* Token may continue in the next chunk */
+		if (end == rd->len && !rd->eof) {
+			if (refill(rd) == -1) { return NULL; }
+			continue;
+		}
+
+		if (end < rd->len && rd->buf[end] == '#') { rd->in_comment = 1; }
+
+		rd->buf[end] = '\0';
+		rd->pos = end < rd->len ? end + 1 : end;
+
+		return rd->buf + start;
+	}
+}
+
+void token_reader_free(struct token_reader *rd)
+{
+	if (!rd) { return; }
+
+	free(rd->buf);
+	rd->buf = NULL;
+
+	return;
+}
+
+int parse_prefix(const char *tok, struct prefix *pfx)
+{
+	ipv4_t ip;
+
+	if (!tok || !pfx) { return -1; }
+
+	memset(&ip, 0, sizeof(ipv4_t));
+
+	if (!fill_addr(&ip, tok)) { return -1; }
+
+	if (strchr(tok, '/')) {
+		if (!fill_bitmask(&ip, tok)) { return -1; }
+	}
+	else { ip.bitmask = BITS_IN_IP; }
+
+	pfx->addr = addr_to_u32(ip.addr);
+	pfx->bitmask = ip.bitmask;
+
+	return 0;
+}
+
+int parse_interval(const char *tok, uint32_t *first, uint32_t *last)
+{
+	char first_str[ADDR_STR_MAX];
+	const char *dash = NULL;
+	struct prefix pfx;
+	size_t first_len;
+
+	if (!tok || !first || !last) { return -1; }
+
+	dash = strchr(tok, '-');
+	if (!dash) {
+		if (parse_prefix(tok, &pfx) == -1) { return -1; }
+		*first = pfx.addr & prefix_netmask(pfx.bitmask);
+		*last = *first + (uint32_t) (prefix_size(pfx.bitmask) - 1);
+		return 0;
+	}
+
+	first_len = dash - tok;
+	if (first_len >= ADDR_STR_MAX) { return -1; }
+	memcpy(first_str, tok, first_len);
+	first_str[first_len] = '\0';
+
+	/* A range is made of bare addresses */
+	if (strchr(first_str, '/') || strchr(dash + 1, '/')) { return -1; }
+
+	if (parse_prefix(first_str, &pfx) == -1) { return -1; }
+	*first = pfx.addr;
+	if (parse_prefix(dash + 1, &pfx) == -1) { return -1; }
+	*last = pfx.addr;
+
+	if (*first > *last) { return -1; }
+
+	return 0;
+}
+
+uint32_t prefix_netmask(uint8_t bitmask)
+{
+	if (bitmask == 0) { return 0; }
+	if (bitmask >= BITS_IN_IP) { return UINT32_MAX; }
+
+	return UINT32_MAX << (BITS_IN_IP - bitmask);
+}
+
+uint64_t prefix_size(uint8_t bitmask)
+{
+	if (bitmask > BITS_IN_IP) { return 0; }
+
+	return (uint64_t) 1 << (BITS_IN_IP - bitmask);
+}
+
+static int refill(struct token_reader *rd)
+{
+	size_t left, got;
+	char *new_buf = NULL;
+
+	left = rd->len - rd->pos;
+	memmove(rd->buf, rd->buf + rd->pos, left);
+	rd->len = left;
+	rd->pos = 0;
+
+	/* A single token fills the whole buffer */
+	if (rd->len == rd->cap) {
+		new_buf = realloc(rd->buf, rd->cap * 2 + 1);
+		if (!new_buf) { return -1; }
+		rd->buf = new_buf;
+		rd->cap *= 2;
+	}
+
+	got = fread(rd->buf + rd->len, 1, rd->cap - rd->len, rd->fp);
+	rd->len += got;
+	if (got == 0) { rd->eof = 1; }
+
+	return 0;
+}
@@ -0,0 +1,248 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "sort.h"
+#include "prefix_file.h"
+#include "prefix_table.h"
+
+/**
+ * @brief Binary search in one length group.
+ * @param tab Table.
+ * @param bitmask Group.
+ * @param key Network address.
+ * @return 1 if present, 0 otherwise.
+ */
+static int group_has(const struct prefix_table *tab, uint8_t bitmask, uint32_t key);
+
+/**
+ * @brief Append every prefix of a compiled set.
+ * @param fp Stream at offset 0 holding a compiled set.
+ * @param[in,out] items Growing array.
+ * @param[in,out] len Prefixes in the array.
+ * @param[in,out] cap Capacity of the array.
+ * @return 0 on success, -1 on error.
+ */
+static int read_compiled(FILE *fp, struct prefix **items, size_t *len, size_t *cap);
+
+int prefix_table_build(struct prefix_table *tab, const struct prefix *items, size_t len)
+{
+	uint64_t *packed = NULL;
+	uint32_t *keys = NULL;
+	size_t uniq = 0;
+	uint8_t bitmask;
+
+	if (!tab || (!items && len)) { return -1; }
+	if (len > UINT32_MAX) { return -1; }
+
+	memset(tab, 0, sizeof(struct prefix_table));
+
+	/* Sorting (length << 32 | network) groups and orders in one go */
+	packed = malloc((len ? len : 1) * sizeof(uint64_t));
+	if (!packed) { return -1; }
+
+	for (size_t i = 0; i < len; i++) {
+		bitmask = items[i].bitmask;
+		packed[i] = (uint64_t) bitmask << 32 | (items[i].addr & prefix_netmask(bitmask));
+	}
+
+	if (sort_u64(packed, len) == -1) { goto handle_error; }
+
+	keys = malloc((len ? len : 1) * sizeof(uint32_t));
+	if (!keys) { goto handle_error; }
+
+	for (size_t i = 0; i < len; i++) {
+		if (i && packed[i] == packed[i - 1]) { continue; }
+
+		bitmask = packed[i] >> 32;
+		tab->offsets[bitmask + 1]++;
+		tab->lengths |= (uint64_t) 1 << bitmask;
+		keys[uniq++] = (uint32_t) packed[i];
+	}
+
+	/* Counts to start offsets */
+	for (int l = 1; l <= PREFIX_LENGTHS; l++) { tab->offsets[l] += tab->offsets[l - 1]; }
+
+	free(packed);
+
+	tab->keys = keys;
+	tab->owned = keys;
+
+	return 0;
+
+	handle_error:
+		free(packed);
+		return -1;
+}
+
+int prefix_table_read(struct prefix_table *tab, FILE *const *fps, size_t n)
+{
+	struct prefix *items = NULL;
+	size_t len = 0;
+	int res;
+
+	if (!tab || (!fps && n)) { return -1; }
+
+	if (prefix_table_collect(fps, n, &items, &len) == -1) { return -1; }
+
+	res = prefix_table_build(tab, items, len);
+	free(items);
+
+	return res;
+}
+
+int prefix_table_collect(FILE *const *fps, size_t n, struct prefix **out, size_t *out_len)
+{
+	struct token_reader rd;
+	struct prefix *items = NULL;
+	struct prefix *new_items = NULL;
+	size_t len = 0, cap = 0;
+	char *tok = NULL;
+
+	if ((!fps && n) || !out || !out_len) { return -1; }
+
+	for (size_t f = 0; f < n; f++) {
+		if (prefix_file_sniff(fps[f])) {
+			if (read_compiled(fps[f], &items, &len, &cap) == -1) { goto handle_error; }
+			continue;
+		}
+
+		if (token_reader_init(&rd, fps[f]) == -1) { goto handle_error; }
+
+		while ((tok = token_reader_next(&rd))) {
+			if (len == cap) {
+				cap = cap ? cap * 2 : 4096;
+				new_items = realloc(items, cap * sizeof(struct prefix));
+				if (!new_items) { goto handle_reader_error; }
+				items = new_items;
+			}
+
+			if (parse_prefix(tok, &items[len]) == -1) { goto handle_reader_error; }
+			len++;
+		}
+
+		token_reader_free(&rd);
+	}
+
+	*out = items;
+	*out_len = len;
+
+	return 0;
+
+	handle_reader_error:
+		token_reader_free(&rd);
+	handle_error:
+		free(items);
+		return -1;
+}
+
+int prefix_table_lookup(const struct prefix_table *tab, uint32_t addr, struct prefix *pfx)
+{
+	uint64_t lengths;
+	int bitmask;
+	uint32_t key;
+
+	if (!tab || !pfx) { return 0; }
+
+	/* Longest lengths first */
+	for (lengths = tab->lengths; lengths; lengths &= ~((uint64_t) 1 << bitmask)) {
+		bitmask = 63 - __builtin_clzll(lengths);
+		key = addr & prefix_netmask(bitmask);
+
+		if (group_has(tab, bitmask, key)) {
+			pfx->addr = key;
+			pfx->bitmask = bitmask;
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+int prefix_table_contains(const struct prefix_table *tab, uint32_t addr, uint8_t bitmask)
+{
+	if (!tab || bitmask > BITS_IN_IP) { return 0; }
+	if (!(tab->lengths >> bitmask & 1)) { return 0; }
+
+	return group_has(tab, bitmask, addr & prefix_netmask(bitmask));
+}
+
+size_t prefix_table_size(const struct prefix_table *tab)
+{
+	if (!tab) { return 0; }
+
+	return tab->offsets[PREFIX_LENGTHS];
+}
+
+void prefix_table_free(struct prefix_table *tab)
+{
+	if (!tab) { return; }
+
+	free(tab->owned);
+	memset(tab, 0, sizeof(struct prefix_table));
+
+	return;
+}
+
+static int group_has(const struct prefix_table *tab, uint8_t bitmask, uint32_t key)
+{
+	size_t lo = tab->offsets[bitmask];
+	size_t hi = tab->offsets[bitmask + 1];
+	size_t mid;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (tab->keys[mid] < key) { lo = mid + 1; }
+		else { hi = mid; }
+	}
+
+	return lo < tab->offsets[bitmask + 1] && tab->keys[lo] == key;
+}
+
+static int read_compiled(FILE *fp, struct prefix **items, size_t *len, size_t *cap)
+{
+	struct prefix_file pf;
+	struct prefix *new_items = NULL;
+	size_t n;
+
+	if (prefix_file_map(&pf, fileno(fp)) == -1) { return -1; }
+
+	if (*len + pf.hdr->count > *cap) {
+		*cap = *len + pf.hdr->count;
+		new_items = realloc(*items, (*cap ? *cap : 1) * sizeof(struct prefix));
+		if (!new_items) { goto handle_error; }
+		*items = new_items;
+	}
+
+	for (uint32_t b = 0; b < pf.hdr->block_count; b++) {
+		n = prefix_file_block(&pf, b, *items + *len);
+		if (!n) { goto handle_error; }
+		*len += n;
+	}
+
+	prefix_file_close(&pf);
+	return 0;
+
+	handle_error:
+		prefix_file_close(&pf);
+		return -1;
+}
@@ -0,0 +1,185 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "prng.h"
+
+/**
+ * @brief splitmix64 step, spreads a seed over the whole state.
+ * @param x Mixer state.
+ * @return Next mixed value.
+ */
+static uint64_t splitmix64(uint64_t *x);
+
+/* Alias table probabilities are fractions of 2^32 */
+#define ALIAS_ONE			((uint64_t) 1 << 32)
+
+static uint64_t rotl(uint64_t x, int k)
+{ return (x << k) | (x >> (64 - k)); }
+
+void prng_seed(struct prng *rng, uint64_t seed)
+{
+	if (!rng) { return; }
+
+	for (int i = 0; i < 4; i++) { rng->s[i] = splitmix64(&seed); }
+
+	return;
+}
+
+uint64_t prng_next(struct prng *rng)
+{
+	uint64_t res, t;
+
+	res = rotl(rng->s[1] * 5, 7) * 9;
+	t = rng->s[1] << 17;
+
+	rng->s[2] ^= rng->s[0];
+	rng->s[3] ^= rng->s[1];
+	rng->s[1] ^= rng->s[2];
+	rng->s[0] ^= rng->s[3];
+	rng->s[2] ^= t;
+	rng->s[3] = rotl(rng->s[3], 45);
+
+	return res;
+}
+
+uint64_t prng_bounded(struct prng *rng, uint64_t bound)
+{
+	unsigned __int128 m;
+	uint64_t low, threshold;
+
+	/* Lemire's multiply-shift with rejection of the biased tail */
+	m = (unsigned __int128) prng_next(rng) * bound;
+	low = (uint64_t) m;
+	if (low < bound) {
+		threshold = -bound % bound;
+		while (low < threshold) {
+			m = (unsigned __int128) prng_next(rng) * bound;
+			low = (uint64_t) m;
+		}
+	}
+
+	return m >> 64;
+}
+
+uint64_t prng_entropy(void)
+{
+	struct timespec ts;
+	uint64_t x;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	x = (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+	x ^= (uint64_t) getpid() << 32;
+
+	return splitmix64(&x);
+}
+
+int prng_alias_init(struct prng_alias *tab, const double *weights, size_t len)
+{
+	uint32_t *small = NULL;
+	uint32_t *large = NULL;
+	double *scaled = NULL;
+	double sum = 0;
+	size_t n_small = 0, n_large = 0;
+	uint32_t s, l;
+
+	if (!tab || !weights || !len || len > UINT32_MAX) { return -1; }
+
+	memset(tab, 0, sizeof(struct prng_alias));
+
+	tab->prob = malloc(len * sizeof(uint64_t));
+	tab->alias = malloc(len * sizeof(uint32_t));
+	small = malloc(len * sizeof(uint32_t));
+	large = malloc(len * sizeof(uint32_t));
+	scaled = malloc(len * sizeof(double));
+	if (!tab->prob || !tab->alias || !small || !large || !scaled) { goto handle_error; }
+	tab->len = len;
+
+	for (size_t i = 0; i < len; i++) { sum += weights[i]; }
+
+	for (size_t i = 0; i < len; i++) {
+		scaled[i] = weights[i] * len / sum;
+		if (scaled[i] < 1.0) { small[n_small++] = i; }
+		else { large[n_large++] = i; }
+	}
+
+	while (n_small && n_large) {
+		s = small[--n_small];
+		l = large[--n_large];
+
+		tab->prob[s] = (uint64_t) (scaled[s] * ALIAS_ONE);
+		tab->alias[s] = l;
+
+		scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+		if (scaled[l] < 1.0) { small[n_small++] = l; }
+		else { large[n_large++] = l; }
+	}
+
+	/* Leftovers are 1.0 up to rounding errors */
+	while (n_large) {
+		l = large[--n_large];
+		tab->prob[l] = ALIAS_ONE;
+		tab->alias[l] = l;
+	}
+	while (n_small) {
+		s = small[--n_small];
+		tab->prob[s] = ALIAS_ONE;
+		tab->alias[s] = s;
+	}
+
+	free(small);
+	free(large);
+	free(scaled);
+	return 0;
+
+	handle_error:
+		free(small);
+		free(large);
+		free(scaled);
+		prng_alias_free(tab);
+		return -1;
+}
+
+void prng_alias_free(struct prng_alias *tab)
+{
+	if (!tab) { return; }
+
+	free(tab->prob);
+	free(tab->alias);
+	memset(tab, 0, sizeof(struct prng_alias));
+
+	return;
+}
+
+static uint64_t splitmix64(uint64_t *x)
+{
+	uint64_t z;
+
+	*x += 0x9e3779b97f4a7c15ULL;
+	z = *x;
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+
+	return z ^ (z >> 31);
+}
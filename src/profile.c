@@ -0,0 +1,449 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "fill_ipv4.h"
+#include "prefix_list.h"
+#include "prefix_table.h"
+#include "sort.h"
+#include "stats.h"
+#include "status.h"
+#include "profile.h"
+
+#define PROFILE_BLOCK		(4 << 20)		/* Bytes parsed in one round */
+#define PROFILE_THREADS_MAX	64
+#define TOKEN_MAX			32				/* Longer tokens are not prefixes */
+
+/**
+ * @struct parse_task
+ * @brief Lines parsed by one thread, and what it found in them.
+ */
+struct parse_task {
+    const char *begin;              /**< First byte */
+    const char *end;                /**< Past the last byte, after a '\n' */
+    uint64_t *keys;                 /**< Prefixes as (network << 8 | bitmask) */
+    size_t len;                     /**< Keys of this round */
+    size_t cap;                     /**< Allocated keys */
+    uint64_t lengths[PREFIX_LENGTHS]; /**< Entries per mask length */
+    uint64_t host_bits;             /**< Entries with host bits set */
+    uint64_t covered;               /**< Sum of prefix sizes */
+    int error;                      /**< Invalid entry or no memory */
+    char bad[TOKEN_MAX + 1];        /**< Invalid entry */
+    pthread_t tid;                  /**< Thread */
+};
+
+/**
+ * @struct profile
+ * @brief Totals of a prefix table.
+ */
+struct profile {
+    uint64_t entries;               /**< Entries read */
+    uint64_t lengths[PREFIX_LENGTHS]; /**< Entries per mask length */
+    uint64_t host_bits;             /**< Entries with host bits set */
+    uint64_t covered;               /**< Sum of prefix sizes */
+    uint64_t unique;                /**< Distinct prefixes */
+    uint64_t unique_covered;        /**< Addresses in the union */
+    uint64_t depths[PREFIX_LENGTHS]; /**< Unique prefixes per nesting depth */
+    int max_depth;                  /**< Deepest nesting */
+    uint64_t *keys;                 /**< Prefixes of every round */
+    size_t len;                     /**< Number of keys */
+    size_t cap;                     /**< Allocated keys */
+};
+
+/**
+ * @brief Parse the lines of a task.
+ * @param arg struct parse_task.
+ * @return NULL.
+ */
+static void *parse_range(void *arg);
+
+/**
+ * @brief Read a stream block by block, parsing each on several threads.
+ * @param prof Totals to add to.
+ * @param fp Source stream.
+ * @param tasks Per-thread state.
+ * @param threads Number of threads.
+ * @return 0 on success, -1 on error.
+ */
+static int profile_stream(struct profile *prof, FILE *fp, struct parse_task *tasks,
+						  unsigned threads);
+
+/**
+ * @brief Parse one block of whole lines and collect the results.
+ * @param prof Totals to add to.
+ * @param buf Block.
+ * @param len Bytes in the block.
+ * @param tasks Per-thread state.
+ * @param threads Number of threads.
+ * @return 0 on success, -1 on error.
+ */
+static int profile_block(struct profile *prof, const char *buf, size_t len,
+						 struct parse_task *tasks, unsigned threads);
+
+/**
+ * @brief Sort the prefixes, then count duplicates, union and nesting.
+ * @param prof Totals.
+ * @return 0 on success, -1 on error.
+ */
+static int profile_nesting(struct profile *prof);
+
+/**
+ * @brief Print the totals as a table.
+ * @param prof Totals.
+ */
+static void print_table(const struct profile *prof);
+
+/**
+ * @brief Print the totals as one JSON object.
+ * @param prof Totals.
+ */
+static void print_json(const struct profile *prof);
+
+int profile_start(int argc, char **argv)
+{
+	struct profile prof;
+	struct parse_task *tasks = NULL;
+	char *endptr = NULL;
+	long threads;
+	int json = 0;
+	int file_cnt = 0;
+	FILE *fp = NULL;
+	int res;
+	STATS_DECL(t);
+
+	threads = sysconf(_SC_NPROCESSORS_ONLN);
+
+	for (int i = 0; i < argc; i++) {
+		if (strcmp(argv[i], "--json") == 0) { json = 1; }
+		else if (strcmp(argv[i], "--threads") == 0) {
+			if (i + 1 >= argc) { return EXIT_FAILURE; }
+			errno = 0;
+			threads = strtol(argv[++i], &endptr, 10);
+			if (errno == ERANGE || *endptr != '\0' || threads < 1) { return EXIT_FAILURE; }
+		}
+		else if (strncmp(argv[i], "--", 2) == 0) { return EXIT_FAILURE; }
+	}
+	if (threads < 1) { threads = 1; }
+	if (threads > PROFILE_THREADS_MAX) { threads = PROFILE_THREADS_MAX; }
+
+	memset(&prof, 0, sizeof(struct profile));
+
+	tasks = calloc(threads, sizeof(struct parse_task));
+	if (!tasks) { return EXIT_INPUT; }
+
+	for (int i = 0; i < argc; i++) {
+		if (strcmp(argv[i], "--threads") == 0) { i++; continue; }
+		if (strncmp(argv[i], "--", 2) == 0) { continue; }
+
+		file_cnt++;
+		fp = fopen(argv[i], "r");
+		if (!fp) {
+			fprintf(stderr, "ipc: %s: %s\n", argv[i], strerror(errno));
+			goto handle_error;
+		}
+		res = profile_stream(&prof, fp, tasks, (unsigned) threads);
+		fclose(fp);
+		if (res == -1) { goto handle_error; }
+	}
+
+	if (!file_cnt && profile_stream(&prof, stdin, tasks, (unsigned) threads) == -1) {
+		goto handle_error;
+	}
+	STATS_LAP(t, stage_parse);
+
+	/* Per-thread counts run over every round */
+	for (long i = 0; i < threads; i++) {
+		for (int l = 0; l < PREFIX_LENGTHS; l++) { prof.lengths[l] += tasks[i].lengths[l]; }
+		prof.host_bits += tasks[i].host_bits;
+		prof.covered += tasks[i].covered;
+	}
+
+	if (profile_nesting(&prof) == -1) { goto handle_error; }
+	STATS_LAP(t, stage_derive);
+	STATS_ITEMS(prof.entries);
+
+	if (json) { print_json(&prof); }
+	else { print_table(&prof); }
+	STATS_LAP(t, stage_output);
+
+	for (long i = 0; i < threads; i++) { free(tasks[i].keys); }
+	free(tasks);
+	free(prof.keys);
+	return EXIT_SUCCESS;
+
+	handle_error:
+		for (long i = 0; i < threads; i++) { free(tasks[i].keys); }
+		free(tasks);
+		free(prof.keys);
+		return EXIT_INPUT;
+}
+
+static int profile_stream(struct profile *prof, FILE *fp, struct parse_task *tasks,
+						  unsigned threads)
+{
+	char *buf = NULL;
+	size_t len = 0;
+	size_t got, cut;
+	int eof = 0;
+
+	buf = malloc(PROFILE_BLOCK);
+	if (!buf) { return -1; }
+
+	while (!eof) {
+		got = fread(buf + len, 1, PROFILE_BLOCK - len, fp);
+		len += got;
+		if (len < PROFILE_BLOCK) {
+			if (ferror(fp)) {
+				fprintf(stderr, "ipc: %s\n", strerror(errno));
+				goto handle_error;
+			}
+			eof = 1;
+		}
+
+		/* Whole lines only, the rest waits for the next round */
+		cut = len;
+		if (!eof) {
+			while (cut && buf[cut - 1] != '\n') { cut--; }
+			if (!cut) {
+				fputs("ipc: line too long\n", stderr);
+				goto handle_error;
+			}
+		}
+
+		if (profile_block(prof, buf, cut, tasks, threads) == -1) { goto handle_error; }
+
+		memmove(buf, buf + cut, len - cut);
+		len -= cut;
+	}
+
+	free(buf);
+	return 0;
+
+	handle_error:
+		free(buf);
+		return -1;
+}
+
+static int profile_block(struct profile *prof, const char *buf, size_t len,
+						 struct parse_task *tasks, unsigned threads)
+{
+	const char *p = buf;
+	const char *end = buf + len;
+	uint64_t *keys = NULL;
+	size_t total = 0;
+	unsigned started = 0;
+	int error = 0;
+
+	/* Equal shares, each moved forward to the next line */
+	for (unsigned i = 0; i < threads; i++) {
+		tasks[i].begin = p;
+		p = (i + 1 == threads) ? end : buf + len / threads * (i + 1);
+		if (p < tasks[i].begin) { p = tasks[i].begin; }
+		while (p > buf && p < end && p[-1] != '\n') { p++; }
+		tasks[i].end = p;
+		tasks[i].len = 0;
+	}
+
+	for (; started < threads; started++) {
+		if (started + 1 == threads) { break; }
+		if (pthread_create(&tasks[started].tid, NULL, parse_range, &tasks[started]) != 0) {
+			break;
+		}
+	}
+
+	/* The calling thread parses the last share, and any that did not start */
+	for (unsigned i = started; i < threads; i++) { parse_range(&tasks[i]); }
+	for (unsigned i = 0; i < started; i++) { pthread_join(tasks[i].tid, NULL); }
+
+	for (unsigned i = 0; i < threads; i++) {
+		if (tasks[i].error) {
+			if (tasks[i].bad[0]) { fprintf(stderr, "ipc: invalid entry '%s'\n", tasks[i].bad); }
+			error = 1;
+		}
+		total += tasks[i].len;
+	}
+	if (error) { return -1; }
+
+	if (prof->len + total > prof->cap) {
+		prof->cap = (prof->len + total) * 2;
+		keys = realloc(prof->keys, prof->cap * sizeof(uint64_t));
+		if (!keys) { return -1; }
+		prof->keys = keys;
+	}
+
+	for (unsigned i = 0; i < threads; i++) {
+		memcpy(prof->keys + prof->len, tasks[i].keys, tasks[i].len * sizeof(uint64_t));
+		prof->len += tasks[i].len;
+	}
+
+	return 0;
+}
+
+static void *parse_range(void *arg)
+{
+	struct parse_task *task = arg;
+	const char *p = task->begin;
+	const char *end = task->end;
+	const char *start = NULL;
+	char tok[TOKEN_MAX + 1];
+	struct prefix pfx;
+	uint64_t *keys = NULL;
+	uint32_t network;
+	size_t n;
+
+	while (p < end) {
+		if (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') {
+			p++;
+			continue;
+		}
+		if (*p == '#') {
+			while (p < end && *p != '\n') { p++; }
+			continue;
+		}
+
+		start = p;
+		while (p < end && *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r' && *p != '#') {
+			p++;
+		}
+
+		n = p - start;
+		if (n > TOKEN_MAX) { n = TOKEN_MAX; }
+		memcpy(tok, start, n);
+		tok[n] = '\0';
+
+		if (n == TOKEN_MAX || parse_prefix(tok, &pfx) == -1) {
+			memcpy(task->bad, tok, n + 1);
+			task->error = 1;
+			return NULL;
+		}
+
+		if (task->len == task->cap) {
+			task->cap = task->cap ? task->cap * 2 : 4096;
+			keys = realloc(task->keys, task->cap * sizeof(uint64_t));
+			if (!keys) {
+				task->error = 1;
+				return NULL;
+			}
+			task->keys = keys;
+		}
+
+		network = pfx.addr & prefix_netmask(pfx.bitmask);
+		task->keys[task->len++] = (uint64_t) network << 8 | pfx.bitmask;
+		task->lengths[pfx.bitmask]++;
+		task->host_bits += network != pfx.addr;
+		task->covered += prefix_size(pfx.bitmask);
+	}
+
+	return NULL;
+}
+
+static int profile_nesting(struct profile *prof)
+{
+	/* Last addresses of the prefixes holding the current one */
+	uint64_t stack[PREFIX_LENGTHS];
+	uint64_t prev = UINT64_MAX;
+	uint64_t first, size;
+	int depth = 0;
+
+	prof->entries = prof->len;
+
+	/* Same address: shorter mask, the holder, first */
+	if (sort_u64(prof->keys, prof->len) == -1) { return -1; }
+
+	for (size_t i = 0; i < prof->len; i++) {
+		if (prof->keys[i] == prev) { continue; }
+		prev = prof->keys[i];
+		prof->unique++;
+
+		first = prev >> 8;
+		size = prefix_size((uint8_t) (prev & 0xFF));
+
+		while (depth && stack[depth - 1] < first) { depth--; }
+
+		prof->depths[depth]++;
+		if (depth > prof->max_depth) { prof->max_depth = depth; }
+		if (!depth) { prof->unique_covered += size; }
+
+		stack[depth++] = first + size - 1;
+	}
+
+	return 0;
+}
+
+static void print_table(const struct profile *prof)
+{
+	const double space = 4294967296.0;
+
+	printf("%-15s%" PRIu64 "\n", "Entries", prof->entries);
+	printf("%-15s%" PRIu64 "\n", "Unique", prof->unique);
+	printf("%-15s%" PRIu64 "\n", "Duplicates", prof->entries - prof->unique);
+	printf("%-15s%" PRIu64 "\n", "Host bits set", prof->host_bits);
+	printf("%-15s%" PRIu64 " (with overlaps)\n", "Covered", prof->covered);
+	printf("%-15s%" PRIu64 " (%.2f%% of IPv4)\n", "Unique covered", prof->unique_covered,
+		   prof->unique_covered / space * 100);
+	printf("%-15s%d\n", "Max depth", prof->max_depth);
+
+	printf("\n%-15s%-15s%s\n", "LENGTH", "ENTRIES", "SHARE");
+	for (int l = 0; l < PREFIX_LENGTHS; l++) {
+		if (!prof->lengths[l]) { continue; }
+		printf("/%-14d%-15" PRIu64 "%.2f%%\n", l, prof->lengths[l],
+			   (double) prof->lengths[l] / prof->entries * 100);
+	}
+
+	printf("\n%-15s%-15s%s\n", "DEPTH", "PREFIXES", "SHARE");
+	for (int d = 0; d <= prof->max_depth && prof->unique; d++) {
+		printf("%-15d%-15" PRIu64 "%.2f%%\n", d, prof->depths[d],
+			   (double) prof->depths[d] / prof->unique * 100);
+	}
+
+	return;
+}
+
+static void print_json(const struct profile *prof)
+{
+	int first = 1;
+
+	printf("{\"entries\": %" PRIu64 ", \"unique\": %" PRIu64 ", \"duplicates\": %" PRIu64
+		   ", \"host_bits\": %" PRIu64 ", \"covered\": %" PRIu64 ", \"unique_covered\": %" PRIu64
+		   ", \"max_depth\": %d, \"lengths\": {",
+		   prof->entries, prof->unique, prof->entries - prof->unique, prof->host_bits,
+		   prof->covered, prof->unique_covered, prof->max_depth);
+
+	for (int l = 0; l < PREFIX_LENGTHS; l++) {
+		if (!prof->lengths[l]) { continue; }
+		printf("%s\"%d\": %" PRIu64, first ? "" : ", ", l, prof->lengths[l]);
+		first = 0;
+	}
+
+	printf("}, \"depths\": [");
+	for (int d = 0; d <= prof->max_depth && prof->unique; d++) {
+		printf("%s%" PRIu64, d ? ", " : "", prof->depths[d]);
+	}
+	printf("]}\n");
+
+	return;
+}
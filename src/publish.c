@@ -0,0 +1,322 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <unistd.h>
+
+#include "prefix_list.h"
+#include "prefix_table.h"
+#include "shm_table.h"
+#include "format.h"
+#include "stats.h"
+#include "status.h"
+#include "publish.h"
+
+#define LOOKUP_READ			65536	/* Bytes taken by one read */
+#define LOOKUP_BATCH		4096	/* Addresses parsed before answering */
+#define TOKEN_MAX			32		/* Longer tokens are not addresses */
+
+/**
+ * @brief Publish the prefixes of files as the next generation.
+ * @param name Table name.
+ * @param argc Number of files.
+ * @param argv Files, stdin if none.
+ * @return EXIT_SUCCESS on success, EXIT_INPUT on error (reported).
+ */
+static int publish(const char *name, int argc, char **argv);
+
+/**
+ * @brief Look up every address of a stream.
+ *
+ * Each read is answered and flushed at once, after a refresh, so a
+ * reader on a pipe gets its answers and follows new generations
+ * without waiting for more input.
+ *
+ * @param st Table, refreshed before every read.
+ * @param fp Addresses, whitespace separated.
+ * @param ob Output.
+ * @return 0 on success, -1 on error.
+ */
+static int lookup_stream(struct shm_table *st, FILE *fp, struct outbuf *ob);
+
+/**
+ * @brief Look up the addresses of complete lines.
+ * @param st Table.
+ * @param text Lines, '#' starts a comment.
+ * @param len Bytes of text.
+ * @param ob Output.
+ * @return 0 on success, -1 on an invalid entry.
+ */
+static int lookup_text(const struct shm_table *st, const char *text, size_t len,
+                       struct outbuf *ob);
+
+/**
+ * @brief Whitespace test of the token reader.
+ * @param c Character.
+ * @return 1 for a separator, 0 otherwise.
+ */
+static int is_space(char c);
+
+/**
+ * @brief Open every file of a list.
+ * @param argc Number of files.
+ * @param argv Files.
+ * @param[out] fps argc streams, stdin if argc is 0.
+ * @return Number of streams, or -1 on error.
+ */
+static int open_files(int argc, char **argv, FILE **fps);
+
+int publish_start(int argc, char **argv)
+{
+	struct shm_table st;
+	struct outbuf *ob = NULL;
+	FILE **fps = NULL;
+	int n = 0;
+	int res = EXIT_INPUT;
+
+	if (argc < 2) { return EXIT_FAILURE; }
+
+	if (strcmp(argv[0], "publish") == 0) { return publish(argv[1], argc - 2, argv + 2); }
+
+	if (strcmp(argv[0], "remove") == 0) {
+		if (argc != 2) { return EXIT_FAILURE; }
+		if (shm_table_remove(argv[1]) == -1) {
+			fprintf(stderr, "ipc: %s: %s\n", argv[1], strerror(errno));
+			return EXIT_INPUT;
+		}
+		return EXIT_SUCCESS;
+	}
+
+	if (strcmp(argv[0], "lookup") != 0) { return EXIT_FAILURE; }
+
+	if (shm_table_attach(&st, argv[1]) == -1) {
+		fprintf(stderr, "ipc: %s: %s\n", argv[1], strerror(errno));
+		return EXIT_INPUT;
+	}
+
+	fps = calloc(argc, sizeof(FILE *));
+	ob = malloc(sizeof(struct outbuf));
+	if (!fps || !ob) { goto cleanup; }
+	outbuf_init(ob, stdout);
+
+	n = open_files(argc - 2, argv + 2, fps);
+	if (n == -1) { goto cleanup; }
+
+	for (int i = 0; i < n; i++) {
+		if (lookup_stream(&st, fps[i], ob) == -1) { goto cleanup; }
+	}
+
+	if (outbuf_flush(ob) == 0) { res = EXIT_SUCCESS; }
+
+	cleanup:
+		for (int i = 0; i < n; i++) {
+			if (fps[i] != stdin) { fclose(fps[i]); }
+		}
+		free(fps);
+		free(ob);
+		shm_table_detach(&st);
+		return res;
+}
+
+static int publish(const char *name, int argc, char **argv)
+{
+	struct prefix *items = NULL;
+	FILE **fps = NULL;
+	size_t len = 0, total;
+	uint64_t gen;
+	int n = 0;
+	int res = EXIT_INPUT;
+	STATS_DECL(t);
+
+	fps = calloc(argc ? argc : 1, sizeof(FILE *));
+	if (!fps) { return EXIT_INPUT; }
+
+	n = open_files(argc, argv, fps);
+	if (n == -1) { goto cleanup; }
+
+	if (prefix_table_collect(fps, n, &items, &len) == -1) {
+		fputs("ipc: invalid prefix table\n", stderr);
+		goto cleanup;
+	}
+	STATS_LAP(t, stage_parse);
+	STATS_ITEMS(len);
+
+	total = len;
+	if (shm_table_publish(name, items, &len, &gen) == -1) {
+		fprintf(stderr, "ipc: %s: %s\n", name, strerror(errno));
+		goto cleanup;
+	}
+	STATS_LAP(t, stage_build);
+
+	fprintf(stderr, "ipc: %s: generation %" PRIu64 ", %zu prefixes (%zu duplicates)\n",
+			name, gen, len, total - len);
+	res = EXIT_SUCCESS;
+
+	cleanup:
+		for (int i = 0; i < n; i++) {
+			if (fps[i] != stdin) { fclose(fps[i]); }
+		}
+		free(fps);
+		free(items);
+		return res;
+}
+
+static int lookup_stream(struct shm_table *st, FILE *fp, struct outbuf *ob)
+{
+	char *buf = NULL;
+	char *new_buf = NULL;
+	size_t cap = LOOKUP_READ;
+	size_t len = 0, done;
+	ssize_t got;
+	int eof = 0;
+
+	buf = malloc(cap);
+	if (!buf) { return -1; }
+
+	while (!eof) {
+		/* A single line fills the whole buffer */
+		if (len == cap) {
+			new_buf = realloc(buf, cap * 2);
+			if (!new_buf) { goto handle_error; }
+			buf = new_buf;
+			cap *= 2;
+		}
+
+		got = read(fileno(fp), buf + len, cap - len);
+		if (got == -1 && errno == EINTR) { continue; }
+		if (got == -1) {
+			fprintf(stderr, "ipc: %s\n", strerror(errno));
+			goto handle_error;
+		}
+		if (got == 0) { eof = 1; }
+		len += got;
+
+		/* Whole lines only, the rest waits for the next read */
+		done = len;
+		if (!eof) {
+			while (done && buf[done - 1] != '\n') { done--; }
+			if (!done) { continue; }
+		}
+
+		/* A failed switch keeps answering from the generation mapped */
+		shm_table_refresh(st);
+
+		if (lookup_text(st, buf, done, ob) == -1) { goto handle_error; }
+		if (outbuf_flush(ob) == -1) { goto handle_error; }
+
+		memmove(buf, buf + done, len - done);
+		len -= done;
+	}
+
+	free(buf);
+	return 0;
+
+	handle_error:
+		free(buf);
+		return -1;
+}
+
+static int lookup_text(const struct shm_table *st, const char *text, size_t len,
+                       struct outbuf *ob)
+{
+	uint32_t addrs[LOOKUP_BATCH];
+	const char *end = text + len;
+	const char *start = NULL;
+	char tok[TOKEN_MAX + 1];
+	struct prefix pfx;
+	char *dst = NULL;
+	char *p = NULL;
+	size_t n = 0, tlen;
+
+	while (text < end || n) {
+		/* Parse a batch, then answer it */
+		while (text < end && n < LOOKUP_BATCH) {
+			if (*text == '#') {
+				text = memchr(text, '\n', end - text);
+				if (!text) { text = end; }
+				continue;
+			}
+			if (is_space(*text)) {
+				text++;
+				continue;
+			}
+
+			start = text;
+			while (text < end && *text != '#' && !is_space(*text)) { text++; }
+
+			tlen = text - start < TOKEN_MAX ? (size_t) (text - start) : TOKEN_MAX;
+			memcpy(tok, start, tlen);
+			tok[tlen] = '\0';
+
+			if (text - start > TOKEN_MAX || parse_prefix(tok, &pfx) == -1 ||
+				pfx.bitmask != BITS_IN_IP) {
+				fprintf(stderr, "ipc: invalid entry '%s'\n", tok);
+				return -1;
+			}
+			addrs[n++] = pfx.addr;
+		}
+		STATS_ITEMS(n);
+
+		for (size_t i = 0; i < n; i++) {
+			dst = outbuf_reserve(ob, 2 * ADDR_STR_LEN + 5);
+			p = format_addr_plain(dst, addrs[i]);
+			*p++ = ' ';
+			if (shm_table_lookup(st, addrs[i], &pfx)) {
+				p = format_addr_plain(p, pfx.addr);
+				p += sprintf(p, "/%d", pfx.bitmask);
+			}
+			else {
+				memcpy(p, "none", 4);
+				p += 4;
+			}
+			*p++ = '\n';
+			ob->len += p - dst;
+		}
+		n = 0;
+	}
+
+	return 0;
+}
+
+static int open_files(int argc, char **argv, FILE **fps)
+{
+	if (!argc) {
+		fps[0] = stdin;
+		return 1;
+	}
+
+	for (int i = 0; i < argc; i++) {
+		fps[i] = fopen(argv[i], "r");
+		if (!fps[i]) {
+			fprintf(stderr, "ipc: %s: %s\n", argv[i], strerror(errno));
+			while (i--) { fclose(fps[i]); }
+			return -1;
+		}
+	}
+
+	return argc;
+}
+
+static int is_space(char c)
+{ return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f'; }
@@ -0,0 +1,234 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+
+#include "prefix_list.h"
+#include "prefix_table.h"
+#include "prefix_index.h"
+#include "format.h"
+#include "stats.h"
+#include "status.h"
+#include "query.h"
+
+/**
+ * @brief Answer one query.
+ * @param ix Index.
+ * @param op "inside" or "containing".
+ * @param arg Prefix.
+ * @param ob Output.
+ * @return 0 on success, -1 if the query is invalid.
+ */
+static int answer(const struct prefix_index *ix, const char *op, const char *arg,
+				  struct outbuf *ob);
+
+/**
+ * @brief Answer every query line of a stream.
+ * @param ix Index.
+ * @param fp Queries.
+ * @param ob Output.
+ * @return Number of invalid lines.
+ */
+static uint64_t answer_stream(const struct prefix_index *ix, FILE *fp, struct outbuf *ob);
+
+/**
+ * @brief Append a prefix line.
+ * @param ob Output.
+ * @param pfx Prefix.
+ */
+static void put_prefix(struct outbuf *ob, const struct prefix *pfx);
+
+int query_start(int argc, char **argv)
+{
+	struct prefix_index ix;
+	struct outbuf *ob = NULL;
+	FILE **fps = NULL;
+	FILE *fp = NULL;
+	size_t n = 0;
+	int queries = 0;
+	uint64_t errors = 0;
+	int status = EXIT_FAILURE;
+	int res;
+	STATS_DECL(t);
+
+	memset(&ix, 0, sizeof(struct prefix_index));
+
+	/* Tables first, options take the next argument */
+	fps = calloc(argc ? argc : 1, sizeof(FILE *));
+	if (!fps) { return EXIT_INPUT; }
+
+	for (int i = 0; i < argc; i++) {
+		if (strcmp(argv[i], "--inside") == 0 || strcmp(argv[i], "--containing") == 0
+			|| strcmp(argv[i], "--queries") == 0) {
+			if (i + 1 >= argc) { goto handle_error; }
+			queries++;
+			i++;
+			continue;
+		}
+		if (strncmp(argv[i], "--", 2) == 0) { goto handle_error; }
+
+		fps[n] = fopen(argv[i], "r");
+		if (!fps[n]) {
+			fprintf(stderr, "ipc: %s: %s\n", argv[i], strerror(errno));
+			status = EXIT_INPUT;
+			goto handle_error;
+		}
+		n++;
+	}
+	if (!n) { goto handle_error; }
+
+	/* The arguments are fine, what fails from here on is the input */
+	status = EXIT_INPUT;
+
+	res = prefix_index_read(&ix, fps, n);
+	if (res == -1) {
+		fputs("ipc: invalid prefix table\n", stderr);
+		goto handle_error;
+	}
+	STATS_LAP(t, stage_build);
+
+	ob = malloc(sizeof(struct outbuf));
+	if (!ob) { goto handle_error; }
+	outbuf_init(ob, stdout);
+
+	for (int i = 0; i < argc; i++) {
+		if (strcmp(argv[i], "--inside") == 0 || strcmp(argv[i], "--containing") == 0) {
+			if (answer(&ix, argv[i] + 2, argv[i + 1], ob) == -1) {
+				fprintf(stderr, "ipc: invalid prefix '%s'\n", argv[i + 1]);
+				errors++;
+			}
+			i++;
+		}
+		else if (strcmp(argv[i], "--queries") == 0) {
+			i++;
+			if (strcmp(argv[i], "-") == 0) {
+				errors += answer_stream(&ix, stdin, ob);
+				continue;
+			}
+
+			fp = fopen(argv[i], "r");
+			if (!fp) {
+				fprintf(stderr, "ipc: %s: %s\n", argv[i], strerror(errno));
+				goto handle_error;
+			}
+			errors += answer_stream(&ix, fp, ob);
+			fclose(fp);
+		}
+	}
+
+	if (!queries) { errors += answer_stream(&ix, stdin, ob); }
+	STATS_LAP(t, stage_output);
+
+	if (outbuf_flush(ob) == -1) { goto handle_error; }
+
+	free(ob);
+	for (size_t i = 0; i < n; i++) { fclose(fps[i]); }
+	free(fps);
+	prefix_index_free(&ix);
+	return errors ? EXIT_INPUT : EXIT_SUCCESS;
+
+	handle_error:
+		free(ob);
+		for (size_t i = 0; i < n; i++) { fclose(fps[i]); }
+		free(fps);
+		prefix_index_free(&ix);
+		return status;
+}
+
+static uint64_t answer_stream(const struct prefix_index *ix, FILE *fp, struct outbuf *ob)
+{
+	char *line = NULL;
+	char *op = NULL;
+	char *arg = NULL;
+	char *save = NULL;
+	size_t cap = 0;
+	uint64_t lineno = 0, errors = 0;
+
+	while (getline(&line, &cap, fp) != -1) {
+		lineno++;
+
+		/* Comments and blank lines are skipped */
+		line[strcspn(line, "#")] = '\0';
+		op = strtok_r(line, " \t\r\n", &save);
+		if (!op) { continue; }
+		arg = strtok_r(NULL, " \t\r\n", &save);
+
+		if (!arg || strtok_r(NULL, " \t\r\n", &save) || answer(ix, op, arg, ob) == -1) {
+			fprintf(stderr, "ipc: line %" PRIu64 ": invalid query\n", lineno);
+			STATS_ERRORS(1);
+			errors++;
+		}
+	}
+
+	free(line);
+
+	return errors;
+}
+
+static int answer(const struct prefix_index *ix, const char *op, const char *arg,
+				  struct outbuf *ob)
+{
+	uint32_t found[PREFIX_LENGTHS];
+	struct prefix pfx;
+	size_t first, count;
+	int len;
+	char *dst = NULL;
+
+	if (parse_prefix(arg, &pfx) == -1) { return -1; }
+
+	if (strcmp(op, "inside") == 0) {
+		count = prefix_index_inside(ix, pfx.addr, pfx.bitmask, &first);
+	}
+	else if (strcmp(op, "containing") == 0) {
+		count = prefix_index_containing(ix, pfx.addr, pfx.bitmask, found);
+	}
+	else { return -1; }
+
+	dst = outbuf_reserve(ob, 64);
+	len = snprintf(dst, 64, "%s %s %zu\n", op, arg, count);
+	ob->len += len < 64 ? len : 63;
+
+	for (size_t i = 0; i < count; i++) {
+		prefix_index_get(ix, op[0] == 'i' ? first + i : found[i], &pfx);
+		put_prefix(ob, &pfx);
+	}
+	STATS_ITEMS(1);
+
+	return 0;
+}
+
+static void put_prefix(struct outbuf *ob, const struct prefix *pfx)
+{
+	char *dst = outbuf_reserve(ob, ADDR_STR_LEN + 5);
+	char *p = format_addr_plain(dst, pfx->addr);
+
+	*p++ = '/';
+	if (pfx->bitmask >= 10) { *p++ = '0' + pfx->bitmask / 10; }
+	*p++ = '0' + pfx->bitmask % 10;
+	*p++ = '\n';
+
+	ob->len += p - dst;
+
+	return;
+}
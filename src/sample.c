@@ -0,0 +1,400 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "prefix_list.h"
+#include "interval_set.h"
+#include "format.h"
+#include "prng.h"
+#include "status.h"
+#include "sample.h"
+
+#define SAMPLE_BATCH		1024
+
+/**
+ * @struct sample_opts
+ * @brief Options of the sampling mode.
+ */
+struct sample_opts {
+    uint64_t count;                 /**< Addresses to draw */
+    uint64_t seed;                  /**< Generator seed */
+    uint8_t weighted;               /**< Draw prefixes by weight */
+    uint8_t binary;                 /**< Binary output */
+};
+
+/**
+ * @struct uniform_table
+ * @brief Union of the prefixes with running address counts.
+ */
+struct uniform_table {
+    struct interval_set set;        /**< Disjoint blocks */
+    uint64_t *ends;                 /**< Addresses in blocks 0..i */
+    uint64_t total;                 /**< Addresses in the union */
+};
+
+/**
+ * @struct alias_table
+ * @brief Weighted prefixes.
+ */
+struct alias_table {
+    struct prefix *items;           /**< Prefixes */
+    double *weights;                /**< Prefix weights */
+    struct prng_alias pick;         /**< Alias table over the weights */
+    size_t len;                     /**< Number of prefixes */
+    size_t cap;                     /**< Allocated prefixes */
+};
+
+/**
+ * @brief Parse the options of the sampling mode.
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ * @param[out] opts Parsed options.
+ * @return 0 on success, -1 on error.
+ */
+static int process_sample_args(int argc, char **argv, struct sample_opts *opts);
+
+/**
+ * @brief Read prefixes of the uniform mode and build running counts.
+ * @param fp Source stream.
+ * @param tab Table to append to.
+ * @return 0 on success, -1 on error.
+ */
+static int read_uniform(FILE *fp, struct uniform_table *tab);
+
+/**
+ * @brief Read prefixes and their weights.
+ * @param fp Source stream.
+ * @param tab Table to append to.
+ * @return 0 on success, -1 on error.
+ */
+static int read_weighted(FILE *fp, struct alias_table *tab);
+
+/**
+ * @brief Draw addresses uniformly from the union.
+ * @param tab Table.
+ * @param rng Generator.
+ * @param out Destination array.
+ * @param n Addresses to draw.
+ */
+static void draw_uniform(const struct uniform_table *tab, struct prng *rng,
+                         uint32_t *out, size_t n);
+
+/**
+ * @brief Draw addresses from prefixes picked by weight.
+ * @param tab Table.
+ * @param rng Generator.
+ * @param out Destination array.
+ * @param n Addresses to draw.
+ */
+static void draw_weighted(const struct alias_table *tab, struct prng *rng,
+                          uint32_t *out, size_t n);
+
+/**
+ * @brief Write a batch of addresses.
+ * @param ob Output buffer.
+ * @param addrs Addresses.
+ * @param n Number of addresses.
+ * @param binary Write 4-byte big-endian values instead of text lines.
+ */
+static void write_batch(struct outbuf *ob, const uint32_t *addrs, size_t n,
+                        uint8_t binary);
+
+int sample_start(int argc, char **argv)
+{
+	struct sample_opts opts;
+	struct uniform_table uni;
+	struct alias_table ali;
+	struct prng rng;
+	struct outbuf *ob = NULL;
+	uint32_t batch[SAMPLE_BATCH];
+	uint64_t left;
+	size_t n;
+	int file_cnt = 0;
+	FILE *fp = NULL;
+	int res;
+
+	memset(&uni, 0, sizeof(struct uniform_table));
+	memset(&ali, 0, sizeof(struct alias_table));
+
+	if (process_sample_args(argc, argv, &opts) == -1) { return EXIT_FAILURE; }
+
+	/* Files follow the options */
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--seed") == 0) { i++; continue; }
+		if (strncmp(argv[i], "--", 2) == 0) { continue; }
+
+		file_cnt++;
+		fp = fopen(argv[i], "r");
+		if (!fp) {
+			fprintf(stderr, "ipc: %s: %s\n", argv[i], strerror(errno));
+			goto handle_error;
+		}
+		res = opts.weighted ? read_weighted(fp, &ali) : read_uniform(fp, &uni);
+		fclose(fp);
+		if (res == -1) { goto handle_error; }
+	}
+
+	if (!file_cnt) {
+		res = opts.weighted ? read_weighted(stdin, &ali) : read_uniform(stdin, &uni);
+		if (res == -1) { goto handle_error; }
+	}
+
+	if (opts.weighted) {
+		if (!ali.len) {
+			fputs("ipc: no addresses to draw from\n", stderr);
+			goto handle_error;
+		}
+		if (prng_alias_init(&ali.pick, ali.weights, ali.len) == -1) { goto handle_error; }
+	}
+	else {
+		if (interval_set_sort(&uni.set) == -1) { goto handle_error; }
+		uni.total = interval_set_merge(&uni.set);
+		if (!uni.total) {
+			fputs("ipc: no addresses to draw from\n", stderr);
+			goto handle_error;
+		}
+
+		uni.ends = malloc(uni.set.len * sizeof(uint64_t));
+		if (!uni.ends) { goto handle_error; }
+		left = 0;
+		for (size_t i = 0; i < uni.set.len; i++) {
+			left += (uint64_t) (uint32_t) uni.set.keys[i] - (uni.set.keys[i] >> 32) + 1;
+			uni.ends[i] = left;
+		}
+	}
+
+	ob = malloc(sizeof(struct outbuf));
+	if (!ob) { goto handle_error; }
+	outbuf_init(ob, stdout);
+
+	prng_seed(&rng, opts.seed);
+
+	for (left = opts.count; left; left -= n) {
+		n = left < SAMPLE_BATCH ? left : SAMPLE_BATCH;
+
+		if (opts.weighted) { draw_weighted(&ali, &rng, batch, n); }
+		else { draw_uniform(&uni, &rng, batch, n); }
+
+		write_batch(ob, batch, n, opts.binary);
+		if (ob->error) { break; }
+	}
+
+	res = outbuf_flush(ob);
+
+	free(ob);
+	interval_set_free(&uni.set);
+	free(uni.ends);
+	free(ali.items);
+	free(ali.weights);
+	prng_alias_free(&ali.pick);
+
+	return res == -1 ? EXIT_INPUT : EXIT_SUCCESS;
+
+	handle_error:
+		free(ob);
+		interval_set_free(&uni.set);
+		free(uni.ends);
+		free(ali.items);
+		free(ali.weights);
+		prng_alias_free(&ali.pick);
+		return EXIT_INPUT;
+}
+
+static int process_sample_args(int argc, char **argv, struct sample_opts *opts)
+{
+	unsigned long long val;
+	char *endptr = NULL;
+	uint8_t seed_set = 0;
+
+	if (!argv || !opts || argc < 1) { return -1; }
+
+	memset(opts, 0, sizeof(struct sample_opts));
+
+	/* strtoull accepts a sign, the count must not have one */
+	if (argv[0][0] < '0' || argv[0][0] > '9') { return -1; }
+	errno = 0;
+	val = strtoull(argv[0], &endptr, 10);
+	if (errno == ERANGE || *endptr != '\0' || val == 0) { return -1; }
+	opts->count = val;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--weighted") == 0) { opts->weighted = 1; }
+		else if (strcmp(argv[i], "--binary") == 0) { opts->binary = 1; }
+		else if (strcmp(argv[i], "--seed") == 0) {
+			if (i + 1 >= argc) { return -1; }
+			errno = 0;
+			val = strtoull(argv[++i], &endptr, 0);
+			if (errno == ERANGE || *endptr != '\0') { return -1; }
+			opts->seed = val;
+			seed_set = 1;
+		}
+		else if (strncmp(argv[i], "--", 2) == 0) { return -1; }
+	}
+
+	if (!seed_set) { opts->seed = prng_entropy(); }
+
+	return 0;
+}
+
+static int read_uniform(FILE *fp, struct uniform_table *tab)
+{
+	char bad[INTERVAL_SET_ENTRY_MAX];
+	int res;
+
+	if (!fp || !tab) { return -1; }
+
+	res = interval_set_read(&tab->set, fp, bad, sizeof(bad));
+	if (res == INTERVAL_SET_INVALID) { fprintf(stderr, "ipc: invalid entry '%s'\n", bad); }
+	else if (res == INTERVAL_SET_DAMAGED) { fputs("ipc: damaged compiled prefix set\n", stderr); }
+
+	return res == 0 ? 0 : -1;
+}
+
+static int read_weighted(FILE *fp, struct alias_table *tab)
+{
+	struct token_reader rd;
+	struct prefix *new_items = NULL;
+	double *new_weights = NULL;
+	double weight;
+	char *endptr = NULL;
+	char *tok = NULL;
+	size_t new_cap;
+
+	if (!fp || !tab) { return -1; }
+
+	if (token_reader_init(&rd, fp) == -1) { return -1; }
+
+	while ((tok = token_reader_next(&rd))) {
+		/* Addresses have three dots, a weight has at most one */
+		if (!strchr(tok, '/') && strchr(tok, '.') == strrchr(tok, '.')) {
+			if (!tab->len) { goto handle_invalid; }
+			errno = 0;
+			weight = strtod(tok, &endptr);
+			if (errno == ERANGE || *endptr != '\0' || !(weight > 0)) {
+				goto handle_invalid;
+			}
+			tab->weights[tab->len - 1] = weight;
+			continue;
+		}
+
+		if (tab->len == tab->cap) {
+			new_cap = tab->cap ? tab->cap * 2 : 1024;
+			new_items = realloc(tab->items, new_cap * sizeof(struct prefix));
+			if (!new_items) { goto handle_error; }
+			tab->items = new_items;
+			new_weights = realloc(tab->weights, new_cap * sizeof(double));
+			if (!new_weights) { goto handle_error; }
+			tab->weights = new_weights;
+			tab->cap = new_cap;
+		}
+
+		if (parse_prefix(tok, &tab->items[tab->len]) == -1) { goto handle_invalid; }
+		tab->items[tab->len].addr &= prefix_netmask(tab->items[tab->len].bitmask);
+		tab->weights[tab->len] = 1.0;
+		tab->len++;
+	}
+
+	token_reader_free(&rd);
+	return 0;
+
+	handle_invalid:
+		fprintf(stderr, "ipc: invalid entry '%s'\n", tok);
+	handle_error:
+		token_reader_free(&rd);
+		return -1;
+}
+
+static void draw_uniform(const struct uniform_table *tab, struct prng *rng,
+                         uint32_t *out, size_t n)
+{
+	uint64_t r;
+	size_t lo, hi, mid;
+
+	for (size_t i = 0; i < n; i++) {
+		r = prng_bounded(rng, tab->total);
+
+		/* First block whose running count exceeds r */
+		lo = 0;
+		hi = tab->set.len - 1;
+		while (lo < hi) {
+			mid = lo + (hi - lo) / 2;
+			if (tab->ends[mid] > r) { hi = mid; }
+			else { lo = mid + 1; }
+		}
+
+		if (lo) { r -= tab->ends[lo - 1]; }
+		out[i] = (uint32_t) (tab->set.keys[lo] >> 32) + (uint32_t) r;
+	}
+
+	return;
+}
+
+static void draw_weighted(const struct alias_table *tab, struct prng *rng,
+                          uint32_t *out, size_t n)
+{
+	uint64_t r;
+	size_t idx;
+	const struct prefix *pfx = NULL;
+
+	for (size_t i = 0; i < n; i++) {
+		idx = prng_bounded(rng, tab->len);
+		r = prng_next(rng);
+
+		/* Low half decides the column, high half gives the host bits */
+		idx = prng_alias_pick(&tab->pick, idx, (uint32_t) r);
+
+		pfx = &tab->items[idx];
+		out[i] = pfx->addr | ((uint32_t) (r >> 32) & ~prefix_netmask(pfx->bitmask));
+	}
+
+	return;
+}
+
+static void write_batch(struct outbuf *ob, const uint32_t *addrs, size_t n,
+                        uint8_t binary)
+{
+	char *dst = NULL;
+
+	if (binary) {
+		dst = outbuf_reserve(ob, n * 4);
+		for (size_t i = 0; i < n; i++) {
+			dst[0] = addrs[i] >> 24;
+			dst[1] = addrs[i] >> 16;
+			dst[2] = addrs[i] >> 8;
+			dst[3] = addrs[i];
+			dst += 4;
+		}
+		ob->len += n * 4;
+		return;
+	}
+
+	for (size_t i = 0; i < n; i++) {
+		dst = outbuf_reserve(ob, ADDR_STR_LEN + 1);
+		dst = format_addr_plain(dst, addrs[i]);
+		*dst++ = '\n';
+		ob->len = dst - ob->data;
+	}
+
+	return;
+}
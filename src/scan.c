@@ -0,0 +1,242 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "scan.h"
+
+#define SCAN_BLOCK			64				/* Bytes classified at once */
+#define ADDR_MIN_LEN		7				/* "0.0.0.0" */
+
+/**
+ * @brief Classify a block of bytes.
+ * @param p SCAN_BLOCK bytes.
+ * @param[out] nl Bit i set if p[i] is '\n'.
+ * @return Bit i set if p[i] is a digit or a dot.
+ */
+static inline uint64_t classify(const char *p, uint64_t *nl);
+
+/**
+ * @brief Check a run and report it if it is an address.
+ * @param s Run.
+ * @param n Bytes of the run.
+ * @param offset Offset of the run in the text.
+ * @param line Line of the run.
+ * @param emit Receiver.
+ * @param ctx Passed to emit.
+ */
+static void check_run(const char *s, size_t n, uint64_t offset, uint64_t line,
+					  scan_emit_fn emit, void *ctx);
+
+void scan_init(struct scan_state *st)
+{
+	if (!st) { return; }
+
+	memset(st, 0, sizeof(struct scan_state));
+	st->line = 1;
+
+	return;
+}
+
+void scan_feed(struct scan_state *st, const char *buf, size_t len,
+			   scan_emit_fn emit, void *ctx)
+{
+	char tail[SCAN_BLOCK];
+	uint64_t run, nl, valid, before, longer, ends, below, gaps;
+	uint64_t line, run_line;
+	/* Bytes of the run open at the current block, saturated */
+	size_t open, n, end;
+	/* Start of the open run in buf, negative if it began in an earlier piece */
+	ptrdiff_t start;
+	int k, s;
+
+	if (!st || !buf || !emit) { return; }
+
+	line = st->line;
+	run_line = st->run_line;
+	open = st->run_len;
+	start = -(ptrdiff_t) st->run_len;
+
+	for (size_t i = 0; i < len; i += SCAN_BLOCK) {
+		n = len - i < SCAN_BLOCK ? len - i : SCAN_BLOCK;
+		valid = n == SCAN_BLOCK ? UINT64_MAX : ((uint64_t) 1 << n) - 1;
+		if (n == SCAN_BLOCK) { run = classify(buf + i, &nl); }
+		else {
+			/* Zeros are neither digits nor dots */
+			memset(tail, 0, SCAN_BLOCK);
+			memcpy(tail, buf + i, n);
+			run = classify(tail, &nl);
+		}
+
+		/* Bit k of longer: bytes k - 6 to k are all in a run */
+		before = open >= SCAN_BLOCK ? UINT64_MAX : open ? UINT64_MAX << (SCAN_BLOCK - open) : 0;
+		longer = run;
+		for (int j = 1; j < ADDR_MIN_LEN; j++) {
+			longer &= run << j | before >> (SCAN_BLOCK - j);
+		}
+
+		/* Bit k: a run of at least ADDR_MIN_LEN bytes ended at k - 1 */
+		ends = ~run & (run << 1 | (open != 0)) & valid;
+		ends &= longer << 1 | (open >= ADDR_MIN_LEN);
+
+		for (; ends; ends &= ends - 1) {
+			k = __builtin_ctzll(ends);
+			below = ((uint64_t) 1 << k) - 1;
+			gaps = ~run & below;
+			end = i + k;
+
+			/* Begun in this block, or right at its start */
+			if (gaps || !open) {
+				s = gaps ? SCAN_BLOCK - __builtin_clzll(gaps) : 0;
+				check_run(buf + i + s, k - s, st->offset + i + s,
+						  line + __builtin_popcountll(nl & (((uint64_t) 1 << s) - 1)), emit, ctx);
+			}
+			else if (start >= 0) {
+				check_run(buf + start, end - start, st->offset + start, run_line, emit, ctx);
+			}
+			else if (st->run_len + end <= SCAN_RUN_MAX) {
+				/* Joined with the part kept from earlier pieces */
+				memcpy(st->run_buf + st->run_len, buf, end);
+				check_run(st->run_buf, st->run_len + end, st->offset - st->run_len, run_line,
+						  emit, ctx);
+			}
+		}
+
+		/* Track the run reaching the end of the block */
+		if (run >> (n - 1) & 1) {
+			gaps = ~run & valid;
+			if (gaps || !open) {
+				s = gaps ? SCAN_BLOCK - __builtin_clzll(gaps) : 0;
+				start = (ptrdiff_t) (i + s);
+				run_line = line + __builtin_popcountll(nl & (((uint64_t) 1 << s) - 1));
+				open = n - s;
+			}
+			else { open = open + n > SCAN_RUN_MAX ? SCAN_RUN_MAX + 1 : open + n; }
+		}
+		else { open = 0; }
+
+		line += __builtin_popcountll(nl & valid);
+	}
+
+	/* Keep an open run for the next piece */
+	if (open && open <= SCAN_RUN_MAX) {
+		if (start >= 0) { memcpy(st->run_buf, buf + start, open); }
+		else { memcpy(st->run_buf + st->run_len, buf, len); }
+	}
+
+	st->offset += len;
+	st->line = line;
+	st->run_line = run_line;
+	st->run_len = open;
+
+	return;
+}
+
+void scan_finish(struct scan_state *st, scan_emit_fn emit, void *ctx)
+{
+	if (!st || !emit) { return; }
+
+	if (st->run_len && st->run_len <= SCAN_RUN_MAX) {
+		check_run(st->run_buf, st->run_len, st->offset - st->run_len, st->run_line, emit, ctx);
+	}
+
+	st->run_len = 0;
+
+	return;
+}
+
+static inline uint64_t classify(const char *p, uint64_t *nl)
+{
+	uint64_t run = 0;
+	uint64_t lines = 0;
+
+#ifdef __SSE2__
+	const __m128i zero = _mm_set1_epi8('0');
+	const __m128i nine = _mm_set1_epi8(9);
+	const __m128i dot = _mm_set1_epi8('.');
+	const __m128i newline = _mm_set1_epi8('\n');
+	__m128i v, d, hit;
+
+	for (int j = 0; j < SCAN_BLOCK / 16; j++) {
+		v = _mm_loadu_si128((const __m128i *) (p + 16 * j));
+
+		/* c - '0' <= 9 as unsigned bytes: min leaves it unchanged */
+		d = _mm_sub_epi8(v, zero);
+		hit = _mm_or_si128(_mm_cmpeq_epi8(_mm_min_epu8(d, nine), d), _mm_cmpeq_epi8(v, dot));
+
+		run |= (uint64_t) (uint16_t) _mm_movemask_epi8(hit) << (16 * j);
+		lines |= (uint64_t) (uint16_t) _mm_movemask_epi8(_mm_cmpeq_epi8(v, newline)) << (16 * j);
+	}
+#else
+	for (int j = 0; j < SCAN_BLOCK; j++) {
+		run |= (uint64_t) ((uint8_t) (p[j] - '0') <= 9 || p[j] == '.') << j;
+		lines |= (uint64_t) (p[j] == '\n') << j;
+	}
+#endif
+
+	*nl = lines;
+
+	return run;
+}
+
+static void check_run(const char *s, size_t n, uint64_t offset, uint64_t line,
+					  scan_emit_fn emit, void *ctx)
+{
+	uint32_t addr = 0, octet = 0;
+	int dots = 0, digits = 0;
+
+	if (n > SCAN_RUN_MAX) { return; }
+
+	/* Sentence dots around an address are not part of it */
+	while (n && *s == '.') {
+		s++;
+		n--;
+		offset++;
+	}
+	while (n && s[n - 1] == '.') { n--; }
+
+	if (n < ADDR_MIN_LEN) { return; }
+
+	/* The octet rules of fill_addr */
+	for (size_t i = 0; i < n; i++) {
+		if (s[i] == '.') {
+			if (!digits || ++dots > 3) { return; }
+			addr = addr << 8 | octet;
+			octet = 0;
+			digits = 0;
+			continue;
+		}
+
+		octet = octet * 10 + (s[i] - '0');
+		if (octet > 255) { return; }
+		digits = 1;
+	}
+
+	if (dots != 3 || !digits) { return; }
+
+	emit(ctx, addr << 8 | octet, offset, line);
+
+	return;
+}
@@ -0,0 +1,811 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define _GNU_SOURCE						/* accept4 */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "ipv4_t.h"
+#include "prefix_list.h"
+#include "prefix_table.h"
+#include "prefix_file.h"
+#include "shm_table.h"
+#include "format.h"
+#include "target.h"
+#include "ipc.h"
+#include "stats.h"
+#include "status.h"
+#include "server.h"
+
+#define SERVE_LINE_MAX		4096			/* Longest request */
+#define SERVE_ARGS_MAX		64				/* Most words in a request */
+#define SERVE_SPLIT_MAX		65536			/* Most subnets in one response */
+#define SERVE_READ_SIZE		65536			/* Bytes taken by one read */
+#define SERVE_OUT_HIGH		(1 << 22)		/* Unsent bytes that pause reading */
+#define SERVE_EVENTS		64
+
+/**
+ * @struct buffer
+ * @brief Growable byte buffer.
+ */
+struct buffer {
+    char *data;                     /**< Bytes */
+    size_t len;                     /**< Bytes used */
+    size_t cap;                     /**< Bytes allocated */
+    size_t pos;                     /**< Bytes already consumed */
+};
+
+/**
+ * @struct conn
+ * @brief Client connection.
+ */
+struct conn {
+    int fd;                         /**< Socket */
+    uint32_t events;                /**< Events registered with epoll */
+    int eof;                        /**< Peer will send nothing more */
+    struct buffer in;               /**< Received bytes, answered up to pos */
+    struct buffer out;              /**< Responses not yet sent */
+};
+
+/**
+ * @struct server
+ * @brief Listening socket and the state shared by all requests.
+ */
+struct server {
+    int epfd;                       /**< epoll instance */
+    int lfd;                        /**< Listening socket */
+    int spare;                      /**< Reserved descriptor, given up to
+                                         refuse a connection when none is
+                                         left, or -1 */
+    struct prefix_table table;      /**< Preloaded prefixes for lookup */
+    struct prefix_file file;        /**< Compiled table the lookups read
+                                         in place, unmapped if none */
+    struct shm_table shm;           /**< Shared table followed across
+                                         generations, detached if none */
+};
+
+static volatile sig_atomic_t stop_requested = 0;
+
+/* Returned by the answer_* functions when the response can not grow */
+static const char no_memory[] = "no memory";
+
+/**
+ * @brief Load the prefix tables named by --table options.
+ *
+ * A single compiled table with a lookup section is mapped and queried
+ * in place instead of being decoded, as is a shared table (--shm).
+ *
+ * @param argc Argument count.
+ * @param argv Argument vector, the socket path first.
+ * @param[out] srv Server whose table to fill.
+ * @return 0 on success, -1 on an invalid option, -2 on a table that
+ *         can not be loaded (reported).
+ */
+static int load_tables(int argc, char **argv, struct server *srv);
+
+/**
+ * @brief Create the listening socket.
+ *
+ * A stale socket file left by a killed server is replaced. A socket a
+ * server still answers on is EADDRINUSE, any other file at the path is
+ * an error.
+ *
+ * @param path Socket path.
+ * @return Socket, or -1 on error.
+ */
+static int open_listener(const char *path);
+
+/**
+ * @brief Accept every pending connection.
+ *
+ * Out of descriptors, the spare one is closed to accept and drop the
+ * pending connection; left queued, it would wake epoll forever.
+ *
+ * @param srv Server.
+ */
+static void accept_conns(struct server *srv);
+
+/**
+ * @brief Read once.
+ * @param c Connection.
+ * @return 0 on success, -1 if the connection must be closed.
+ */
+static int conn_read(struct conn *c);
+
+/**
+ * @brief Answer complete requests until too much output is pending.
+ *
+ * The check runs after every request, so one read holding many large
+ * responses does not queue them all.
+ *
+ * @param srv Server.
+ * @param c Connection.
+ * @return 0 if every complete request is answered, 1 if some wait for
+ *         the output to drain, -1 if the connection must be closed.
+ */
+static int conn_answer(struct server *srv, struct conn *c);
+
+/**
+ * @brief Answer and send until the socket is full or nothing is left.
+ * @param srv Server.
+ * @param c Connection.
+ * @return 0 on success, -1 if the connection must be closed.
+ */
+static int conn_serve(struct server *srv, struct conn *c);
+
+/**
+ * @brief Send as much of the pending output as the socket takes.
+ * @param c Connection.
+ * @return 0 on success, -1 if the connection must be closed.
+ */
+static int conn_write(struct conn *c);
+
+/**
+ * @brief Register the events the connection is waiting for.
+ *
+ * Reading pauses while too much output is pending.
+ *
+ * @param srv Server.
+ * @param c Connection.
+ * @return 0 on success, -1 if the connection is done.
+ */
+static int conn_update(struct server *srv, struct conn *c);
+
+/**
+ * @brief Close a connection and free it.
+ * @param srv Server.
+ * @param c Connection.
+ */
+static void conn_close(struct server *srv, struct conn *c);
+
+/**
+ * @brief Answer one request.
+ * @param srv Server.
+ * @param line Request without the line terminator. Modified.
+ * @param out Response buffer.
+ * @return 0 on success (including failed requests), -1 on no memory.
+ */
+static int handle_request(struct server *srv, char *line, struct buffer *out);
+
+/**
+ * @brief Append the analysis report.
+ * @param argc Word count after the verb.
+ * @param argv Words after the verb.
+ * @param out Response buffer.
+ * @return Error text for the client, NULL on success.
+ */
+static const char *answer_analyze(int argc, char **argv, struct buffer *out);
+
+/**
+ * @brief Append the subnet table.
+ * @param argc Word count after the verb.
+ * @param argv Words after the verb.
+ * @param out Response buffer.
+ * @return Error text for the client, NULL on success.
+ */
+static const char *answer_split(int argc, char **argv, struct buffer *out);
+
+/**
+ * @brief Append the longest matching prefix.
+ * @param tab Preloaded prefixes.
+ * @param argc Word count after the verb.
+ * @param argv Words after the verb.
+ * @param out Response buffer.
+ * @return Error text for the client, NULL on success.
+ */
+static const char *answer_lookup(const struct prefix_table *tab, int argc, char **argv,
+                                 struct buffer *out);
+
+/**
+ * @brief Append the number of addresses of target expressions.
+ * @param argc Word count after the verb.
+ * @param argv Words after the verb.
+ * @param out Response buffer.
+ * @return Error text for the client, NULL on success.
+ */
+static const char *answer_count(int argc, char **argv, struct buffer *out);
+
+/**
+ * @brief Make room at the end of a buffer.
+ * @param buf Buffer.
+ * @param n Bytes needed.
+ * @return Pointer to the free space, or NULL on no memory.
+ */
+static char *buf_reserve(struct buffer *buf, size_t n);
+
+/**
+ * @brief Append bytes to a buffer.
+ * @param buf Buffer.
+ * @param data Bytes.
+ * @param n Number of bytes.
+ * @return 0 on success, -1 on no memory.
+ */
+static int buf_append(struct buffer *buf, const char *data, size_t n);
+
+/**
+ * @brief Signal handler, asks the event loop to stop.
+ * @param sig Signal number.
+ */
+static void handle_stop(int sig);
+
+int server_start(int argc, char **argv)
+{
+	struct epoll_event events[SERVE_EVENTS];
+	struct epoll_event ev;
+	struct sigaction sa;
+	struct server srv;
+	struct conn *c = NULL;
+	int n;
+
+	memset(&srv, 0, sizeof(struct server));
+	srv.epfd = -1;
+	srv.lfd = -1;
+	srv.spare = -1;
+
+	if (argc < 1) { return EXIT_FAILURE; }
+	if (strlen(argv[0]) >= sizeof(((struct sockaddr_un *) 0)->sun_path)) { return EXIT_FAILURE; }
+
+	/* Tables are loaded before the socket appears, so no request sees them empty */
+	n = load_tables(argc, argv, &srv);
+	if (n != 0) { return n == -1 ? EXIT_FAILURE : EXIT_INPUT; }
+
+	memset(&sa, 0, sizeof(struct sigaction));
+	sa.sa_handler = handle_stop;
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+	signal(SIGPIPE, SIG_IGN);
+
+	srv.lfd = open_listener(argv[0]);
+	if (srv.lfd == -1) { goto handle_error; }
+
+	srv.epfd = epoll_create1(EPOLL_CLOEXEC);
+	if (srv.epfd == -1) { goto handle_error; }
+
+	srv.spare = open("/dev/null", O_RDONLY | O_CLOEXEC);
+	if (srv.spare == -1) { goto handle_error; }
+
+	ev.events = EPOLLIN;
+	ev.data.ptr = NULL;
+	if (epoll_ctl(srv.epfd, EPOLL_CTL_ADD, srv.lfd, &ev) == -1) { goto handle_error; }
+
+	fprintf(stderr, "ipc: serving on %s, %zu prefixes loaded\n",
+			argv[0], prefix_table_size(&srv.table));
+
+	while (!stop_requested) {
+		n = epoll_wait(srv.epfd, events, SERVE_EVENTS, -1);
+		if (n == -1 && errno == EINTR) { continue; }
+		if (n == -1) { goto handle_error; }
+
+		for (int i = 0; i < n; i++) {
+			c = events[i].data.ptr;
+
+			if (!c) {
+				accept_conns(&srv);
+				continue;
+			}
+
+			if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+				if (conn_read(c) == -1) {
+					conn_close(&srv, c);
+					continue;
+				}
+			}
+
+			if (conn_serve(&srv, c) == -1 || conn_update(&srv, c) == -1) {
+				conn_close(&srv, c);
+			}
+		}
+	}
+
+	/* Open connections are dropped, the OS closes them on exit */
+	close(srv.epfd);
+	close(srv.lfd);
+	close(srv.spare);
+	unlink(argv[0]);
+	prefix_table_free(&srv.table);
+	prefix_file_close(&srv.file);
+	shm_table_detach(&srv.shm);
+
+	return EXIT_SUCCESS;
+
+	handle_error:
+		fprintf(stderr, "ipc: %s: %s\n", argv[0], strerror(errno));
+		if (srv.epfd != -1) { close(srv.epfd); }
+		if (srv.spare != -1) { close(srv.spare); }
+		if (srv.lfd != -1) {
+			close(srv.lfd);
+			unlink(argv[0]);
+		}
+		prefix_table_free(&srv.table);
+		prefix_file_close(&srv.file);
+		shm_table_detach(&srv.shm);
+		return EXIT_INPUT;
+}
+
+static int load_tables(int argc, char **argv, struct server *srv)
+{
+	FILE **fps = NULL;
+	size_t n = 0;
+	int res = -1;
+
+	fps = calloc(argc, sizeof(FILE *));
+	if (!fps) { return -2; }
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--shm") == 0 && i + 1 < argc && argc == 3) {
+			if (shm_table_attach(&srv->shm, argv[++i]) == -1) {
+				fprintf(stderr, "ipc: %s: %s\n", argv[i], strerror(errno));
+				res = -2;
+				goto cleanup;
+			}
+			srv->table = srv->shm.file.table;
+			res = 0;
+			goto cleanup;
+		}
+		if (strcmp(argv[i], "--table") != 0 || i + 1 >= argc) { goto cleanup; }
+
+		fps[n] = fopen(argv[++i], "r");
+		if (!fps[n]) {
+			fprintf(stderr, "ipc: %s: %s\n", argv[i], strerror(errno));
+			res = -2;
+			goto cleanup;
+		}
+		n++;
+	}
+
+	if (n == 1 && prefix_file_sniff(fps[0])) {
+		if (prefix_file_map(&srv->file, fileno(fps[0])) == 0 && srv->file.table.keys) {
+			srv->table = srv->file.table;
+			res = 0;
+			goto cleanup;
+		}
+		prefix_file_close(&srv->file);
+	}
+
+	res = prefix_table_read(&srv->table, fps, n);
+	if (res == -1) {
+		fputs("ipc: invalid prefix table\n", stderr);
+		res = -2;
+	}
+
+	cleanup:
+		for (size_t i = 0; i < n; i++) { fclose(fps[i]); }
+		free(fps);
+		return res;
+}
+
+static int open_listener(const char *path)
+{
+	struct sockaddr_un addr;
+	struct stat st;
+	int fd, res;
+
+	memset(&addr, 0, sizeof(struct sockaddr_un));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, path);
+
+	if (stat(path, &st) == 0) {
+		if (!S_ISSOCK(st.st_mode)) {
+			errno = EEXIST;
+			return -1;
+		}
+
+		/* Only a socket nobody listens on is stale */
+		fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		if (fd == -1) { return -1; }
+		res = connect(fd, (struct sockaddr *) &addr, sizeof(struct sockaddr_un));
+		if (res == -1 && errno != ECONNREFUSED) {
+			close(fd);
+			return -1;
+		}
+		close(fd);
+		if (res == 0) {
+			errno = EADDRINUSE;
+			return -1;
+		}
+		unlink(path);
+	}
+
+	fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (fd == -1) { return -1; }
+
+	if (bind(fd, (struct sockaddr *) &addr, sizeof(struct sockaddr_un)) == -1 ||
+		listen(fd, SOMAXCONN) == -1) {
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+static void accept_conns(struct server *srv)
+{
+	struct epoll_event ev;
+	struct conn *c = NULL;
+	int fd;
+
+	for (;;) {
+		fd = accept4(srv->lfd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd == -1 && errno == EINTR) { continue; }
+		if (fd == -1 && (errno == EMFILE || errno == ENFILE) && srv->spare != -1) {
+			close(srv->spare);
+			fd = accept(srv->lfd, NULL, NULL);
+			if (fd != -1) { close(fd); }
+			srv->spare = open("/dev/null", O_RDONLY | O_CLOEXEC);
+			if (fd == -1) { break; }
+			continue;
+		}
+		if (fd == -1) { break; }
+
+		c = calloc(1, sizeof(struct conn));
+		if (!c) {
+			close(fd);
+			continue;
+		}
+
+		c->fd = fd;
+		c->events = EPOLLIN;
+
+		ev.events = c->events;
+		ev.data.ptr = c;
+		if (epoll_ctl(srv->epfd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+			close(fd);
+			free(c);
+		}
+	}
+
+	return;
+}
+
+static int conn_read(struct conn *c)
+{
+	char *buf = NULL;
+	ssize_t got;
+
+	/* Requests not answered yet move to the front */
+	c->in.len -= c->in.pos;
+	memmove(c->in.data, c->in.data + c->in.pos, c->in.len);
+	c->in.pos = 0;
+
+	buf = buf_reserve(&c->in, SERVE_READ_SIZE);
+	if (!buf) { return -1; }
+
+	got = read(c->fd, buf, SERVE_READ_SIZE);
+	if (got == -1) { return (errno == EAGAIN || errno == EINTR) ? 0 : -1; }
+	if (got == 0) {
+		c->eof = 1;
+		return 0;
+	}
+	c->in.len += got;
+
+	return 0;
+}
+
+static int conn_answer(struct server *srv, struct conn *c)
+{
+	char *line = c->in.data + c->in.pos;
+	char *end = c->in.data + c->in.len;
+	char *nl = NULL;
+
+	while ((nl = memchr(line, '\n', end - line))) {
+		if (c->out.len - c->out.pos >= SERVE_OUT_HIGH) {
+			c->in.pos = line - c->in.data;
+			return 1;
+		}
+
+		*nl = '\0';
+		if (nl - line >= SERVE_LINE_MAX) { return -1; }
+		if (handle_request(srv, line, &c->out) == -1) { return -1; }
+		line = nl + 1;
+	}
+
+	c->in.pos = line - c->in.data;
+	if (end - line >= SERVE_LINE_MAX) { return -1; }
+
+	return 0;
+}
+
+static int conn_serve(struct server *srv, struct conn *c)
+{
+	int res;
+
+	/* A drained socket takes the requests left waiting at once */
+	do {
+		res = conn_answer(srv, c);
+		if (res == -1 || conn_write(c) == -1) { return -1; }
+	} while (res == 1 && !c->out.len);
+
+	return 0;
+}
+
+static int conn_write(struct conn *c)
+{
+	ssize_t sent;
+
+	while (c->out.pos < c->out.len) {
+		sent = send(c->fd, c->out.data + c->out.pos, c->out.len - c->out.pos, MSG_NOSIGNAL);
+		if (sent == -1 && errno == EINTR) { continue; }
+		if (sent == -1 && errno == EAGAIN) { return 0; }
+		if (sent == -1) { return -1; }
+		c->out.pos += sent;
+	}
+
+	c->out.len = 0;
+	c->out.pos = 0;
+
+	return 0;
+}
+
+static int conn_update(struct server *srv, struct conn *c)
+{
+	struct epoll_event ev;
+	size_t pending = c->out.len - c->out.pos;
+	uint32_t events = 0;
+
+	if (c->eof && !pending) { return -1; }
+
+	if (!c->eof && pending < SERVE_OUT_HIGH) { events |= EPOLLIN; }
+	if (pending) { events |= EPOLLOUT; }
+
+	if (events == c->events) { return 0; }
+
+	ev.events = events;
+	ev.data.ptr = c;
+	if (epoll_ctl(srv->epfd, EPOLL_CTL_MOD, c->fd, &ev) == -1) { return -1; }
+	c->events = events;
+
+	return 0;
+}
+
+static void conn_close(struct server *srv, struct conn *c)
+{
+	epoll_ctl(srv->epfd, EPOLL_CTL_DEL, c->fd, NULL);
+	close(c->fd);
+	free(c->in.data);
+	free(c->out.data);
+	free(c);
+
+	return;
+}
+
+static int handle_request(struct server *srv, char *line, struct buffer *out)
+{
+	char *args[SERVE_ARGS_MAX];
+	const char *err = NULL;
+	char *save = NULL;
+	char *word = NULL;
+	size_t mark = out->len;
+	int argc = 0;
+	STATS_DECL(t);
+
+	word = strtok_r(line, " \t\r", &save);
+	while (word && argc < SERVE_ARGS_MAX) {
+		args[argc++] = word;
+		word = strtok_r(NULL, " \t\r", &save);
+	}
+
+	/* Blank lines get no response */
+	if (!argc) { return 0; }
+
+	if (word) { err = "too many words"; }
+	else if (strcmp(args[0], "analyze") == 0 || strcmp(args[0], "-a") == 0) {
+		err = answer_analyze(argc - 1, args + 1, out);
+	}
+	else if (strcmp(args[0], "split") == 0 || strcmp(args[0], "-s") == 0) {
+		err = answer_split(argc - 1, args + 1, out);
+	}
+	else if (strcmp(args[0], "lookup") == 0) {
+		/* A new shared generation is taken between requests */
+		if (srv->shm.hdr && shm_table_refresh(&srv->shm) == 1) { srv->table = srv->shm.file.table; }
+		err = answer_lookup(&srv->table, argc - 1, args + 1, out);
+	}
+	else if (strcmp(args[0], "count") == 0 || strcmp(args[0], "-t") == 0) {
+		err = answer_count(argc - 1, args + 1, out);
+	}
+	else if (strcmp(args[0], "ping") == 0) {
+		err = buf_append(out, "pong\n", 5) == -1 ? no_memory : NULL;
+	}
+	else { err = "unknown verb"; }
+
+	if (err == no_memory) { return -1; }
+
+	STATS_ITEMS(1);
+	STATS_LATENCY(hist_serve, t);
+
+	if (err) {
+		STATS_ERRORS(1);
+
+		/* Drop a partial response */
+		out->len = mark;
+		if (buf_append(out, "error: ", 7) == -1) { return -1; }
+		if (buf_append(out, err, strlen(err)) == -1) { return -1; }
+		if (buf_append(out, "\n", 1) == -1) { return -1; }
+	}
+
+	return buf_append(out, "\n", 1);
+}
+
+static const char *answer_analyze(int argc, char **argv, struct buffer *out)
+{
+	ipv4_t ip;
+	char *dst = NULL;
+	int len;
+
+	if (argc != 1) { return "usage: analyze <ip/bitmask>"; }
+
+	if (ipc_analyze(&ip, argv[0]) == -1) { return "invalid address"; }
+
+	dst = buf_reserve(out, IPC_REPORT_MAX);
+	if (!dst) { return no_memory; }
+
+	len = ipc_format_analysis(&ip, dst, IPC_REPORT_MAX);
+	if (len < 0) { return "invalid address"; }
+	out->len += len;
+
+	return NULL;
+}
+
+static const char *answer_split(int argc, char **argv, struct buffer *out)
+{
+	int parts[SERVE_ARGS_MAX];
+	struct ipc_split sp;
+	struct ipc_subnet sn;
+	unsigned long long count;
+	char *endptr = NULL;
+	char *dst = NULL;
+	long part;
+	int len;
+
+	if (argc < 3) { return "usage: split <ip/bitmask> <--equal|--part> <uint, ...>"; }
+
+	if (strcmp(argv[1], "--equal") == 0) {
+		if (argc != 3 || argv[2][0] < '0' || argv[2][0] > '9') { return "invalid count"; }
+		errno = 0;
+		count = strtoull(argv[2], &endptr, 10);
+		if (errno == ERANGE || *endptr != '\0' || !count) { return "invalid count"; }
+		if (count > SERVE_SPLIT_MAX) { return "too many subnets"; }
+		if (ipc_split_equal(&sp, argv[0], count) == -1) { return "split failed"; }
+	}
+	else if (strcmp(argv[1], "--part") == 0) {
+		for (int i = 2; i < argc; i++) {
+			errno = 0;
+			part = strtol(argv[i], &endptr, 10);
+			if (errno == ERANGE || *endptr != '\0' || part <= 0 || part > INT_MAX) {
+				return "invalid part";
+			}
+			parts[i - 2] = (int) part;
+		}
+		if (ipc_split_part(&sp, argv[0], parts, argc - 2) == -1) { return "split failed"; }
+	}
+	else { return "usage: split <ip/bitmask> <--equal|--part> <uint, ...>"; }
+
+	dst = buf_reserve(out, IPC_SUBNET_ROW_MAX);
+	if (!dst) { return no_memory; }
+	out->len += snprintf(dst, IPC_SUBNET_ROW_MAX, "%5s%-20s%-20s%-11s\n", "", "MIN", "MAX", "MASK");
+
+	for (uint64_t i = 0; ipc_split_next(&sp, &sn); i++) {
+		dst = buf_reserve(out, IPC_SUBNET_ROW_MAX);
+		if (!dst) { return no_memory; }
+
+		len = ipc_format_subnet(&sn, i, dst, IPC_SUBNET_ROW_MAX);
+		if (len > 0) { out->len += len; }
+	}
+
+	return NULL;
+}
+
+static const char *answer_lookup(const struct prefix_table *tab, int argc, char **argv,
+                                 struct buffer *out)
+{
+	struct prefix pfx;
+	char *dst = NULL;
+	char *p = NULL;
+
+	if (argc != 1) { return "usage: lookup <ip>"; }
+
+	if (parse_prefix(argv[0], &pfx) == -1 || pfx.bitmask != BITS_IN_IP) {
+		return "invalid address";
+	}
+
+	dst = buf_reserve(out, 24);
+	if (!dst) { return no_memory; }
+
+	if (!prefix_table_lookup(tab, pfx.addr, &pfx)) {
+		memcpy(dst, "none\n", 5);
+		out->len += 5;
+		return NULL;
+	}
+
+	p = format_addr_plain(dst, pfx.addr);
+	p += sprintf(p, "/%d\n", pfx.bitmask);
+	out->len += p - dst;
+
+	return NULL;
+}
+
+static const char *answer_count(int argc, char **argv, struct buffer *out)
+{
+	struct target_expr expr;
+	uint64_t total = 0;
+	char *dst = NULL;
+
+	if (argc < 1) { return "usage: count <expression, ...>"; }
+
+	for (int i = 0; i < argc; i++) {
+		if (target_parse(&expr, argv[i]) == -1) { return "invalid expression"; }
+		total += target_count(&expr);
+	}
+
+	dst = buf_reserve(out, 24);
+	if (!dst) { return no_memory; }
+	out->len += sprintf(dst, "%llu\n", (unsigned long long) total);
+
+	return NULL;
+}
+
+static char *buf_reserve(struct buffer *buf, size_t n)
+{
+	char *new_data = NULL;
+	size_t cap;
+
+	if (buf->cap - buf->len < n) {
+		cap = buf->cap ? buf->cap : 4096;
+		while (cap - buf->len < n) { cap *= 2; }
+
+		new_data = realloc(buf->data, cap);
+		if (!new_data) { return NULL; }
+		buf->data = new_data;
+		buf->cap = cap;
+	}
+
+	return buf->data + buf->len;
+}
+
+static int buf_append(struct buffer *buf, const char *data, size_t n)
+{
+	char *dst = buf_reserve(buf, n);
+
+	if (!dst) { return -1; }
+
+	memcpy(dst, data, n);
+	buf->len += n;
+
+	return 0;
+}
+
+static void handle_stop(int sig)
+{
+	(void) sig;
+	stop_requested = 1;
+
+	return;
+}
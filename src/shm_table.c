@@ -0,0 +1,293 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "shm_table.h"
+
+#define REFRESH_TRIES		16		/* Generations skipped while opening one */
+
+/**
+ * @brief Build a segment name.
+ * @param dst SHM_TABLE_NAME_MAX + 1 bytes.
+ * @param name Table name, with or without the leading '/'.
+ * @param generation Generation, 0 for the control segment.
+ * @return 0 on success, -1 if the name is empty, too long or has '/' inside.
+ */
+static int segment_name(char *dst, const char *name, uint64_t generation);
+
+/**
+ * @brief Map the control segment.
+ * @param fd Control segment.
+ * @param prot PROT_READ, or PROT_READ | PROT_WRITE to initialize it.
+ * @return Header, or NULL on error.
+ */
+static struct shm_table_header *map_header(int fd, int prot);
+
+int shm_table_publish(const char *name, struct prefix *items, size_t *len,
+                      uint64_t *generation)
+{
+	char ctl[SHM_TABLE_NAME_MAX + 1];
+	char data[SHM_TABLE_NAME_MAX + 1];
+	struct shm_table_header *hdr = NULL;
+	FILE *fp = NULL;
+	int fd = -1, dfd = -1;
+	int err;
+	uint64_t gen;
+
+	if (!name || !items || !len) {
+		errno = EINVAL;
+		return -1;
+	}
+	if (segment_name(ctl, name, 0) == -1) { return -1; }
+
+	fd = shm_open(ctl, O_RDWR | O_CREAT, 0644);
+	if (fd == -1) { return -1; }
+
+	/* One publisher at a time */
+	if (flock(fd, LOCK_EX) == -1) { goto handle_error; }
+
+	hdr = map_header(fd, PROT_READ | PROT_WRITE);
+	if (!hdr) { goto handle_error; }
+
+	gen = __atomic_load_n(&hdr->generation, __ATOMIC_ACQUIRE) + 1;
+	if (segment_name(data, name, gen) == -1) { goto handle_error; }
+
+	/* Not visible yet, a leftover of a failed publisher is overwritten */
+	dfd = shm_open(data, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (dfd == -1) { goto handle_error; }
+
+	fp = fdopen(dfd, "wb");
+	if (!fp) { goto handle_data_error; }
+	dfd = -1;
+
+	if (prefix_file_write(fp, items, len, 1) == -1) { goto handle_data_error; }
+	if (fclose(fp) == EOF) {
+		fp = NULL;
+		goto handle_data_error;
+	}
+	fp = NULL;
+
+	/* Readers see the new generation only now that it is complete */
+	__atomic_store_n(&hdr->generation, gen, __ATOMIC_RELEASE);
+
+	if (gen > 1 && segment_name(data, name, gen - 1) == 0) { shm_unlink(data); }
+	if (generation) { *generation = gen; }
+
+	munmap(hdr, sizeof(struct shm_table_header));
+	close(fd);
+
+	return 0;
+
+	handle_data_error:
+		err = errno;
+		if (fp) { fclose(fp); }
+		if (dfd != -1) { close(dfd); }
+		shm_unlink(data);
+		errno = err;
+	handle_error:
+		err = errno;
+		if (hdr) { munmap(hdr, sizeof(struct shm_table_header)); }
+		close(fd);
+		errno = err;
+		return -1;
+}
+
+int shm_table_remove(const char *name)
+{
+	char ctl[SHM_TABLE_NAME_MAX + 1];
+	char data[SHM_TABLE_NAME_MAX + 1];
+	struct shm_table_header *hdr = NULL;
+	uint64_t gen;
+	int fd;
+
+	if (!name || segment_name(ctl, name, 0) == -1) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	fd = shm_open(ctl, O_RDWR, 0);
+	if (fd == -1) { return -1; }
+
+	if (flock(fd, LOCK_EX) == 0) { hdr = map_header(fd, PROT_READ); }
+	if (!hdr) {
+		close(fd);
+		return -1;
+	}
+
+	gen = __atomic_load_n(&hdr->generation, __ATOMIC_ACQUIRE);
+	if (gen && segment_name(data, name, gen) == 0) { shm_unlink(data); }
+	shm_unlink(ctl);
+
+	munmap(hdr, sizeof(struct shm_table_header));
+	close(fd);
+
+	return 0;
+}
+
+int shm_table_attach(struct shm_table *st, const char *name)
+{
+	int fd, err;
+
+	if (!st || !name) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	memset(st, 0, sizeof(struct shm_table));
+
+	if (segment_name(st->name, name, 0) == -1) { return -1; }
+
+	fd = shm_open(st->name, O_RDONLY, 0);
+	if (fd == -1) { return -1; }
+
+	st->hdr = map_header(fd, PROT_READ);
+	close(fd);
+	if (!st->hdr) { return -1; }
+
+	if (shm_table_refresh(st) == -1) { goto handle_error; }
+	if (!st->generation) {
+		errno = ENOENT;
+		goto handle_error;
+	}
+
+	return 0;
+
+	handle_error:
+		err = errno;
+		shm_table_detach(st);
+		errno = err;
+		return -1;
+}
+
+int shm_table_refresh(struct shm_table *st)
+{
+	char data[SHM_TABLE_NAME_MAX + 1];
+	struct prefix_file pf;
+	uint64_t gen, next;
+	int fd = -1;
+
+	if (!st || !st->hdr) { return -1; }
+
+	gen = __atomic_load_n(&st->hdr->generation, __ATOMIC_ACQUIRE);
+	if (gen == st->generation || !gen) { return 0; }
+
+	for (int i = 0; i < REFRESH_TRIES; i++) {
+		if (segment_name(data, st->name, gen) == -1) { return -1; }
+
+		fd = shm_open(data, O_RDONLY, 0);
+		if (fd != -1) { break; }
+		if (errno != ENOENT) { return -1; }
+
+		/* Replaced between the load and the open: take the newer one */
+		next = __atomic_load_n(&st->hdr->generation, __ATOMIC_ACQUIRE);
+		if (next == gen) { return -1; }
+		gen = next;
+	}
+	if (fd == -1) { return -1; }
+
+	if (prefix_file_map(&pf, fd) == -1 || !pf.table.keys) {
+		prefix_file_close(&pf);
+		close(fd);
+		errno = EINVAL;
+		return -1;
+	}
+	close(fd);
+
+	prefix_file_close(&st->file);
+	st->file = pf;
+	st->generation = gen;
+
+	return 1;
+}
+
+void shm_table_detach(struct shm_table *st)
+{
+	if (!st) { return; }
+
+	prefix_file_close(&st->file);
+	if (st->hdr) { munmap((void *) st->hdr, sizeof(struct shm_table_header)); }
+	memset(st, 0, sizeof(struct shm_table));
+
+	return;
+}
+
+static int segment_name(char *dst, const char *name, uint64_t generation)
+{
+	int len;
+
+	if (*name == '/') { name++; }
+	if (!*name || strchr(name, '/')) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (generation) { len = snprintf(dst, SHM_TABLE_NAME_MAX + 1, "/%s.%" PRIu64, name, generation); }
+	else { len = snprintf(dst, SHM_TABLE_NAME_MAX + 1, "/%s", name); }
+
+	if (len > SHM_TABLE_NAME_MAX) {
+		errno = ENAMETOOLONG;
+		return -1;
+	}
+
+	return 0;
+}
+
+static struct shm_table_header *map_header(int fd, int prot)
+{
+	struct shm_table_header *hdr = NULL;
+	struct stat sb;
+
+	if (fstat(fd, &sb) == -1) { return NULL; }
+
+	/* A new segment is zero-filled to the header size */
+	if ((size_t) sb.st_size < sizeof(struct shm_table_header)) {
+		if (!(prot & PROT_WRITE) || ftruncate(fd, sizeof(struct shm_table_header)) == -1) {
+			errno = EINVAL;
+			return NULL;
+		}
+	}
+
+	hdr = mmap(NULL, sizeof(struct shm_table_header), prot, MAP_SHARED, fd, 0);
+	if (hdr == MAP_FAILED) { return NULL; }
+
+	if ((prot & PROT_WRITE) && hdr->magic[0] == '\0' && !hdr->generation) {
+		memcpy(hdr->magic, SHM_TABLE_MAGIC, sizeof(hdr->magic));
+		hdr->version = SHM_TABLE_VERSION;
+	}
+
+	if (memcmp(hdr->magic, SHM_TABLE_MAGIC, sizeof(hdr->magic)) != 0 ||
+		hdr->version != SHM_TABLE_VERSION) {
+		munmap(hdr, sizeof(struct shm_table_header));
+		errno = EINVAL;
+		return NULL;
+	}
+
+	return hdr;
+}
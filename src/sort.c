@@ -0,0 +1,154 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "sort.h"
+
+#define RADIX_BITS			16
+#define RADIX_SIZE			(1 << RADIX_BITS)
+#define RADIX_MASK			(RADIX_SIZE - 1)
+
+/* Below this length insertion sort beats the counting passes */
+#define SMALL_SORT_LEN		64
+
+/**
+ * @brief Insertion sort for short arrays.
+ * @param arr Keys to sort.
+ * @param len Number of keys.
+ */
+static void insertion_sort_u64(uint64_t *arr, size_t len);
+
+/**
+ * @brief Radix sort core shared by the 32 and 64 bit variants.
+ * @param arr Keys to sort.
+ * @param len Number of keys.
+ * @param passes Number of 16-bit digits in a key.
+ * @return 0 on success, -1 on error.
+ */
+static int radix_sort_u64(uint64_t *arr, size_t len, int passes);
+
+int sort_u64(uint64_t *arr, size_t len)
+{
+	if (!arr && len) { return -1; }
+
+	if (len < SMALL_SORT_LEN) {
+		insertion_sort_u64(arr, len);
+		return 0;
+	}
+
+	return radix_sort_u64(arr, len, 4);
+}
+
+int sort_u32(uint32_t *arr, size_t len)
+{
+	uint64_t *wide = NULL;
+
+	if (!arr && len) { return -1; }
+	if (len < 2) { return 0; }
+
+	wide = malloc(len * sizeof(uint64_t));
+	if (!wide) { return -1; }
+
+	for (size_t i = 0; i < len; i++) { wide[i] = arr[i]; }
+
+	if (len < SMALL_SORT_LEN) { insertion_sort_u64(wide, len); }
+	else if (radix_sort_u64(wide, len, 2) == -1) {
+		free(wide);
+		return -1;
+	}
+
+	for (size_t i = 0; i < len; i++) { arr[i] = (uint32_t) wide[i]; }
+
+	free(wide);
+	return 0;
+}
+
+static void insertion_sort_u64(uint64_t *arr, size_t len)
+{
+	uint64_t key;
+	size_t j;
+
+	for (size_t i = 1; i < len; i++) {
+		key = arr[i];
+		for (j = i; j > 0 && arr[j - 1] > key; j--) {
+			arr[j] = arr[j - 1];
+		}
+		arr[j] = key;
+	}
+
+	return;
+}
+
+static int radix_sort_u64(uint64_t *arr, size_t len, int passes)
+{
+	uint64_t *tmp = NULL;
+	uint64_t *src = arr;
+	uint64_t *dst = NULL;
+	uint64_t *swap = NULL;
+	size_t *count = NULL;
+	size_t sum, cnt;
+	int shift;
+
+	tmp = malloc(len * sizeof(uint64_t));
+	count = malloc(RADIX_SIZE * sizeof(size_t));
+	if (!tmp || !count) { goto handle_error; }
+
+	dst = tmp;
+
+	for (int pass = 0; pass < passes; pass++) {
+		shift = pass * RADIX_BITS;
+		memset(count, 0, RADIX_SIZE * sizeof(size_t));
+
+		for (size_t i = 0; i < len; i++) {
+			count[(src[i] >> shift) & RADIX_MASK]++;
+		}
+
+		/* All keys share this digit, order is already right */
+		if (count[(src[0] >> shift) & RADIX_MASK] == len) { continue; }
+
+		sum = 0;
+		for (int d = 0; d < RADIX_SIZE; d++) {
+			cnt = count[d];
+			count[d] = sum;
+			sum += cnt;
+		}
+
+		for (size_t i = 0; i < len; i++) {
+			dst[count[(src[i] >> shift) & RADIX_MASK]++] = src[i];
+		}
+
+		swap = src;
+		src = dst;
+		dst = swap;
+	}
+
+	if (src != arr) { memcpy(arr, src, len * sizeof(uint64_t)); }
+
+	free(tmp);
+	free(count);
+	return 0;
+
+	handle_error:
+		free(tmp);
+		free(count);
+		return -1;
+}
@@ -0,0 +1,176 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+
+#include "special.h"
+
+/**
+ * @brief Class shared by the addresses of a prefix below one table entry.
+ * @param level Table level, 0 for the first octet.
+ * @param block Block of the level.
+ * @param addr Network address.
+ * @param bitmask Prefix length.
+ * @return special_class, or special_mixed.
+ */
+static uint8_t prefix_class(int level, uint8_t block, uint32_t addr, uint8_t bitmask);
+
+/* Entry handing the next octet to block n of the next level */
+#define NEXT(n)				(SPECIAL_DESCEND | (n))
+
+/*
+ * The registry as tables indexed by octet. Ranges of a level that one
+ * class covers completely are set directly, the few that split further
+ * descend. Block 0 of levels 2-4 stays zero, see special_step().
+ */
+const uint8_t special_octet1[256] = {
+	[0] = special_this_network,
+	[10] = special_private,
+	[100] = NEXT(1),
+	[127] = special_loopback,
+	[169] = NEXT(2),
+	[172] = NEXT(3),
+	[192] = NEXT(4),
+	[198] = NEXT(5),
+	[203] = NEXT(6),
+	[224 ... 239] = special_multicast,
+	[240 ... 254] = special_reserved,
+	[255] = NEXT(7)
+};
+
+const uint8_t special_octet2[][256] = {
+	[1] = { [64 ... 127] = special_shared },					/* 100 */
+	[2] = { [254] = special_link_local },						/* 169 */
+	[3] = { [16 ... 31] = special_private },					/* 172 */
+	[4] = {														/* 192 */
+		[0] = NEXT(1),
+		[31] = NEXT(2),
+		[52] = NEXT(3),
+		[88] = NEXT(4),
+		[168] = special_private,
+		[175] = NEXT(5)
+	},
+	[5] = {														/* 198 */
+		[18 ... 19] = special_benchmarking,
+		[51] = NEXT(6)
+	},
+	[6] = { [0] = NEXT(7) },									/* 203 */
+	[7] = {														/* 255 */
+		[0 ... 254] = special_reserved,
+		[255] = NEXT(8)
+	}
+};
+
+const uint8_t special_octet3[][256] = {
+	[1] = {														/* 192.0 */
+		[0] = NEXT(1),
+		[2] = special_documentation
+	},
+	[2] = { [196] = special_as112 },							/* 192.31 */
+	[3] = { [193] = special_amt },								/* 192.52 */
+	[4] = { [99] = special_6to4_relay },						/* 192.88 */
+	[5] = { [48] = special_as112 },								/* 192.175 */
+	[6] = { [100] = special_documentation },					/* 198.51 */
+	[7] = { [113] = special_documentation },					/* 203.0 */
+	[8] = {														/* 255.255 */
+		[0 ... 254] = special_reserved,
+		[255] = NEXT(2)
+	}
+};
+
+const uint8_t special_octet4[][256] = {
+	[1] = {														/* 192.0.0 */
+		[0 ... 7] = special_ds_lite,
+		[8] = special_dummy,
+		[9 ... 10] = special_anycast,
+		[11 ... 169] = special_protocol,
+		[170 ... 171] = special_nat64,
+		[172 ... 255] = special_protocol
+	},
+	[2] = {														/* 255.255.255 */
+		[0 ... 254] = special_reserved,
+		[255] = special_broadcast
+	}
+};
+
+const struct special_info special_registry[SPECIAL_CLASSES] = {
+	[special_none] = { "global", NULL, 1 },
+	[special_this_network] = { "this-network", "RFC 791", 0 },
+	[special_private] = { "private", "RFC 1918", 0 },
+	[special_shared] = { "shared", "RFC 6598", 0 },
+	[special_loopback] = { "loopback", "RFC 1122", 0 },
+	[special_link_local] = { "link-local", "RFC 3927", 0 },
+	[special_protocol] = { "protocol", "RFC 6890", 0 },
+	[special_ds_lite] = { "ds-lite", "RFC 7335", 0 },
+	[special_dummy] = { "dummy", "RFC 7600", 0 },
+	[special_anycast] = { "anycast", "RFC 7723", 1 },
+	[special_nat64] = { "nat64", "RFC 7050", 0 },
+	[special_documentation] = { "documentation", "RFC 5737", 0 },
+	[special_as112] = { "as112", "RFC 7534", 1 },
+	[special_amt] = { "amt", "RFC 7450", 1 },
+	[special_6to4_relay] = { "6to4-relay", "RFC 7526", 0 },
+	[special_benchmarking] = { "benchmarking", "RFC 2544", 0 },
+	[special_multicast] = { "multicast", "RFC 5771", 0 },
+	[special_reserved] = { "reserved", "RFC 1112", 0 },
+	[special_broadcast] = { "broadcast", "RFC 919", 0 },
+	[special_mixed] = { "mixed", NULL, 0 }
+};
+
+const char *special_name(enum special_class cls)
+{
+	if ((unsigned) cls >= SPECIAL_CLASSES) { return "global"; }
+
+	return special_registry[cls].name;
+}
+
+enum special_class special_classify_prefix(uint32_t addr, uint8_t bitmask)
+{
+	if (bitmask > 32) { return special_mixed; }
+
+	return (enum special_class) prefix_class(0, 0, addr, bitmask);
+}
+
+static uint8_t prefix_class(int level, uint8_t block, uint32_t addr, uint8_t bitmask)
+{
+	static const uint8_t (*const levels[])[256] = {
+		(const uint8_t (*)[256]) special_octet1, special_octet2, special_octet3, special_octet4
+	};
+	int fixed = bitmask - 8 * level;			/* Bits of this octet set by the prefix */
+	unsigned first = addr >> (24 - 8 * level) & 0xff;
+	unsigned last = first;
+	uint8_t cls = special_mixed;
+	uint8_t v;
+
+	if (fixed < 8) {
+		first = fixed > 0 ? first & (0xff << (8 - fixed) & 0xff) : 0;
+		last = first | (fixed > 0 ? 0xff >> fixed : 0xff);
+	}
+
+	for (unsigned o = first; o <= last; o++) {
+		v = levels[level][block][o];
+		if (v & SPECIAL_DESCEND) { v = prefix_class(level + 1, v & ~SPECIAL_DESCEND, addr, bitmask); }
+
+		if (v == special_mixed || (o != first && v != cls)) { return special_mixed; }
+		cls = v;
+	}
+
+	return cls;
+}
+
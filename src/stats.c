@@ -0,0 +1,202 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "stats.h"
+
+#ifdef IPC_STATS
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+struct stats ipc_stats;
+
+static const char *const stage_names[STAGE_COUNT] = { "parse", "derive", "build", "output" };
+static const char *const hist_names[HIST_COUNT] = { "batch", "serve" };
+
+static int stats_enabled = 0;
+static int stats_json = 0;
+static uint64_t start_ticks;                /* Clock calibration */
+static uint64_t start_ns;
+
+/**
+ * @brief Wall clock for the calibration.
+ * @return Nanoseconds.
+ */
+static uint64_t wall_ns(void);
+
+/**
+ * @brief Value at a rank of a histogram.
+ * @param h Histogram.
+ * @param q Quantile in [0, 1].
+ * @return Upper edge of the bucket holding the rank, in ticks.
+ */
+static uint64_t hist_quantile(const struct stats_histogram *h, double q);
+
+/**
+ * @brief Bucket of a value.
+ * @param value Ticks.
+ * @return Bucket index.
+ */
+static unsigned hist_bucket(uint64_t value);
+
+void stats_hist_add(struct stats_histogram *h, uint64_t value)
+{
+	h->buckets[hist_bucket(value)]++;
+	h->count++;
+	h->sum += value;
+	if (value > h->max) { h->max = value; }
+
+	return;
+}
+
+void stats_enable(int json)
+{
+	stats_enabled = 1;
+	stats_json = json;
+	start_ns = wall_ns();
+	start_ticks = stats_clock();
+
+	return;
+}
+
+void stats_report(void)
+{
+	static const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+	static const char *const q_names[] = { "p50", "p90", "p99", "p99.9" };
+	const struct stats_histogram *h = NULL;
+	struct rusage ru;
+	double ns_per_tick, total_ms = 0;
+	uint64_t elapsed_ns;
+
+	if (!stats_enabled) { return; }
+
+	elapsed_ns = wall_ns() - start_ns;
+	ns_per_tick = (double) elapsed_ns / (stats_clock() - start_ticks);
+
+	memset(&ru, 0, sizeof(struct rusage));
+	getrusage(RUSAGE_SELF, &ru);
+
+	for (int s = 0; s < STAGE_COUNT; s++) { total_ms += ipc_stats.ticks[s] * ns_per_tick / 1e6; }
+
+	if (stats_json) {
+		fprintf(stderr, "{\"elapsed_ms\": %.3f, \"stages\": {", elapsed_ns / 1e6);
+		for (int s = 0; s < STAGE_COUNT; s++) {
+			fprintf(stderr, "%s\"%s\": {\"ms\": %.3f, \"laps\": %llu}", s ? ", " : "",
+					stage_names[s], ipc_stats.ticks[s] * ns_per_tick / 1e6,
+					(unsigned long long) ipc_stats.laps[s]);
+		}
+		fprintf(stderr, "}, \"items\": %llu, \"errors\": %llu, \"allocs\": %llu, "
+				"\"alloc_bytes\": %llu, \"peak_rss_kb\": %ld, \"latency_ns\": {",
+				(unsigned long long) ipc_stats.items, (unsigned long long) ipc_stats.errors,
+				(unsigned long long) ipc_stats.allocs, (unsigned long long) ipc_stats.alloc_bytes,
+				ru.ru_maxrss);
+		for (int i = 0, first = 1; i < HIST_COUNT; i++) {
+			h = &ipc_stats.hist[i];
+			if (!h->count) { continue; }
+			fprintf(stderr, "%s\"%s\": {\"count\": %llu, \"mean\": %.0f", first ? "" : ", ",
+					hist_names[i], (unsigned long long) h->count, h->sum * ns_per_tick / h->count);
+			for (size_t q = 0; q < sizeof(quantiles) / sizeof(quantiles[0]); q++) {
+				fprintf(stderr, ", \"%s\": %.0f", q_names[q],
+						hist_quantile(h, quantiles[q]) * ns_per_tick);
+			}
+			fprintf(stderr, ", \"max\": %.0f}", h->max * ns_per_tick);
+			first = 0;
+		}
+		fputs("}}\n", stderr);
+
+		return;
+	}
+
+	fprintf(stderr, "%-15s%.3f ms\n", "Elapsed", elapsed_ns / 1e6);
+	for (int s = 0; s < STAGE_COUNT; s++) {
+		fprintf(stderr, "%-15s%.3f ms (%.1f%%)\n", stage_names[s],
+				ipc_stats.ticks[s] * ns_per_tick / 1e6,
+				total_ms > 0 ? ipc_stats.ticks[s] * ns_per_tick / 1e6 / total_ms * 100 : 0);
+	}
+	fprintf(stderr, "%-15s%llu\n", "Items", (unsigned long long) ipc_stats.items);
+	fprintf(stderr, "%-15s%llu\n", "Errors", (unsigned long long) ipc_stats.errors);
+	fprintf(stderr, "%-15s%llu\n", "Allocs", (unsigned long long) ipc_stats.allocs);
+	fprintf(stderr, "%-15s%llu\n", "Alloc bytes", (unsigned long long) ipc_stats.alloc_bytes);
+	fprintf(stderr, "%-15s%ld KiB\n", "Peak RSS", ru.ru_maxrss);
+
+	for (int i = 0; i < HIST_COUNT; i++) {
+		h = &ipc_stats.hist[i];
+		if (!h->count) { continue; }
+
+		fprintf(stderr, "Latency %s (ns): n=%llu mean=%.0f", hist_names[i],
+				(unsigned long long) h->count, h->sum * ns_per_tick / h->count);
+		for (size_t q = 0; q < sizeof(quantiles) / sizeof(quantiles[0]); q++) {
+			fprintf(stderr, " %s=%.0f", q_names[q], hist_quantile(h, quantiles[q]) * ns_per_tick);
+		}
+		fprintf(stderr, " max=%.0f\n", h->max * ns_per_tick);
+	}
+
+	return;
+}
+
+static uint64_t wall_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static uint64_t hist_quantile(const struct stats_histogram *h, double q)
+{
+	uint64_t rank = (uint64_t) (q * (h->count - 1)) + 1;
+	uint64_t seen = 0;
+	unsigned exp, sub;
+	uint64_t upper;
+
+	for (unsigned b = 0; b < HIST_BUCKETS; b++) {
+		seen += h->buckets[b];
+		if (seen < rank) { continue; }
+
+		if (b < (2u << HIST_SUB_BITS)) { return b; }
+
+		/* Bucket b covers [(16 + sub) << (exp - 4), (17 + sub) << (exp - 4)) */
+		exp = (b >> HIST_SUB_BITS) + HIST_SUB_BITS - 1;
+		sub = b & ((1u << HIST_SUB_BITS) - 1);
+		upper = ((uint64_t) ((1u << HIST_SUB_BITS) + sub + 1) << (exp - HIST_SUB_BITS)) - 1;
+
+		return upper < h->max ? upper : h->max;
+	}
+
+	return h->max;
+}
+
+static unsigned hist_bucket(uint64_t value)
+{
+	unsigned exp;
+
+	if (value < (2u << HIST_SUB_BITS)) { return (unsigned) value; }
+
+	/* Top bit picks the row, the next 4 bits the column */
+	exp = 63 - __builtin_clzll(value);
+
+	return ((exp - HIST_SUB_BITS + 1) << HIST_SUB_BITS) |
+		   (unsigned) (value >> (exp - HIST_SUB_BITS) & ((1u << HIST_SUB_BITS) - 1));
+}
+
+#endif /* IPC_STATS */
@@ -21,27 +21,66 @@
 #include <stddef.h>
 #include <stdlib.h>
 #include <stdio.h>
-
-#include "ipv4_t.h"
-#include "fill_ipv4.h"
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "ipc.h"
+#include "stats.h"
 #include "subnet.h"
 #include "subnet_list.h"
 
+/* Rows a thread formats before its buffer goes out (about 4 MiB) */
+#define CHUNK_ROWS			65536
+
+/**
+ * @struct split_job
+ * @brief State shared by the threads of a parallel split.
+ *
+ * Chunk c (rows c * CHUNK_ROWS onwards) belongs to thread
+ * c % threads. With pwrite every thread writes its chunks at their
+ * own offsets; otherwise chunks go out in turn, next says whose.
+ */
+struct split_job {
+    struct ipc_split sp;            /**< Split, copied by every thread */
+    uint64_t chunks;                /**< Number of chunks */
+    unsigned threads;               /**< Number of threads */
+    int fd;                         /**< Destination */
+    int positional;                 /**< Rows have known offsets, use pwrite */
+    off_t start;                    /**< Offset of row 0 in fd */
+    pthread_mutex_t lock;           /**< Guards next and error */
+    pthread_cond_t turn;            /**< next changed */
+    uint64_t next;                  /**< Chunk to be written next */
+    int error;                      /**< A write failed */
+};
+
+/**
+ * @struct split_worker
+ * @brief One thread of a parallel split.
+ */
+struct split_worker {
+    struct split_job *job;          /**< Shared state */
+    unsigned id;                    /**< First chunk of the thread */
+    char *buf;                      /**< Formatted rows of one chunk */
+    pthread_t tid;                  /**< Thread */
+};
+
 /**
  * @brief Dividing the network into equal subnets.
  * 
- * @param ip Structure with address data.
  * @param ip_str IP address in CIDR notation.
  * @param num_of_subnets Number of subnets required.
  * @param list_res List with calculation results.
  * 
  * @return EXIT_SUCCESS on success, EXIT_FAILURE on error.
  */
-static int equal_opt_handler(ipv4_t *ip, const char *ip_str, 
-                             size_t num_of_subnets, struct subnet *list_res);
+static int equal_opt_handler(const char *ip_str, size_t num_of_subnets,
+                             struct subnet *list_res);
 /**
  * @brief Dividing the network into different subnets. 
- * @param ip Structure with address data.
  * @param ip_str IP address in CIDR notation.
  * @param arr Stores the parts into which the network should be divided.
  *            The size of the array is the number of parts, the value of
@@ -51,52 +90,84 @@ static int equal_opt_handler(ipv4_t *ip, const char *ip_str,
  * 
  * @return EXIT_SUCCESS on success, EXIT_FAILURE on error.
  */
-static int part_opt_handler(ipv4_t *ip, const char *ip_str, int *arr, 
-                            size_t len, struct subnet *list_res);
+static int part_opt_handler(const char *ip_str, int *arr, size_t len,
+                            struct subnet *list_res);
 
 /**
- * @brief Moves the network address to the start of the next subnet. 
- * @param ip Structure with address data.
- * @return Pointer to modified structure, or NULL otherwise.
- * @pre The network_set flag in the ipv4_t structure must be set to 1.
+ * @brief Fill the list with every subnet of the split.
+ * @param sp Split iterator.
+ * @param list_res List head, receives the first subnet.
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on error.
  */
-static ipv4_t *switch_subnet(ipv4_t *ip);
+static int build_list(struct ipc_split *sp, struct subnet *list_res);
 
 /**
- * @brief Calculates the minimal power-of-two exponent to accommodate a given number.
- * @param target The required minimum capacity.
- * @return The smallest integer k such that 2^k >= target, or 0 if target <= 1.
+ * @brief Format and write every subnet of a split with several threads.
+ *
+ * The output is the same as print_list() gives, row for row.
+ *
+ * @param sp Split iterator, at the start.
+ * @param threads Number of threads.
+ *
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on error.
  */
-static int get_min_power_of_two(int target);
+static int split_parallel(const struct ipc_split *sp, unsigned threads);
 
 /**
- * @brief Verify if requested subnet partitions fit in the IPv4 network.
- * 
- * @param arr Stores the parts into which the network should be divided.
- *            The size of the array is the number of parts, the value of
- *            each element is the number of addresses in the part.
- * @param len Size of arr.
- * @param ip Structure with address data.
- * 
- * @pre The bitmask_set flag in the ipv4_t structure must be set to 1.
+ * @brief Thread body: format and write chunks id, id + threads, ...
+ * @param arg struct split_worker.
+ * @return NULL.
+ */
+static void *split_worker_run(void *arg);
+
+/**
+ * @brief Byte offset of a row of an equal split from the first row.
+ *
+ * Every row but the index has the same width in an equal split, and
+ * the index is at least 5 wide.
+ *
+ * @param sp Equal split.
+ * @param idx Row number.
+ *
+ * @return Offset in bytes.
+ */
+static off_t row_offset(const struct ipc_split *sp, uint64_t idx);
+
+/**
+ * @brief Write all bytes, at an offset if pos is not negative.
+ * @param fd Destination.
+ * @param buf Data.
+ * @param len Number of bytes.
+ * @param pos Offset for pwrite, -1 for write.
+ * @return 0 on success, -1 on error.
  */
-static int parts_will_fit(int *arr, size_t len, ipv4_t *ip);
+static int write_all(int fd, const char *buf, size_t len, off_t pos);
 
-int subnetting_start(ipv4_t *ip, const char *ip_str, int *arr, size_t len)
+int subnetting_start(const char *ip_str, int *arr, size_t len, unsigned threads)
 {
     struct subnet *head = NULL;
+    struct ipc_split sp;
     int res_opt;
 
-    if (!ip || !ip_str || !arr || !len) { return EXIT_FAILURE; }
+    if (!ip_str || !arr || !len) { return EXIT_FAILURE; }
+
+    /* Threads skip the list, subnet i is found from i alone */
+    if (threads) {
+        if (arr[0] == '\0') { res_opt = ipc_split_equal(&sp, ip_str, len); }
+        else { res_opt = ipc_split_part(&sp, ip_str, arr, len); }
+        if (res_opt == -1) { return EXIT_FAILURE; }
+
+        return split_parallel(&sp, threads);
+    }
 
     head = calloc(1, sizeof(struct subnet));
     if (!head) { return EXIT_FAILURE; }
 
     if (arr[0] == '\0') { 
-        res_opt = equal_opt_handler(ip, ip_str, len, head);
+        res_opt = equal_opt_handler(ip_str, len, head);
     }
     else { 
-        res_opt = part_opt_handler(ip, ip_str, arr, len, head);
+        res_opt = part_opt_handler(ip_str, arr, len, head);
     }
 
     if (res_opt == EXIT_SUCCESS) { print_list(head); }
@@ -105,155 +176,214 @@ int subnetting_start(ipv4_t *ip, const char *ip_str, int *arr, size_t len)
     return res_opt;
 }
 
-static int equal_opt_handler(ipv4_t *ip, const char *ip_str, 
-                             size_t num_of_subnets, struct subnet *list_res)
+static int equal_opt_handler(const char *ip_str, size_t num_of_subnets,
+                             struct subnet *list_res)
 {
-    struct subnet *new_node = NULL;
+    struct ipc_split sp;
 
-    if (!ip || !ip_str || !num_of_subnets || !list_res) { return EXIT_FAILURE; }
+    if (!ip_str || !num_of_subnets || !list_res) { return EXIT_FAILURE; }
 
-	if (!fill_addr(ip, ip_str)) { return EXIT_FAILURE; }
-	if (!fill_bitmask(ip, ip_str)) { return EXIT_FAILURE; }
-    ip->bitmask += get_min_power_of_two(num_of_subnets);
-    if (32 - ip->bitmask < 1) { return EXIT_FAILURE; }
-    if (!fill_netmask(ip)) { return EXIT_FAILURE; }
-	if (!fill_wildcard(ip)) { return EXIT_FAILURE; }
-	if (!fill_network(ip)) { return EXIT_FAILURE; }
-	if (!fill_broadcast(ip)) { return EXIT_FAILURE; }
+    if (ipc_split_equal(&sp, ip_str, num_of_subnets) == -1) { return EXIT_FAILURE; }
 
-    init_node(list_res, ip);
+    return build_list(&sp, list_res);
+}
 
-    for (int i = 0; i < num_of_subnets - 1; i++) {
-        if (!switch_subnet(ip)){ return EXIT_FAILURE; }
-	    if (!fill_broadcast(ip)){ return EXIT_FAILURE; }
+static int part_opt_handler(const char *ip_str, int *arr, size_t len,
+                            struct subnet *list_res)
+{
+    struct ipc_split sp;
 
-        new_node = calloc(1, sizeof(struct subnet));
-        if (!new_node){ return EXIT_FAILURE; }
+    if (!ip_str || !arr || !len || !list_res) { return EXIT_FAILURE; }
 
-        init_node(new_node, ip);
-        add_to_list(list_res, new_node);
-    }
+    if (ipc_split_part(&sp, ip_str, arr, len) == -1) { return EXIT_FAILURE; }
 
-    return EXIT_SUCCESS;
+    return build_list(&sp, list_res);
 }
 
-/* 
- * For qsort in part_opt_handler.
- * Sorts in descending order.
- */
-static int compare(const void *p1, const void *p2) 
-{ return *(const int *) p2 - *(const int *) p1; }
-
-static int part_opt_handler(ipv4_t *ip, const char *ip_str, int *arr, 
-                            size_t len, struct subnet *list_res)
+static int build_list(struct ipc_split *sp, struct subnet *list_res)
 {
     struct subnet *new_node = NULL;
-    uint32_t net_num, brc_num;
-    uint8_t new_bitmask;
-
-    if (!ip || !ip_str || !arr || !len || !list_res) { return EXIT_FAILURE; }
+    struct subnet *tail = list_res;
+    struct ipc_subnet sn;
+    STATS_DECL(t);
 
-    qsort(arr, len, sizeof(int), compare);
+    if (!ipc_split_next(sp, &sn)) { return EXIT_FAILURE; }
+    init_node(list_res, &sn);
+    STATS_ITEMS(1);
 
-	if (!fill_addr(ip, ip_str)) { return EXIT_FAILURE; }
-	if (!fill_bitmask(ip, ip_str)) { return EXIT_FAILURE; }
+    while (ipc_split_next(sp, &sn)) {
+        new_node = calloc(1, sizeof(struct subnet));
+        if (!new_node) { return EXIT_FAILURE; }
 
-    if (!parts_will_fit(arr, len, ip)) { return EXIT_FAILURE; }
+        init_node(new_node, &sn);
 
-    new_bitmask = 32 - get_min_power_of_two(arr[0]);
-    if (new_bitmask <= 0 || new_bitmask < ip->bitmask) { return EXIT_FAILURE; }
-    ip->bitmask = new_bitmask;
+        /* Appending to the tail keeps every append O(1) */
+        tail = add_to_list(tail, new_node);
+        STATS_ITEMS(1);
+    }
 
-    if (!fill_netmask(ip)) { return EXIT_FAILURE; }
-    if (!fill_wildcard(ip)) { return EXIT_FAILURE; }
-    if (!fill_network(ip)) { return EXIT_FAILURE; }
-    if (!fill_broadcast(ip)) { return EXIT_FAILURE; }
-    init_node(list_res, ip);
+    STATS_LAP(t, stage_build);
 
-    for (int i = 1; i < len; i++) {
-        brc_num = (ip->broadcast[0] << 24) | (ip->broadcast[1] << 16) |
-                  (ip->broadcast[2] << 8) | (ip->broadcast[3]);
+    return EXIT_SUCCESS;
+}
 
-        net_num = brc_num + 1;
+static int split_parallel(const struct ipc_split *sp, unsigned threads)
+{
+    struct split_job job;
+    struct split_worker *workers = NULL;
+    struct stat st;
+    char header[IPC_SUBNET_ROW_MAX];
+    unsigned started = 0;
+    int len, flags;
+    STATS_DECL(t);
+
+    memset(&job, 0, sizeof(job));
+    job.sp = *sp;
+    job.fd = STDOUT_FILENO;
+    job.chunks = (sp->count + CHUNK_ROWS - 1) / CHUNK_ROWS;
+    job.threads = threads < job.chunks ? threads : (unsigned) job.chunks;
+
+    len = snprintf(header, sizeof(header), "%5s%-20s%-20s%-11s\n", "", "MIN", "MAX", "MASK");
+
+    /*
+     * Equal splits into a regular file have fixed-width rows, so every
+     * thread can pwrite its chunks as soon as they are formatted.
+     * O_APPEND would make pwrite ignore the offset.
+     */
+    fflush(stdout);
+    flags = fcntl(job.fd, F_GETFL);
+    if (!sp->parts && fstat(job.fd, &st) == 0 && S_ISREG(st.st_mode)
+        && flags != -1 && !(flags & O_APPEND)) {
+        job.start = lseek(job.fd, 0, SEEK_CUR);
+        job.positional = job.start != -1;
+    }
 
-        ip->network[0] = net_num >> 24;
-        ip->network[1] = net_num >> 16 & 0xFF;
-        ip->network[2] = net_num >> 8 & 0xFF;
-        ip->network[3] = net_num & 0xFF;
+    if (write_all(job.fd, header, len, job.positional ? job.start : -1) == -1) {
+        return EXIT_FAILURE;
+    }
+    job.start += len;
 
-        new_bitmask = 32 - get_min_power_of_two(arr[i]);
-        if (new_bitmask <= 0) { return EXIT_FAILURE; }
-        ip->bitmask = new_bitmask;
+    workers = calloc(job.threads, sizeof(struct split_worker));
+    if (!workers) { return EXIT_FAILURE; }
 
-        if (!fill_wildcard(ip)) { return EXIT_FAILURE; }
-        if (!fill_broadcast(ip)) { return EXIT_FAILURE; }
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_cond_init(&job.turn, NULL);
 
-        new_node = calloc(1, sizeof(struct subnet));
-        if (!new_node){ return EXIT_FAILURE; }
+    for (; started < job.threads; started++) {
+        workers[started].job = &job;
+        workers[started].id = started;
+        workers[started].buf = malloc((size_t) CHUNK_ROWS * IPC_SUBNET_ROW_MAX);
+        if (!workers[started].buf) { break; }
 
-        init_node(new_node, ip);
-        add_to_list(list_res, new_node);
+        if (pthread_create(&workers[started].tid, NULL, split_worker_run, &workers[started]) != 0) {
+            free(workers[started].buf);
+            break;
+        }
     }
 
-    return EXIT_SUCCESS;
-}
-
-static ipv4_t *switch_subnet(ipv4_t *ip)
-{
-    int host_bit; 
-    uint32_t net_num;
-
-    if (!ip) { return NULL; }
-    if (!ip->network_set) { return NULL; }
+    /* Chunks of threads that did not start would never be written */
+    if (started < job.threads) {
+        pthread_mutex_lock(&job.lock);
+        job.error = 1;
+        pthread_cond_broadcast(&job.turn);
+        pthread_mutex_unlock(&job.lock);
+    }
 
-    net_num = (ip->network[0] << 24) | (ip->network[1] << 16) |
-              (ip->network[2] << 8) | (ip->network[3]);
+    for (unsigned i = 0; i < started; i++) {
+        pthread_join(workers[i].tid, NULL);
+        free(workers[i].buf);
+    }
 
-    host_bit = 32 - ip->bitmask;
+    /* Leave the file position after the last row, as write would */
+    if (job.positional && !job.error) {
+        lseek(job.fd, job.start + row_offset(sp, sp->count), SEEK_SET);
+    }
 
-    net_num += 1 << host_bit;
+    pthread_cond_destroy(&job.turn);
+    pthread_mutex_destroy(&job.lock);
+    free(workers);
 
-    ip->network[0] = net_num >> 24;
-    ip->network[1] = net_num >> 16 & 0xFF;
-    ip->network[2] = net_num >> 8 & 0xFF;
-    ip->network[3] = net_num & 0xFF;
+    STATS_LAP(t, stage_output);
+    STATS_ITEMS(sp->count);
 
-    return ip;
+    return job.error ? EXIT_FAILURE : EXIT_SUCCESS;
 }
 
-static int get_min_power_of_two(int target)
+static void *split_worker_run(void *arg)
 {
-    int res_exp = 1;
-    int pow = 1;
+    struct split_worker *w = arg;
+    struct split_job *job = w->job;
+    struct ipc_split sp;
+    struct ipc_subnet sn;
+    uint64_t first;
+    size_t len;
+    int res;
+
+    for (uint64_t c = w->id; c < job->chunks; c += job->threads) {
+        first = c * CHUNK_ROWS;
+        sp = job->sp;
+        ipc_split_seek(&sp, first);
+
+        len = 0;
+        for (uint64_t i = first; i < first + CHUNK_ROWS && ipc_split_next(&sp, &sn); i++) {
+            len += ipc_format_subnet(&sn, i, w->buf + len, IPC_SUBNET_ROW_MAX);
+        }
+
+        if (job->positional) {
+            res = write_all(job->fd, w->buf, len, job->start + row_offset(&job->sp, first));
+            if (res == -1) {
+                pthread_mutex_lock(&job->lock);
+                job->error = 1;
+                pthread_mutex_unlock(&job->lock);
+                break;
+            }
+            continue;
+        }
+
+        /* Formatting above overlaps with the writes of other threads */
+        pthread_mutex_lock(&job->lock);
+        while (job->next != c && !job->error) { pthread_cond_wait(&job->turn, &job->lock); }
+        if (!job->error && write_all(job->fd, w->buf, len, -1) == -1) { job->error = 1; }
+        job->next++;
+        res = job->error;
+        pthread_cond_broadcast(&job->turn);
+        pthread_mutex_unlock(&job->lock);
+
+        if (res) { break; }
+    }
 
-    if (target <= 1) { return 0; }
+    return NULL;
+}
 
-    for (; pow < target; pow++) {
-        res_exp = 1 << pow;
-        if (res_exp >= target) { break; }
+static off_t row_offset(const struct ipc_split *sp, uint64_t idx)
+{
+    /* Two addresses, two gaps of 5, the mask and '\n' */
+    off_t fixed = 2 * 15 + 2 * 5 + (sp->sub_bitmask >= 10 ? 2 : 1) + 1;
+    off_t off = (off_t) idx * (fixed + 5);
+    uint64_t lo = 100000;
+    int width = 6;
+
+    /* Indexes of 6 digits and more widen their rows */
+    for (; idx > lo; lo *= 10, width++) {
+        off += (off_t) ((idx < lo * 10 ? idx : lo * 10) - lo) * (width - 5);
     }
 
-    return pow;
+    return off;
 }
 
-static int parts_will_fit(int *arr, size_t len, ipv4_t *ip)
+static int write_all(int fd, const char *buf, size_t len, off_t pos)
 {
-    int pow, host_bit, res_exp;
-    unsigned int demand = 0, available;
+    ssize_t n;
 
-    if (!arr || !len || !ip ) { return 0; }
-    if (!ip->bitmask_set) { return 0; }
+    while (len) {
+        n = pos < 0 ? write(fd, buf, len) : pwrite(fd, buf, len, pos);
+        if (n == -1 && errno == EINTR) { continue; }
+        if (n <= 0) { return -1; }
 
-    for (int i = 0; i < len; i++) {
-        pow = get_min_power_of_two(arr[i]);
-        res_exp = 1 << pow;
-        demand += res_exp;
+        buf += n;
+        len -= n;
+        if (pos >= 0) { pos += n; }
     }
 
-    host_bit = 32 - ip->bitmask;
-    available = 1 << host_bit;
-
-    if (demand > available) { return 0; }
-
-    return 1;
+    return 0;
 }
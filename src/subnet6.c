@@ -0,0 +1,110 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ipv6.h"
+#include "format.h"
+#include "stats.h"
+#include "subnet6.h"
+
+/**
+ * @brief Write every subnet of a split to stdout.
+ * @param sp Prepared split.
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on error.
+ */
+static int print_split(struct ipv6_split *sp);
+
+int subnetting6_start(int argc, char **argv)
+{
+	struct ipv6_split sp;
+	ipv6_u128 *parts = NULL;
+	ipv6_u128 count;
+	size_t len;
+	int res;
+	STATS_DECL(t);
+
+	if (argc < 3 || !argv) { return EXIT_FAILURE; }
+
+	if (strcmp(argv[1], "--equal") == 0) {
+		if (argc != 3) { return EXIT_FAILURE; }
+		if (ipv6_parse_u128(argv[2], &count) == -1) { return EXIT_FAILURE; }
+		if (ipv6_split_equal(&sp, argv[0], count) == -1) { return EXIT_FAILURE; }
+		STATS_LAP(t, stage_parse);
+
+		return print_split(&sp);
+	}
+
+	if (strcmp(argv[1], "--part") != 0) { return EXIT_FAILURE; }
+
+	len = argc - 2;
+	parts = malloc(len * sizeof(ipv6_u128));
+	if (!parts) { return EXIT_FAILURE; }
+
+	for (size_t i = 0; i < len; i++) {
+		if (ipv6_parse_u128(argv[i + 2], &parts[i]) == -1) { goto handle_error; }
+	}
+
+	if (ipv6_split_part(&sp, argv[0], parts, len) == -1) { goto handle_error; }
+	STATS_LAP(t, stage_parse);
+
+	res = print_split(&sp);
+
+	free(parts);
+	return res;
+
+	handle_error:
+		free(parts);
+		return EXIT_FAILURE;
+}
+
+static int print_split(struct ipv6_split *sp)
+{
+	struct outbuf *ob = NULL;
+	struct ipv6_subnet sn;
+	ipv6_u128 idx = 0;
+	char *dst = NULL;
+	int res;
+	STATS_DECL(t);
+
+	ob = malloc(sizeof(struct outbuf));
+	if (!ob) { return EXIT_FAILURE; }
+	outbuf_init(ob, stdout);
+
+	dst = outbuf_reserve(ob, IPV6_SUBNET_ROW_MAX);
+	ob->len += sprintf(dst, "%5s%-44s%-44s%-11s\n", "", "MIN", "MAX", "MASK");
+
+	/* Stop at a closed pipe instead of formatting the rest */
+	while (!ob->error && ipv6_split_next(sp, &sn)) {
+		dst = outbuf_reserve(ob, IPV6_SUBNET_ROW_MAX);
+		ob->len += ipv6_format_subnet(&sn, idx++, dst, IPV6_SUBNET_ROW_MAX);
+	}
+
+	res = outbuf_flush(ob);
+
+	STATS_LAP(t, stage_output);
+	STATS_ITEMS(idx);
+
+	free(ob);
+
+	return res == -1 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -21,6 +21,8 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+#include "fill_ipv4.h"
+#include "stats.h"
 #include "subnet_list.h"
 
 struct subnet *add_to_list(struct subnet *head, struct subnet *node)
@@ -55,42 +57,40 @@ void remove_list(struct subnet *head)
     return;
 }
 
-int init_node(struct subnet *node, ipv4_t *ip)
+int init_node(struct subnet *node, const struct ipc_subnet *sn)
 {
-    if (!node || !ip) { return -1; }
+    if (!node || !sn) { return -1; }
 
-    node->bitmask = ip->bitmask;
-
-    for (int i = 0; i < 4; i++) {
-        node->minaddr[i] = ip->network[i];
-        node->maxaddr[i] = ip->broadcast[i];
-    }
+    node->bitmask = sn->bitmask;
+    u32_to_addr(sn->first, node->minaddr);
+    u32_to_addr(sn->last, node->maxaddr);
 
     return 0;
 }
 
 void print_list(const struct subnet *head)
 {
+    struct ipc_subnet sn;
+    char row[IPC_SUBNET_ROW_MAX];
+    int len;
+    STATS_DECL(t);
+
     if (!head) { return; }
     
 	printf("%5s%-20s%-20s%-11s\n", "", "MIN", "MAX", "MASK");
 
-    for (int i = 0; head; i++) {
-	    printf("%-5d%03d.%03d.%03d.%03d%5s", i,
-                                             head->minaddr[0],
-                                             head->minaddr[1],
-                                             head->minaddr[2],
-                                             head->minaddr[3],
-                                             "");
-	    printf("%03d.%03d.%03d.%03d%5s", head->maxaddr[0],
-                                         head->maxaddr[1],
-                                         head->maxaddr[2],
-                                         head->maxaddr[3],
-                                         "");
-        printf("%d\n", head->bitmask);
+    for (uint64_t i = 0; head; i++) {
+        sn.first = addr_to_u32(head->minaddr);
+        sn.last = addr_to_u32(head->maxaddr);
+        sn.bitmask = head->bitmask;
+
+        len = ipc_format_subnet(&sn, i, row, sizeof(row));
+        if (len > 0) { fwrite(row, 1, len, stdout); }
 
         head = head->next;
     }
 
+    STATS_LAP(t, stage_output);
+
     return;
 }
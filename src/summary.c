@@ -0,0 +1,280 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fill_ipv4.h"
+#include "prefix_list.h"
+#include "summary.h"
+
+/**
+ * @brief Make room for a full path of new nodes.
+ * @param sm Summary.
+ * @return 0 on success, -1 on error.
+ */
+static int reserve_path(struct summary *sm);
+
+/**
+ * @brief Take a node from the free list or the pool.
+ * @param sm Summary, with room reserved.
+ * @return Node index.
+ */
+static uint32_t node_alloc(struct summary *sm);
+
+/**
+ * @brief Add or remove one copy of a prefix and report the cover delta.
+ * @param sm Summary.
+ * @param addr Network address.
+ * @param bitmask Mask length.
+ * @param add 1 to add, 0 to remove.
+ * @param emit Delta receiver, may be NULL.
+ * @param ctx Passed to emit.
+ * @return 0 on success, -1 on error.
+ */
+static int change(struct summary *sm, uint32_t addr, uint8_t bitmask, int add,
+				  summary_emit_fn emit, void *ctx);
+
+/**
+ * @brief Report the topmost covered nodes of a subtree.
+ * @param sm Summary.
+ * @param idx Subtree root.
+ * @param addr Prefix of idx.
+ * @param depth Mask length of idx.
+ * @param added Passed to emit.
+ * @param emit Receiver.
+ * @param ctx Passed to emit.
+ */
+static void walk(const struct summary *sm, uint32_t idx, uint32_t addr, uint8_t depth,
+				 int added, summary_emit_fn emit, void *ctx);
+
+int summary_init(struct summary *sm)
+{
+	if (!sm) { return -1; }
+
+	memset(sm, 0, sizeof(struct summary));
+
+	if (reserve_path(sm) == -1) { return -1; }
+
+	/* Root, the /0 */
+	memset(&sm->nodes[0], 0, sizeof(struct summary_node));
+	sm->len = 1;
+
+	return 0;
+}
+
+int summary_add(struct summary *sm, uint32_t addr, uint8_t bitmask,
+				summary_emit_fn emit, void *ctx)
+{
+	if (!sm || !sm->nodes || bitmask > BITS_IN_IP) { return -1; }
+
+	return change(sm, addr & prefix_netmask(bitmask), bitmask, 1, emit, ctx);
+}
+
+int summary_remove(struct summary *sm, uint32_t addr, uint8_t bitmask,
+				   summary_emit_fn emit, void *ctx)
+{
+	if (!sm || !sm->nodes || bitmask > BITS_IN_IP) { return -1; }
+
+	return change(sm, addr & prefix_netmask(bitmask), bitmask, 0, emit, ctx);
+}
+
+int summary_read(struct summary *sm, FILE *fp, char *bad, size_t size)
+{
+	struct token_reader rd;
+	struct prefix pfx;
+	char *tok = NULL;
+
+	if (!sm || !fp) { return -1; }
+
+	if (token_reader_init(&rd, fp) == -1) { return -1; }
+
+	while ((tok = token_reader_next(&rd))) {
+		if (parse_prefix(tok, &pfx) == -1) { goto handle_invalid; }
+		if (summary_add(sm, pfx.addr, pfx.bitmask, NULL, NULL) == -1) { goto handle_error; }
+	}
+
+	token_reader_free(&rd);
+	return 0;
+
+	handle_invalid:
+		if (bad && size) { snprintf(bad, size, "%s", tok); }
+		token_reader_free(&rd);
+		return SUMMARY_INVALID;
+
+	handle_error:
+		token_reader_free(&rd);
+		return -1;
+}
+
+void summary_walk(const struct summary *sm, summary_emit_fn emit, void *ctx)
+{
+	if (!sm || !sm->nodes || !emit) { return; }
+
+	walk(sm, 0, 0, 0, 1, emit, ctx);
+
+	return;
+}
+
+void summary_free(struct summary *sm)
+{
+	if (!sm) { return; }
+
+	free(sm->nodes);
+	memset(sm, 0, sizeof(struct summary));
+
+	return;
+}
+
+static int reserve_path(struct summary *sm)
+{
+	struct summary_node *nodes = NULL;
+	size_t cap;
+
+	/* A path never needs more than BITS_IN_IP new nodes */
+	if (sm->cap - sm->len >= BITS_IN_IP) { return 0; }
+
+	cap = sm->cap ? sm->cap * 2 : 1024;
+	if (cap > UINT32_MAX) { return -1; }
+
+	nodes = realloc(sm->nodes, cap * sizeof(struct summary_node));
+	if (!nodes) { return -1; }
+
+	sm->nodes = nodes;
+	sm->cap = cap;
+
+	return 0;
+}
+
+static uint32_t node_alloc(struct summary *sm)
+{
+	uint32_t idx;
+
+	if (sm->free_list) {
+		idx = sm->free_list;
+		sm->free_list = sm->nodes[idx].child[0];
+	}
+	else { idx = (uint32_t) sm->len++; }
+
+	memset(&sm->nodes[idx], 0, sizeof(struct summary_node));
+
+	return idx;
+}
+
+static int change(struct summary *sm, uint32_t addr, uint8_t bitmask, int add,
+				  summary_emit_fn emit, void *ctx)
+{
+	uint32_t path[BITS_IN_IP + 1];
+	uint8_t cov[BITS_IN_IP + 1];
+	struct summary_node *nodes = NULL;
+	struct summary_node *leaf = NULL;
+	uint32_t count, child, other, top_addr;
+	int bit, top = -1;
+
+	if (add && reserve_path(sm) == -1) { return -1; }
+	nodes = sm->nodes;
+
+	path[0] = 0;
+	for (int d = 0; d < bitmask; d++) {
+		bit = (addr >> (BITS_IN_IP - 1 - d)) & 1;
+		child = nodes[path[d]].child[bit];
+		if (!child) {
+			if (!add) { return -1; }
+			child = node_alloc(sm);
+			nodes[path[d]].child[bit] = child;
+		}
+		path[d + 1] = child;
+	}
+
+	leaf = &nodes[path[bitmask]];
+	if (!add && !leaf->count) { return -1; }
+	count = add ? leaf->count + 1 : leaf->count - 1;
+
+	/* New state of the path, bottom-up; nothing else can change */
+	cov[bitmask] = count || (leaf->child[0] && leaf->child[1]
+							 && nodes[leaf->child[0]].covered
+							 && nodes[leaf->child[1]].covered);
+	for (int d = bitmask - 1; d >= 0; d--) {
+		bit = (addr >> (BITS_IN_IP - 1 - d)) & 1;
+		other = nodes[path[d]].child[bit ^ 1];
+		cov[d] = nodes[path[d]].count || (cov[d + 1] && other && nodes[other].covered);
+	}
+
+	for (int d = 0; d <= bitmask; d++) {
+		if (cov[d] != nodes[path[d]].covered) {
+			top = d;
+			break;
+		}
+		/* Anything below a covered node is hidden from the cover */
+		if (nodes[path[d]].covered) { break; }
+	}
+
+	top_addr = addr & prefix_netmask((uint8_t) (top < 0 ? 0 : top));
+
+	/* The old cover under the flipped node goes, or the node itself */
+	if (emit && top >= 0) {
+		if (cov[top]) { walk(sm, path[top], top_addr, (uint8_t) top, 0, emit, ctx); }
+		else { emit(ctx, 0, top_addr, (uint8_t) top); }
+	}
+
+	leaf->count = count;
+	for (int d = 0; d <= bitmask; d++) { nodes[path[d]].covered = cov[d]; }
+	if (add) { sm->prefixes++; }
+	else { sm->prefixes--; }
+
+	if (emit && top >= 0) {
+		if (cov[top]) { emit(ctx, 1, top_addr, (uint8_t) top); }
+		else { walk(sm, path[top], top_addr, (uint8_t) top, 1, emit, ctx); }
+	}
+
+	/* Release the nodes that hold nothing any more */
+	for (int d = bitmask; d > 0; d--) {
+		leaf = &nodes[path[d]];
+		if (leaf->count || leaf->child[0] || leaf->child[1]) { break; }
+
+		bit = (addr >> (BITS_IN_IP - d)) & 1;
+		nodes[path[d - 1]].child[bit] = 0;
+		leaf->child[0] = sm->free_list;
+		sm->free_list = path[d];
+	}
+
+	return 0;
+}
+
+static void walk(const struct summary *sm, uint32_t idx, uint32_t addr, uint8_t depth,
+				 int added, summary_emit_fn emit, void *ctx)
+{
+	const struct summary_node *node = &sm->nodes[idx];
+
+	if (node->covered) {
+		emit(ctx, added, addr, depth);
+		return;
+	}
+
+	/* An uncovered /32 can not have children */
+	if (node->child[0]) { walk(sm, node->child[0], addr, depth + 1, added, emit, ctx); }
+	if (node->child[1]) {
+		walk(sm, node->child[1], addr | (uint32_t) 1 << (BITS_IN_IP - 1 - depth),
+			 depth + 1, added, emit, ctx);
+	}
+
+	return;
+}
@@ -0,0 +1,339 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+
+#include "ipv4_t.h"
+#include "fill_ipv4.h"
+#include "prefix_list.h"
+#include "interval_set.h"
+#include "format.h"
+#include "ipc.h"
+#include "stats.h"
+#include "status.h"
+#include "supernet.h"
+
+#define SUPERNET_CHUNK		(1 << 20)		/* Bytes read at once in binary mode */
+#define SUPERNET_LANES		8				/* 32-bit lanes of a vector */
+
+/*
+ * Vector of lanes. The compiler maps it to the widest registers of the
+ * target (two SSE2 registers on plain x86-64, one with AVX2) and to
+ * scalar code where there are none.
+ */
+typedef uint32_t lanes32_t __attribute__((vector_size(SUPERNET_LANES * 4)));
+typedef uint64_t lanes64_t __attribute__((vector_size(SUPERNET_LANES * 4)));
+
+/**
+ * @struct reduction
+ * @brief Accumulated entries.
+ *
+ * AND and OR commute with byte swapping, so binary input is reduced as
+ * read and only the results are converted.
+ */
+struct reduction {
+    uint32_t and_acc;               /**< AND of every first and last address */
+    uint32_t or_acc;                /**< OR of every first and last address */
+    uint64_t entries;               /**< Entries read */
+    uint8_t keep;                   /**< Collect the entries in set */
+    struct interval_set set;        /**< Entries, for the requested space */
+};
+
+/**
+ * @brief Reduce one stream.
+ * @param red Accumulators.
+ * @param fp Source stream.
+ * @param binary 4-byte big-endian addresses instead of text.
+ * @return 0 on success, -1 on error.
+ */
+static int reduce_stream(struct reduction *red, FILE *fp, int binary);
+
+/**
+ * @brief AND and OR of 32-bit words in memory order.
+ * @param p Words, any alignment.
+ * @param n Number of words.
+ * @param[in,out] and_acc AND accumulator.
+ * @param[in,out] or_acc OR accumulator.
+ */
+static void reduce_words(const uint8_t *p, size_t n, uint32_t *and_acc, uint32_t *or_acc);
+
+/**
+ * @brief AND and OR of packed intervals, both ends of each.
+ * @param keys Intervals packed as (first << 32 | last).
+ * @param n Number of intervals.
+ * @param[in,out] and_acc AND accumulator.
+ * @param[in,out] or_acc OR accumulator.
+ */
+static void reduce_keys(const uint64_t *keys, size_t n, uint32_t *and_acc, uint32_t *or_acc);
+
+/**
+ * @brief Print the covering prefix, its use and its analysis.
+ * @param red Accumulated entries.
+ * @return 0 on success, -1 on error.
+ */
+static int print_supernet(struct reduction *red);
+
+int supernet_start(int argc, char **argv)
+{
+	struct reduction red;
+	size_t file_cnt = 0;
+	int binary = 0;
+	FILE *fp = NULL;
+	int res;
+
+	memset(&red, 0, sizeof(struct reduction));
+	red.and_acc = UINT32_MAX;
+	red.keep = 1;
+
+	for (int i = 0; i < argc; i++) {
+		if (strcmp(argv[i], "--binary") == 0) { binary = 1; }
+		else if (strcmp(argv[i], "--no-waste") == 0) { red.keep = 0; }
+		else if (strncmp(argv[i], "--", 2) == 0) { return EXIT_FAILURE; }
+	}
+
+	for (int i = 0; i < argc; i++) {
+		if (strncmp(argv[i], "--", 2) == 0) { continue; }
+
+		file_cnt++;
+		fp = fopen(argv[i], "r");
+		if (!fp) {
+			fprintf(stderr, "ipc: %s: %s\n", argv[i], strerror(errno));
+			goto handle_error;
+		}
+		res = reduce_stream(&red, fp, binary);
+		fclose(fp);
+		if (res == -1) { goto handle_error; }
+	}
+
+	if (!file_cnt && reduce_stream(&red, stdin, binary) == -1) { goto handle_error; }
+
+	if (!red.entries) {
+		fputs("ipc: no entries\n", stderr);
+		goto handle_error;
+	}
+
+	if (print_supernet(&red) == -1) { goto handle_error; }
+
+	free(red.set.keys);
+	return EXIT_SUCCESS;
+
+	handle_error:
+		free(red.set.keys);
+		return EXIT_INPUT;
+}
+
+static int reduce_stream(struct reduction *red, FILE *fp, int binary)
+{
+	struct interval_set set;
+	char bad[INTERVAL_SET_ENTRY_MAX];
+	uint8_t *buf = NULL;
+	uint32_t and_raw = UINT32_MAX;
+	uint32_t or_raw = 0;
+	uint8_t bytes[4];
+	uint32_t addr;
+	size_t got, keep = 0;
+	int res;
+	STATS_DECL(t);
+
+	if (!binary) {
+		memset(&set, 0, sizeof(struct interval_set));
+		res = interval_set_read(&set, fp, bad, sizeof(bad));
+		if (res != 0) {
+			if (res == INTERVAL_SET_INVALID) { fprintf(stderr, "ipc: invalid entry '%s'\n", bad); }
+			else if (res == INTERVAL_SET_DAMAGED) { fputs("ipc: damaged compiled prefix set\n", stderr); }
+			free(set.keys);
+			return -1;
+		}
+		STATS_LAP(t, stage_parse);
+
+		reduce_keys(set.keys, set.len, &red->and_acc, &red->or_acc);
+		red->entries += set.len;
+		STATS_LAP(t, stage_derive);
+		STATS_ITEMS(set.len);
+
+		for (size_t i = 0; red->keep && i < set.len; i++) {
+			if (interval_set_add(&red->set, set.keys[i] >> 32, (uint32_t) set.keys[i]) == -1) {
+				free(set.keys);
+				return -1;
+			}
+		}
+
+		free(set.keys);
+		return 0;
+	}
+
+	buf = malloc(SUPERNET_CHUNK + 4);
+	if (!buf) { return -1; }
+
+	/* A partial address left from the last read starts the next one */
+	while ((got = fread(buf + keep, 1, SUPERNET_CHUNK, fp)) > 0) {
+		got += keep;
+		reduce_words(buf, got / 4, &and_raw, &or_raw);
+		red->entries += got / 4;
+		STATS_ITEMS(got / 4);
+
+		for (size_t i = 0; red->keep && i + 4 <= got; i += 4) {
+			addr = (uint32_t) buf[i] << 24 | (uint32_t) buf[i + 1] << 16 |
+				   (uint32_t) buf[i + 2] << 8 | buf[i + 3];
+			if (interval_set_add(&red->set, addr, addr) == -1) { goto handle_error; }
+		}
+
+		keep = got % 4;
+		memmove(buf, buf + got - keep, keep);
+	}
+	STATS_LAP(t, stage_derive);
+
+	if (ferror(fp)) {
+		fprintf(stderr, "ipc: %s\n", strerror(errno));
+		goto handle_error;
+	}
+	if (keep) {
+		fputs("ipc: trailing partial address\n", stderr);
+		goto handle_error;
+	}
+
+	/* Memory order to host order, once */
+	memcpy(bytes, &and_raw, 4);
+	red->and_acc &= (uint32_t) bytes[0] << 24 | (uint32_t) bytes[1] << 16 |
+					(uint32_t) bytes[2] << 8 | bytes[3];
+	memcpy(bytes, &or_raw, 4);
+	red->or_acc |= (uint32_t) bytes[0] << 24 | (uint32_t) bytes[1] << 16 |
+				   (uint32_t) bytes[2] << 8 | bytes[3];
+
+	free(buf);
+	return 0;
+
+	handle_error:
+		free(buf);
+		return -1;
+}
+
+static void reduce_words(const uint8_t *p, size_t n, uint32_t *and_acc, uint32_t *or_acc)
+{
+	lanes32_t va, vo, v;
+	uint32_t a = *and_acc;
+	uint32_t o = *or_acc;
+	uint32_t w;
+	size_t i = 0;
+
+	memset(&va, 0xFF, sizeof(va));
+	memset(&vo, 0, sizeof(vo));
+
+	for (; i + SUPERNET_LANES <= n; i += SUPERNET_LANES) {
+		memcpy(&v, p + i * 4, sizeof(v));
+		va &= v;
+		vo |= v;
+	}
+
+	for (int l = 0; l < SUPERNET_LANES; l++) {
+		a &= va[l];
+		o |= vo[l];
+	}
+
+	for (; i < n; i++) {
+		memcpy(&w, p + i * 4, 4);
+		a &= w;
+		o |= w;
+	}
+
+	*and_acc = a;
+	*or_acc = o;
+
+	return;
+}
+
+static void reduce_keys(const uint64_t *keys, size_t n, uint32_t *and_acc, uint32_t *or_acc)
+{
+	lanes64_t va, vo, v;
+	uint64_t a = UINT64_MAX;
+	uint64_t o = 0;
+	size_t i = 0;
+	const size_t lanes = sizeof(lanes64_t) / sizeof(uint64_t);
+
+	memset(&va, 0xFF, sizeof(va));
+	memset(&vo, 0, sizeof(vo));
+
+	for (; i + lanes <= n; i += lanes) {
+		memcpy(&v, keys + i, sizeof(v));
+		va &= v;
+		vo |= v;
+	}
+
+	for (size_t l = 0; l < lanes; l++) {
+		a &= va[l];
+		o |= vo[l];
+	}
+
+	for (; i < n; i++) {
+		a &= keys[i];
+		o |= keys[i];
+	}
+
+	/* First addresses in the high halves, last ones in the low */
+	*and_acc &= (uint32_t) (a >> 32) & (uint32_t) a;
+	*or_acc |= (uint32_t) (o >> 32) | (uint32_t) o;
+
+	return;
+}
+
+static int print_supernet(struct reduction *red)
+{
+	char cidr[ADDR_STR_LEN + 4];
+	char report[IPC_REPORT_MAX];
+	ipv4_t ip;
+	uint32_t diff = red->and_acc ^ red->or_acc;
+	uint64_t covered, requested;
+	uint8_t bitmask;
+	char *p = NULL;
+	int len;
+
+	/* Bits where the entries disagree are host bits */
+	bitmask = diff ? (uint8_t) __builtin_clz(diff) : BITS_IN_IP;
+	covered = prefix_size(bitmask);
+
+	p = format_addr_plain(cidr, red->and_acc & prefix_netmask(bitmask));
+	sprintf(p, "/%d", bitmask);
+
+	if (ipc_analyze(&ip, cidr) == -1) { return -1; }
+	len = ipc_format_analysis(&ip, report, sizeof(report));
+	if (len < 0) { return -1; }
+
+	printf("%-15s%s\n", "Supernet", cidr);
+	printf("%-15s%" PRIu64 "\n", "Entries", red->entries);
+	printf("%-15s%" PRIu64 "\n", "Covered", covered);
+
+	if (red->keep) {
+		if (interval_set_sort(&red->set) == -1) { return -1; }
+		requested = interval_set_merge(&red->set);
+
+		printf("%-15s%" PRIu64 "\n", "Requested", requested);
+		printf("%-15s%.2f (%.2f%% unused)\n", "Waste ratio", (double) covered / requested,
+			   100.0 * (double) (covered - requested) / covered);
+	}
+
+	putchar('\n');
+	fwrite(report, 1, len, stdout);
+
+	return 0;
+}
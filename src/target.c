@@ -0,0 +1,388 @@
+/* 
+ * This file is part of ipc.
+ * ipc - IP calculator.
+ *
+ * Copyright (C) 2026 Egorov Konstantin
+ *
+ * ipc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * ipc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ipc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "ipv4_t.h"
+#include "fill_ipv4.h"
+#include "format.h"
+#include "target.h"
+
+/**
+ * @brief Parse one octet of an expression into a membership map.
+ * @param str Octet text, ends at '.', '/' or '\0'.
+ * @param[out] member member[v] is set for every listed value.
+ * @return Pointer to the character after the octet, or NULL on error.
+ */
+static const char *parse_octet(const char *str, uint8_t *member);
+
+/**
+ * @brief Build values and runs of an octet with the mask applied.
+ * @param set Octet set to fill.
+ * @param member Membership map of the listed values.
+ * @param host_mask Host bits that fall into this octet.
+ */
+static void build_octet(struct octet_set *set, const uint8_t *member, uint8_t host_mask);
+
+/**
+ * @brief Read a decimal octet value.
+ * @param str Text.
+ * @param[out] val Value, at most 255.
+ * @return Pointer past the digits, or NULL on error.
+ */
+static const char *parse_value(const char *str, uint16_t *val);
+
+int target_parse(struct target_expr *expr, const char *str)
+{
+	uint8_t member[OCTET_VALUES];
+	ipv4_t ip;
+	const char *p = str;
+	int netbits;
+	uint8_t host_mask;
+
+	if (!expr || !str) { return -1; }
+
+	memset(expr, 0, sizeof(struct target_expr));
+	memset(&ip, 0, sizeof(ipv4_t));
+	expr->bitmask = BITS_IN_IP;
+
+	if (strchr(str, '/')) {
+		if (!fill_bitmask(&ip, str)) { return -1; }
+		expr->bitmask = ip.bitmask;
+	}
+
+	for (int i = 0; i < OCTET_COUNT; i++) {
+		memset(member, 0, sizeof(member));
+
+		p = parse_octet(p, member);
+		if (!p) { return -1; }
+
+		if (i < OCTET_COUNT - 1) {
+			if (*p != '.') { return -1; }
+			p++;
+		}
+		else if (*p != '\0' && *p != '/') { return -1; }
+
+		/* Bits of this octet that belong to the host part */
+		netbits = expr->bitmask - 8 * i;
+		if (netbits < 0) { netbits = 0; }
+		if (netbits > 8) { netbits = 8; }
+		host_mask = 0xFF >> netbits;
+		if (netbits == 0) { host_mask = 0xFF; }
+
+		build_octet(&expr->oct[i], member, host_mask);
+	}
+
+	expr->last_var = -1;
+	for (int i = OCTET_COUNT - 1; i >= 0; i--) {
+		if (expr->oct[i].covered != OCTET_VALUES) {
+			expr->last_var = i;
+			break;
+		}
+	}
+
+	return 0;
+}
+
+uint64_t target_count(const struct target_expr *expr)
+{
+	uint64_t count = 1;
+
+	if (!expr) { return 0; }
+
+	for (int i = 0; i < OCTET_COUNT; i++) { count *= expr->oct[i].covered; }
+
+	return count;
+}
+
+void target_iter_init(struct target_iter *it, const struct target_expr *expr)
+{
+	if (!it) { return; }
+
+	memset(it, 0, sizeof(struct target_iter));
+	it->expr = expr;
+	if (!expr) { it->done = 1; }
+
+	return;
+}
+
+int target_next_interval(struct target_iter *it, uint32_t *first, uint32_t *last)
+{
+	const struct target_expr *expr = NULL;
+	const struct octet_set *var = NULL;
+	uint32_t base = 0, low;
+	int l, shift;
+
+	if (!it || !first || !last) { return 0; }
+	if (it->done) { return 0; }
+
+	expr = it->expr;
+	l = expr->last_var;
+
+	if (l < 0) {
+		*first = 0;
+		*last = UINT32_MAX;
+		it->done = 1;
+		return 1;
+	}
+
+	/* Octets before last_var are single values, last_var gives a run */
+	for (int i = 0; i < l; i++) {
+		base |= (uint32_t) expr->oct[i].vals[it->pos[i]] << (24 - 8 * i);
+	}
+
+	var = &expr->oct[l];
+	shift = 24 - 8 * l;
+	low = shift ? ((uint32_t) 1 << shift) - 1 : 0;
+
+	*first = base | (uint32_t) var->run_first[it->pos[l]] << shift;
+	*last = base | (uint32_t) var->run_last[it->pos[l]] << shift | low;
+
+	/* Advance the odometer */
+	if (++it->pos[l] < var->run_cnt) { return 1; }
+	it->pos[l] = 0;
+
+	for (int i = l - 1; i >= 0; i--) {
+		if (++it->pos[i] < expr->oct[i].len) { return 1; }
+		it->pos[i] = 0;
+	}
+
+	it->done = 1;
+	return 1;
+}
+
+int target_next_addr(struct target_iter *it, uint32_t *addr)
+{
+	uint32_t first, last;
+
+	if (!it || !addr) { return 0; }
+
+	if (!it->have_cur) {
+		if (!target_next_interval(it, &first, &last)) { return 0; }
+		it->cur = first;
+		it->end = last;
+		it->have_cur = 1;
+	}
+
+	*addr = (uint32_t) it->cur++;
+	if (it->cur > it->end) { it->have_cur = 0; }
+
+	return 1;
+}
+
+int target_next_cidr(struct target_iter *it, struct prefix *pfx)
+{
+	uint32_t first, last;
+	uint64_t size, span;
+	int bits;
+
+	if (!it || !pfx) { return 0; }
+
+	if (!it->have_cur) {
+		if (it->have_next) {
+			it->cur = it->next_first;
+			it->end = it->next_last;
+			it->have_next = 0;
+		}
+		else if (target_next_interval(it, &first, &last)) {
+			it->cur = first;
+			it->end = last;
+		}
+		else { return 0; }
+
+		/* Join adjacent intervals into one run */
+		while (target_next_interval(it, &first, &last)) {
+			if (first != it->end + 1) {
+				it->next_first = first;
+				it->next_last = last;
+				it->have_next = 1;
+				break;
+			}
+			it->end = last;
+		}
+		it->have_cur = 1;
+	}
+
+	/* Largest aligned block at cur that fits in the run */
+	span = it->end - it->cur + 1;
+	bits = it->cur ? __builtin_ctzll(it->cur) : BITS_IN_IP;
+	if (bits > BITS_IN_IP) { bits = BITS_IN_IP; }
+	while (((uint64_t) 1 << bits) > span) { bits--; }
+	size = (uint64_t) 1 << bits;
+
+	pfx->addr = (uint32_t) it->cur;
+	pfx->bitmask = BITS_IN_IP - bits;
+
+	it->cur += size;
+	if (it->cur > it->end) { it->have_cur = 0; }
+
+	return 1;
+}
+
+int target_start(int argc, char **argv)
+{
+	struct target_expr expr;
+	struct target_iter it;
+	struct prefix pfx;
+	struct outbuf *ob = NULL;
+	uint8_t as_cidr = 0, count_only = 0;
+	int expr_cnt = 0;
+	uint32_t addr;
+	char *dst = NULL;
+	int res;
+
+	if (argc < 1 || !argv) { return EXIT_FAILURE; }
+
+	for (int i = 0; i < argc; i++) {
+		if (strcmp(argv[i], "--cidr") == 0) { as_cidr = 1; }
+		else if (strcmp(argv[i], "--count") == 0) { count_only = 1; }
+		else if (strncmp(argv[i], "--", 2) == 0) { return EXIT_FAILURE; }
+		else { expr_cnt++; }
+	}
+	if (!expr_cnt) { return EXIT_FAILURE; }
+
+	ob = malloc(sizeof(struct outbuf));
+	if (!ob) { return EXIT_FAILURE; }
+	outbuf_init(ob, stdout);
+
+	for (int i = 0; i < argc && !ob->error; i++) {
+		if (strncmp(argv[i], "--", 2) == 0) { continue; }
+
+		if (target_parse(&expr, argv[i]) == -1) {
+			fprintf(stderr, "ipc: invalid target '%s'\n", argv[i]);
+			outbuf_flush(ob);
+			free(ob);
+			return EXIT_FAILURE;
+		}
+
+		if (count_only) {
+			dst = outbuf_reserve(ob, 32);
+			ob->len += sprintf(dst, "%" PRIu64 "\n", target_count(&expr));
+			continue;
+		}
+
+		target_iter_init(&it, &expr);
+
+		if (as_cidr) {
+			while (!ob->error && target_next_cidr(&it, &pfx)) {
+				dst = outbuf_reserve(ob, ADDR_STR_LEN + 5);
+				dst = format_addr_plain(dst, pfx.addr);
+				ob->len = dst - ob->data;
+				ob->len += sprintf(dst, "/%d\n", pfx.bitmask);
+			}
+		}
+		else {
+			while (!ob->error && target_next_addr(&it, &addr)) {
+				dst = outbuf_reserve(ob, ADDR_STR_LEN + 1);
+				dst = format_addr_plain(dst, addr);
+				*dst++ = '\n';
+				ob->len = dst - ob->data;
+			}
+		}
+	}
+
+	res = outbuf_flush(ob);
+	free(ob);
+
+	return res == -1 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+static const char *parse_octet(const char *str, uint8_t *member)
+{
+	uint16_t lo, hi;
+
+	for (;;) {
+		if (*str == '*') {
+			memset(member, 1, OCTET_VALUES);
+			str++;
+		}
+		else {
+			str = parse_value(str, &lo);
+			if (!str) { return NULL; }
+			hi = lo;
+
+			if (*str == '-') {
+				str = parse_value(str + 1, &hi);
+				if (!str || hi < lo) { return NULL; }
+			}
+
+			for (uint16_t v = lo; v <= hi; v++) { member[v] = 1; }
+		}
+
+		if (*str != ',') { return str; }
+		str++;
+	}
+}
+
+static const char *parse_value(const char *str, uint16_t *val)
+{
+	uint32_t num = 0;
+	uint8_t exists_num = 0;
+
+	/* Same rules as fill_addr: digits only, at most 255 */
+	while (*str >= '0' && *str <= '9') {
+		num = num * 10 + (*str - '0');
+		if (num > 255) { return NULL; }
+		exists_num = 1;
+		str++;
+	}
+
+	if (!exists_num) { return NULL; }
+
+	*val = (uint16_t) num;
+	return str;
+}
+
+static void build_octet(struct octet_set *set, const uint8_t *member, uint8_t host_mask)
+{
+	uint8_t seen[OCTET_VALUES];
+	uint16_t v, first, last;
+
+	memset(set, 0, sizeof(struct octet_set));
+	memset(seen, 0, sizeof(seen));
+
+	/* Values are taken with the host bits cleared */
+	for (v = 0; v < OCTET_VALUES; v++) {
+		if (member[v]) { seen[v & (uint8_t) ~host_mask] = 1; }
+	}
+
+	for (v = 0; v < OCTET_VALUES; v++) {
+		if (!seen[v]) { continue; }
+
+		set->vals[set->len++] = (uint8_t) v;
+		first = v;
+		last = v | host_mask;
+
+		if (set->run_cnt && first == set->run_last[set->run_cnt - 1] + 1) {
+			set->run_last[set->run_cnt - 1] = (uint8_t) last;
+		}
+		else {
+			set->run_first[set->run_cnt] = (uint8_t) first;
+			set->run_last[set->run_cnt] = (uint8_t) last;
+			set->run_cnt++;
+		}
+		set->covered += last - first + 1;
+	}
+
+	return;
+}